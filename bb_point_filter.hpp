@@ -3,20 +3,26 @@
 
 #include "poly_line.hpp"
 #include "point.hpp"
+#include "geometry_kernels.hpp"
 
 #include <algorithm>
+#include <limits>
 
 /// Filters the given point sets to only points contained in the axis-aligned bounding
 /// box of the given line.
-class bb_point_filter
+template<typename CoordinateT>
+class basic_bb_point_filter
 {
 public:
+    using coordinate_type = CoordinateT;
+
     template<typename ForwardIter>
-    bb_point_filter(ForwardIter begin, ForwardIter end, unsigned id)
+    basic_bb_point_filter(ForwardIter begin, ForwardIter end, unsigned id)
     : id(id)
     {
-        min = coordinate {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
-        max = coordinate {-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()};
+        using value_type = typename coordinate_traits<CoordinateT>::value_type;
+        min = CoordinateT {std::numeric_limits<value_type>::max(), std::numeric_limits<value_type>::max()};
+        max = CoordinateT {std::numeric_limits<value_type>::lowest(), std::numeric_limits<value_type>::lowest()};
 
         for (auto iter = begin; iter != end; ++iter)
         {
@@ -28,27 +34,52 @@ public:
 
     }
 
-    std::vector<point> operator()(const std::vector<point>& points)
+    std::vector<basic_point<CoordinateT>> operator()(const std::vector<basic_point<CoordinateT>>& points)
     {
-        std::vector<point> filtered_points;
+        std::vector<basic_point<CoordinateT>> filtered_points;
+
+        // test the points in chunks against the bounding box
+        geometry_kernels::coordinate_array<CoordinateT> chunk;
+        chunk.x.resize(CHUNK_SIZE);
+        chunk.y.resize(CHUNK_SIZE);
+        unsigned char inside[CHUNK_SIZE];
+
+        for (std::size_t chunk_begin = 0; chunk_begin < points.size(); chunk_begin += CHUNK_SIZE)
+        {
+            auto chunk_size = std::min<std::size_t>(CHUNK_SIZE, points.size() - chunk_begin);
+            for (auto k = 0u; k < chunk_size; ++k)
+            {
+                chunk.x[k] = points[chunk_begin + k].location.x;
+                chunk.y[k] = points[chunk_begin + k].location.y;
+            }
+
+            geometry_kernels::bounding_box_mask(min, max, chunk.x.data(), chunk.y.data(), chunk_size, inside);
 
-        std::copy_if(points.begin(), points.end(), std::back_inserter(filtered_points),
-                     [this](const point& p) { return p.line_id != id && in_bounding_box(p.location); });
+            for (auto k = 0u; k < chunk_size; ++k)
+            {
+                const auto& p = points[chunk_begin + k];
+                if (inside[k] && p.line_id != id)
+                {
+                    filtered_points.push_back(p);
+                }
+            }
+        }
 
         return filtered_points;
     }
 
 private:
-
-    bool in_bounding_box(const coordinate& coord)
-    {
-        return coord.x > min.x && coord.y > min.y &&
-               coord.x < max.x && coord.y < max.y;
-    }
+    static constexpr std::size_t CHUNK_SIZE = 256;
 
     unsigned id;
-    coordinate min;
-    coordinate max;
+    CoordinateT min;
+    CoordinateT max;
 
 };
+
+template<typename CoordinateT>
+constexpr std::size_t basic_bb_point_filter<CoordinateT>::CHUNK_SIZE;
+
+using bb_point_filter = basic_bb_point_filter<coordinate>;
+
 #endif
@@ -0,0 +1,146 @@
+#ifndef CHUNKED_SIMPLIFICATION_HPP
+#define CHUNKED_SIMPLIFICATION_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "shortcut.hpp"
+#include "simplification_options.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/// Simplifies long lines by running SimplificationT on overlapping chunks of the line.
+///
+/// Every chunk is simplified against the given points and all vertices of the line
+/// outside of the chunk, so each shortcut of a chunk is also valid for the whole line.
+/// The shortcuts of all chunks are merged and the shortest path picks the vertices
+/// where it switches between chunks inside the overlaps.
+/// Compared to SimplificationT only shortcuts that do not fit into any chunk are lost.
+template<typename SimplificationT>
+class chunked_simplification
+{
+public:
+    using coordinate_type = typename SimplificationT::coordinate_type;
+    using line_type = basic_poly_line<coordinate_type>;
+    using point_type = basic_point<coordinate_type>;
+    using point_filter_type = typename SimplificationT::point_filter_type;
+
+    chunked_simplification(const line_type& in_line, std::vector<point_type>&& in_points,
+                           const simplification_options& in_options = simplification_options())
+    : line(in_line)
+    , points(in_points)
+    , options(in_options)
+    {
+        if (options.chunk_size < options.chunk_overlap + 2)
+        {
+            throw std::runtime_error("The chunk size needs to be at least the overlap plus two.");
+        }
+    }
+
+    std::vector<shortcut> operator()() const
+    {
+        auto chunks = get_chunks();
+        if (chunks.size() == 1)
+        {
+            auto points_copy = points;
+            SimplificationT simplification(line, std::move(points_copy), options);
+            return simplification();
+        }
+
+        std::vector<point_type> line_vertices;
+        line_vertices.reserve(line.coordinates.size());
+        for (auto idx = 0u; idx < line.coordinates.size(); ++idx)
+        {
+            line_vertices.push_back({point_type::NO_LINE_ID, idx, line.coordinates[idx]});
+        }
+
+        std::vector<std::vector<shortcut>> chunk_shortcuts(chunks.size());
+        util::parallel_for(options.num_threads, chunks.size(),
+            [this, &chunks, &chunk_shortcuts, &line_vertices](std::size_t k)
+            {
+                chunk_shortcuts[k] = simplify_chunk(chunks[k].first, chunks[k].second, line_vertices);
+            });
+
+        std::vector<shortcut> shortcuts;
+        for (const auto& c : chunk_shortcuts)
+        {
+            shortcuts.insert(shortcuts.end(), c.begin(), c.end());
+        }
+
+        // shortcuts inside of the overlaps are found twice
+        std::sort(shortcuts.begin(), shortcuts.end(),
+                  [](const shortcut& lhs, const shortcut& rhs)
+                  {
+                      return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.last < rhs.last);
+                  });
+        shortcuts.erase(std::unique(shortcuts.begin(), shortcuts.end(),
+                                    [](const shortcut& lhs, const shortcut& rhs)
+                                    {
+                                        return lhs.first == rhs.first && lhs.last == rhs.last;
+                                    }),
+                        shortcuts.end());
+
+        return shortcuts;
+    }
+
+private:
+    /// Returns the first and last vertex of every chunk
+    std::vector<std::pair<unsigned, unsigned>> get_chunks() const
+    {
+        std::vector<std::pair<unsigned, unsigned>> chunks;
+
+        unsigned last_idx = line.coordinates.size() - 1;
+        unsigned first = 0;
+        while (true)
+        {
+            unsigned last = std::min(first + options.chunk_size - 1, last_idx);
+            chunks.emplace_back(first, last);
+            if (last == last_idx)
+            {
+                break;
+            }
+            first = last - options.chunk_overlap;
+        }
+
+        return chunks;
+    }
+
+    /// The vertices of the line outside of the chunk constrain it like any other point
+    std::vector<shortcut> simplify_chunk(unsigned first, unsigned last, const std::vector<point_type>& line_vertices) const
+    {
+        line_type chunk_line {line.id, std::vector<coordinate_type>(line.coordinates.begin() + first,
+                                                                    line.coordinates.begin() + last + 1)};
+
+        point_filter_type filter(chunk_line.coordinates.begin(), chunk_line.coordinates.end(), line.id);
+        auto chunk_points = filter(points);
+        for (const auto& p : filter(line_vertices))
+        {
+            if (p.id < first || p.id > last)
+            {
+                chunk_points.push_back(p);
+            }
+        }
+
+        SimplificationT simplification(chunk_line, std::move(chunk_points), options);
+        auto shortcuts = simplification();
+        for (auto& s : shortcuts)
+        {
+            s.first += first;
+            s.last += first;
+            if (s.split_edge != NO_EDGE_ID)
+            {
+                s.split_edge += first;
+            }
+        }
+
+        return shortcuts;
+    }
+
+    const line_type& line;
+    std::vector<point_type> points;
+    simplification_options options;
+};
+
+#endif
@@ -5,24 +5,41 @@
 #include "point_distributor.hpp"
 #include "shortcut_acceptor.hpp"
 #include "monotone_decomposition.hpp"
+#include "simplification_options.hpp"
+#include "deviation_cone.hpp"
+#include "funnel_sweep.hpp"
 
 #include <iostream>
+#include <queue>
 
 template<typename PointFilterT>
 class deberg
 {
 public:
-    deberg(const poly_line& in_line, std::vector<point>&& in_points)
+    using coordinate_type = typename PointFilterT::coordinate_type;
+    using line_type = basic_poly_line<coordinate_type>;
+    using point_type = basic_point<coordinate_type>;
+    using decomposition_type = basic_monotone_decomposition<coordinate_type>;
+    using point_filter_type = PointFilterT;
+
+    deberg(const line_type& in_line, std::vector<point_type>&& in_points,
+           const simplification_options& options = simplification_options())
     : line(in_line)
     , points(in_points)
+    , window(options.window)
+    , max_deviation(options.max_deviation)
+    , work_budget(options.work_budget)
+    , goal_directed(options.goal_directed)
+    , use_funnel_sweep(options.use_funnel_sweep)
     {
     }
 
     std::vector<shortcut> operator()() const
     {
         std::vector<shortcut> shortcuts;
+        std::size_t work = 0;
 
-        monotone_decomposition decomposition;
+        decomposition_type decomposition;
         auto monotone_lines = decomposition(line);
         auto line_points = get_line_points(monotone_lines, line.coordinates);
 
@@ -35,7 +52,7 @@ public:
             filtered_points.insert(filtered_points.end(), points.begin(), points.end());
 
             auto transformed_points = transform_points(m.mono, filtered_points);
-            auto monotone_shortcuts = simplify_monotone_line(m.line, transformed_points);
+            auto monotone_shortcuts = simplify_monotone_line(m.line, transformed_points, work);
 
             // fix up indices
             for (auto& s : monotone_shortcuts)
@@ -54,9 +71,9 @@ public:
     }
 
 private:
-    std::vector<point> get_line_points(const std::vector<monotone_decomposition::monotone_subpath>& lines, const std::vector<coordinate>& coordinates) const
+    std::vector<point_type> get_line_points(const std::vector<typename decomposition_type::monotone_subpath>& lines, const std::vector<coordinate_type>& coordinates) const
     {
-        std::vector<point> line_points;
+        std::vector<point_type> line_points;
 
         auto line_idx = 0u;
         for (auto i = 0u; i < coordinates.size(); ++i)
@@ -73,45 +90,167 @@ private:
         return line_points;
     }
 
-    std::vector<point> transform_points(geometry::monoticity mono, const std::vector<point>& points) const
+    std::vector<point_type> transform_points(geometry::monoticity mono, const std::vector<point_type>& points) const
     {
-        std::vector<point> transformed_points;
+        std::vector<point_type> transformed_points;
         transformed_points.reserve(points.size());
         // FIXME this is unecessary copying, we can do this nicer
-        std::vector<coordinate> temp_coordinates(points.size());
-        std::transform(points.begin(), points.end(), temp_coordinates.begin(), [](const point& p) { return p.location; });
+        std::vector<coordinate_type> temp_coordinates(points.size());
+        std::transform(points.begin(), points.end(), temp_coordinates.begin(), [](const point_type& p) { return p.location; });
         geometry::make_x_monotone_increasing(mono, temp_coordinates);
 
         for (auto i = 0u; i < points.size(); ++i)
         {
-            transformed_points.push_back(point {points[i].line_id, points[i].id, temp_coordinates[i]});
+            transformed_points.push_back(point_type {points[i].line_id, points[i].id, temp_coordinates[i]});
         }
 
         return transformed_points;
     }
 
-    std::vector<shortcut> simplify_monotone_line(const poly_line& l, const std::vector<point>& points) const
+    /// Returns the end of the candidates of vertex i, adds their number to work and throws if it exceeds the budget
+    unsigned fan_end(const line_type& l, basic_deviation_cone<coordinate_type>& cone, unsigned i, std::size_t& work) const
     {
-        tangent_splitter splitter(l);
-        point_distributor distributor(l, points);
-        shortcut_acceptor acceptor(l);
+        // vertices outside of the error cone are never sorted or swept, the cone itself stops at the window
+        auto window_end = window.end(l, i);
+        auto end = std::min(window_end, cone.end(i, window_end));
+        work += end - i;
+        if (work_budget > 0 && work > work_budget)
+        {
+            throw work_budget_exceeded();
+        }
+
+        return end;
+    }
 
+    /// Computes the fans of all vertices, or only those of the vertices a breadth first search
+    /// from the first vertex pops before it reaches the last vertex.
+    ///
+    /// Every shortcut ends inside the subpath, so the search can stop at its last vertex.
+    /// The goal directed search returns one shortest path and all edges of the line, so the
+    /// result stays connected if it is merged with others (e.g. by chunked_simplification).
+    /// All other shortcuts of the popped fans are dropped, see simplification_options::goal_directed.
+    template<typename FanT>
+    std::vector<shortcut> collect_fans(unsigned size, FanT fan) const
+    {
         std::vector<shortcut> all_shortcuts;
 
-        // note: no edges after last coordinate
-        for (auto i = 0u; i < l.coordinates.size() - 1; ++i)
+        if (!goal_directed)
+        {
+            // note: no edges after last coordinate
+            for (auto i = 0u; i < size - 1; ++i)
+            {
+                auto partial_shortcuts = fan(i);
+                all_shortcuts.insert(all_shortcuts.end(), partial_shortcuts.begin(), partial_shortcuts.end());
+            }
+
+            return all_shortcuts;
+        }
+
+        std::vector<unsigned> parents(size, NO_EDGE_ID);
+        std::queue<unsigned> queue;
+        parents[0] = 0;
+        queue.push(0);
+        while (!queue.empty() && parents[size - 1] == NO_EDGE_ID)
+        {
+            auto i = queue.front();
+            queue.pop();
+            for (const auto& s : fan(i))
+            {
+                if (parents[s.last] == NO_EDGE_ID)
+                {
+                    parents[s.last] = i;
+                    queue.push(s.last);
+                }
+            }
+        }
+        BOOST_ASSERT(parents[size - 1] != NO_EDGE_ID);
+
+        std::vector<unsigned> path_next(size, NO_EDGE_ID);
+        for (auto j = size - 1; j != 0; j = parents[j])
         {
-            auto tangents = splitter(i);
-            auto assignments = distributor(i, tangents);
-            auto partial_shortcuts = acceptor(i, tangents, assignments);
-            all_shortcuts.insert(all_shortcuts.end(), partial_shortcuts.begin(), partial_shortcuts.end());
+            path_next[parents[j]] = j;
+        }
+
+        for (auto i = 0u; i < size - 1; ++i)
+        {
+            all_shortcuts.emplace_back(i, i + 1);
+            if (path_next[i] != NO_EDGE_ID && path_next[i] != i + 1)
+            {
+                all_shortcuts.emplace_back(i, path_next[i]);
+            }
         }
 
         return all_shortcuts;
     }
 
-    const poly_line& line;
-    std::vector<point> points;
+    std::vector<shortcut> simplify_monotone_line(const line_type& l, const std::vector<point_type>& points, std::size_t& work) const
+    {
+        basic_tangent_splitter<coordinate_type> splitter(l);
+        basic_deviation_cone<coordinate_type> cone(l, max_deviation);
+
+        if (use_funnel_sweep)
+        {
+            basic_funnel_sweep<coordinate_type> funnel(l, points);
+            return collect_fans(l.coordinates.size(), [&](unsigned i)
+            {
+                auto partial_shortcuts = funnel(i, fan_end(l, cone, i, work));
+                if (cone.is_bounded())
+                {
+                    partial_shortcuts.erase(std::remove_if(partial_shortcuts.begin(), partial_shortcuts.end(),
+                                                           [&cone](const shortcut& s) { return !cone.admissible(s.first, s.last); }),
+                                            partial_shortcuts.end());
+                }
+                return partial_shortcuts;
+            });
+        }
+
+        // Without points the only constraints come from the subpath itself, so the acceptor keeps
+        // every shortcut up to the last tangent. Gives the same shortcuts as the full sweep.
+        if (points.empty())
+        {
+            return collect_fans(l.coordinates.size(), [&](unsigned i)
+            {
+                auto end = fan_end(l, cone, i, work);
+                auto last = splitter.last_tangent(i, end);
+
+                std::vector<shortcut> partial_shortcuts;
+                for (auto j = i + 1; j <= last; ++j)
+                {
+                    if (cone.admissible(i, j))
+                    {
+                        partial_shortcuts.emplace_back(i, j);
+                    }
+                }
+                return partial_shortcuts;
+            });
+        }
+
+        basic_point_distributor<coordinate_type> distributor(l, points);
+        basic_shortcut_acceptor<coordinate_type> acceptor(l);
+
+        return collect_fans(l.coordinates.size(), [&](unsigned i)
+        {
+            auto end = fan_end(l, cone, i, work);
+            auto tangents = splitter(i, end);
+            auto assignments = distributor(i, tangents, end);
+            auto partial_shortcuts = acceptor(i, tangents, assignments, end);
+            if (cone.is_bounded())
+            {
+                partial_shortcuts.erase(std::remove_if(partial_shortcuts.begin(), partial_shortcuts.end(),
+                                                       [&cone](const shortcut& s) { return !cone.admissible(s.first, s.last); }),
+                                        partial_shortcuts.end());
+            }
+            return partial_shortcuts;
+        });
+    }
+
+    const line_type& line;
+    std::vector<point_type> points;
+    simplification_window window;
+    double max_deviation;
+    std::size_t work_budget;
+    bool goal_directed;
+    bool use_funnel_sweep;
 };
 
 #endif
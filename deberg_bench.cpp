@@ -0,0 +1,131 @@
+#include "deberg.hpp"
+
+#include "line_reader.hpp"
+#include "point_reader.hpp"
+#include "bb_point_filter.hpp"
+#include "map_simplification.hpp"
+#include "local_frame_simplification.hpp"
+#include "geometry_kernels.hpp"
+
+#include "timing_util.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+/// Compares the double precision pipeline with the single precision local frame pipeline
+/// and the funnel sweep with the tangent splitter, distributor and acceptor.
+///
+/// Usage: ./deberg_bench REPETITIONS LINE_FILE_PATH POINT_FILE_PATH [LINE_FILE_PATH POINT_FILE_PATH ...]
+
+/// Number of pairs of edges of the simplified lines that cross properly.
+/// The edges are swept by their left end, so only edges that overlap in x are compared.
+unsigned count_crossings(const std::vector<poly_line>& lines)
+{
+    std::vector<std::pair<coordinate, coordinate>> edges;
+    for (const auto& l : lines)
+    {
+        for (auto k = 0u; k + 1 < l.coordinates.size(); ++k)
+        {
+            auto first = l.coordinates[k];
+            auto second = l.coordinates[k + 1];
+            if (second.x < first.x)
+            {
+                std::swap(first, second);
+            }
+            edges.emplace_back(first, second);
+        }
+    }
+    std::sort(edges.begin(), edges.end(),
+              [](const std::pair<coordinate, coordinate>& lhs, const std::pair<coordinate, coordinate>& rhs)
+              {
+                  return lhs.first.x < rhs.first.x;
+              });
+
+    auto sign = [](double o) { return o > 0 ? 1 : (o < 0 ? -1 : 0); };
+    unsigned num_crossings = 0;
+    for (auto i = 0u; i < edges.size(); ++i)
+    {
+        const auto& a = edges[i];
+        for (auto j = i + 1; j < edges.size() && edges[j].first.x <= a.second.x; ++j)
+        {
+            const auto& b = edges[j];
+            if (sign(geometry::orientation(a.first, a.second, b.first)) * sign(geometry::orientation(a.first, a.second, b.second)) < 0
+                && sign(geometry::orientation(b.first, b.second, a.first)) * sign(geometry::orientation(b.first, b.second, a.second)) < 0)
+            {
+                ++num_crossings;
+            }
+        }
+    }
+    return num_crossings;
+}
+
+template<typename SimplificationT>
+void run_benchmark(const std::string& name, unsigned repetitions,
+                   const std::vector<poly_line>& lines, const std::vector<point>& points,
+                   const simplification_options& options = simplification_options())
+{
+    double total_msec = 0;
+    unsigned num_edges = 0;
+    unsigned num_crossings = 0;
+    for (auto r = 0u; r < repetitions; ++r)
+    {
+        auto lines_copy = lines;
+        auto points_copy = points;
+
+        TIMER_START(simplification);
+        map_simplification<SimplificationT, bb_point_filter> simplification(std::move(lines_copy), std::move(points_copy));
+        simplification.set_options(options);
+        auto simplified = simplification(std::numeric_limits<unsigned>::max());
+        TIMER_STOP(simplification);
+        total_msec += TIMER_MSEC(simplification);
+
+        num_edges = 0;
+        for (const auto& l : simplified)
+        {
+            num_edges += l.coordinates.size() - 1;
+        }
+        num_crossings = count_crossings(simplified);
+    }
+
+    std::cout << std::setw(10) << name << ": " << std::setw(10) << (total_msec / repetitions) << " msec "
+              << std::setw(8) << num_edges << " edges " << std::setw(6) << num_crossings << " crossings" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4 || (argc - 2) % 2 != 0)
+    {
+        std::cout << "./deberg_bench REPETITIONS LINE_FILE_PATH POINT_FILE_PATH [LINE_FILE_PATH POINT_FILE_PATH ...]" << std::endl;
+        return 1;
+    }
+
+    unsigned repetitions = 1;
+    std::stringstream param_buffer(argv[1]);
+    param_buffer >> repetitions;
+    repetitions = std::max(repetitions, 1u);
+
+    std::cout << "geometry kernels: " << (geometry_kernels::uses_avx2() ? "avx2" : "scalar") << std::endl;
+
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        std::ifstream line_input(argv[i]);
+        std::ifstream point_input(argv[i+1]);
+        auto lines = line_reader(line_input).read();
+        auto points = point_reader(point_input).read();
+
+        std::cout << argv[i] << " (" << lines.size() << " lines, " << points.size() << " points)" << std::endl;
+
+        using local_filter = basic_bb_point_filter<local_coordinate>;
+        run_benchmark<deberg<bb_point_filter>>("float64", repetitions, lines, points);
+        run_benchmark<local_frame_simplification<deberg<local_filter>>>("float32", repetitions, lines, points);
+
+        simplification_options funnel_options;
+        funnel_options.use_funnel_sweep = true;
+        run_benchmark<deberg<bb_point_filter>>("funnel", repetitions, lines, points, funnel_options);
+    }
+
+    return 0;
+}
@@ -3,37 +3,650 @@
 #include "deberg_options.hpp"
 #include "line_reader.hpp"
 #include "line_writer.hpp"
+#include "wkb_reader.hpp"
+#include "wkb_writer.hpp"
+#include "geojson_writer.hpp"
 #include "point_reader.hpp"
 #include "bb_point_filter.hpp"
 #include "map_simplification.hpp"
+#include "local_frame_simplification.hpp"
+#include "quantizer.hpp"
+#include "simplification_options.hpp"
+#include "chunked_simplification.hpp"
+#include "douglas_peucker.hpp"
+#include "shortcut_graph_file.hpp"
+#include "graph_util.hpp"
+#include "vertex_index_file.hpp"
+#include "preprocessing_snapshot.hpp"
+#include "simplification_server.hpp"
 
 #include "timing_util.hpp"
 
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
 
-void write_lines(const std::string& line_file_path, const std::vector<poly_line>& lines)
+/// Writes the lines in the output format of the options. Quantized lines take their quantizer
+/// as last argument, which is passed on to the writer.
+template<typename CoordinateT, typename... QuantizerT>
+void write_lines(const std::string& line_file_path, const std::vector<basic_poly_line<CoordinateT>>& lines,
+                 const deberg_options& options, const QuantizerT&... quantizer)
 {
-    std::ofstream line_output(line_file_path);
-    line_writer writer(line_output);
-    writer.write(lines);
+    std::ofstream line_output(line_file_path, std::ios::binary);
+    if (options.output_format == "wkb")
+    {
+        wkb_writer writer(line_output);
+        writer.write(lines, quantizer...);
+    }
+    else if (options.output_format == "geojson")
+    {
+        geojson_writer writer(line_output);
+        writer.write(lines, quantizer...);
+    }
+    else
+    {
+        line_writer writer(line_output);
+        writer.write(lines, quantizer...);
+    }
 }
 
-std::vector<poly_line> read_lines(const std::string& line_file_path)
+/// Returns a function that writes a single line to output in the output format of the options
+std::function<void(const poly_line&)> get_line_writer(std::ostream& output, const deberg_options& options)
 {
-    std::ifstream line_input(line_file_path);
+    if (options.output_format == "wkb")
+    {
+        auto writer = std::make_shared<wkb_writer>(output);
+        return [writer](const poly_line& line) { writer->write_line(line); };
+    }
+    else if (options.output_format == "geojson")
+    {
+        // the collection is closed once the last copy of the function is gone
+        auto writer = std::make_shared<geojson_writer>(output);
+        return [writer](const poly_line& line) { writer->write_line(line); };
+    }
+
+    auto writer = std::make_shared<line_writer>(output);
+    return [writer](const poly_line& line) { writer->write_line(line); };
+}
+
+std::vector<poly_line> read_lines(const std::string& line_file_path, const deberg_options& options)
+{
+    std::ifstream line_input(line_file_path, std::ios::binary);
+    if (options.input_format == "wkb")
+    {
+        wkb_reader reader(line_input);
+        return reader.read_lines();
+    }
+
     line_reader reader(line_input);
     return reader.read();
 }
 
-std::vector<point> read_points(const std::string& point_file_path)
+std::vector<point> read_points(const std::string& point_file_path, const deberg_options& options)
 {
-    std::ifstream point_input(point_file_path);
+    std::ifstream point_input(point_file_path, std::ios::binary);
+    if (options.input_format == "wkb")
+    {
+        wkb_reader reader(point_input);
+        return reader.read_points();
+    }
+
     point_reader reader(point_input);
     return reader.read();
 }
 
+template<typename CoordinateT>
+std::vector<CoordinateT> point_locations(const std::vector<basic_point<CoordinateT>>& points)
+{
+    std::vector<CoordinateT> locations;
+    locations.reserve(points.size());
+    for (const auto& p : points)
+    {
+        locations.push_back(p.location);
+    }
+    return locations;
+}
+
+simplification_options get_simplification_options(const deberg_options& options)
+{
+    simplification_options engine_options(simplification_window(options.window_vertices, options.window_length));
+    engine_options.max_deviation = options.max_deviation;
+    engine_options.target_edges = options.target_edges;
+    engine_options.goal_directed = options.goal_directed;
+    engine_options.use_funnel_sweep = options.use_funnel_sweep;
+    engine_options.work_budget = options.work_budget;
+    engine_options.fallback_window = options.fallback_window;
+    engine_options.chunk_size = options.chunk_size;
+    engine_options.chunk_overlap = options.chunk_overlap;
+    engine_options.num_threads = options.num_threads;
+    return engine_options;
+}
+
+/// Levels of detail from the options, deviations are divided by scale
+std::vector<detail_level> get_detail_levels(const deberg_options& options, double scale)
+{
+    std::vector<detail_level> levels;
+    for (auto deviation : options.level_deviations)
+    {
+        detail_level level;
+        level.max_deviation = deviation / scale;
+        levels.push_back(level);
+    }
+    for (auto edges : options.level_edges)
+    {
+        detail_level level;
+        level.max_edges = edges;
+        levels.push_back(level);
+    }
+    return levels;
+}
+
+/// Output file of a level, the level is inserted before the extension if there are several
+std::string get_output_file_path(const deberg_options& options, std::size_t level)
+{
+    const auto& file_path = options.output_file_path;
+    if (options.level_deviations.empty() && options.level_edges.empty())
+    {
+        return file_path;
+    }
+
+    auto extension = file_path.find_last_of('.');
+    auto directory = file_path.find_last_of('/');
+    if (extension == std::string::npos || (directory != std::string::npos && extension < directory))
+    {
+        extension = file_path.size();
+    }
+    return file_path.substr(0, extension) + "." + std::to_string(level) + file_path.substr(extension);
+}
+
+/// Called with every simplified line and the indices of its vertices in the input line if the output is streamed
+template<typename CoordinateT>
+using line_output = std::function<void(const basic_poly_line<CoordinateT>&, const std::vector<unsigned>&)>;
+
+/// Opens the output file and returns the callback that writes every streamed line to it,
+/// nothing if the output is not streamed. to_output converts a line to input coordinates.
+template<typename CoordinateT>
+line_output<CoordinateT> get_stream_output(std::ofstream& output, const deberg_options& options,
+                                           const std::function<poly_line(const basic_poly_line<CoordinateT>&)>& to_output)
+{
+    if (!options.stream)
+    {
+        return line_output<CoordinateT>();
+    }
+
+    if (options.write_indices)
+    {
+        output.open(options.output_file_path, std::ios::binary);
+        auto writer = std::make_shared<vertex_index_writer>(output);
+        return [writer, &output](const basic_poly_line<CoordinateT>& line, const std::vector<unsigned>& original_indices)
+        {
+            writer->write_line(line.id, original_indices);
+            output.flush();
+        };
+    }
+
+    output.open(options.output_file_path, std::ios::binary);
+    auto write_line = get_line_writer(output, options);
+    return [write_line, to_output, &output](const basic_poly_line<CoordinateT>& line, const std::vector<unsigned>&)
+    {
+        write_line(to_output(line));
+        output.flush();
+    };
+}
+
+/// Returns the simplified lines of every level, or of max_edges if there are no levels.
+/// Returns nothing if stream_line is set, it gets every line as soon as it is simplified instead,
+/// or if the kept vertices are written. The preprocessing is taken from snapshot if it is set.
+/// Quantized coordinates pass their quantization, so a state of another quantization is not reused.
+template<typename SimplificationT, typename PointFilterT,
+         typename CoordinateT = typename PointFilterT::coordinate_type>
+std::vector<std::vector<basic_poly_line<CoordinateT>>> simplify(std::vector<basic_poly_line<CoordinateT>>&& lines,
+                                                   std::vector<basic_point<CoordinateT>>&& points,
+                                                   const std::vector<CoordinateT>& pinned,
+                                                   const basic_preprocessing_snapshot<CoordinateT>* snapshot,
+                                                   const std::vector<detail_level>& levels,
+                                                   const line_output<CoordinateT>& stream_line,
+                                                   const simplification_options& engine_options,
+                                                   const deberg_options& options,
+                                                   const quantization_parameters& quantization = quantization_parameters())
+{
+    auto run = [&pinned, snapshot, &levels, &stream_line, &options, &quantization](std::vector<basic_poly_line<CoordinateT>>&& run_lines,
+                                   std::vector<basic_point<CoordinateT>>&& run_points,
+                                   const simplification_options& run_options,
+                                   bool is_main_run, unsigned& used_edges)
+    {
+        using simplification_type = map_simplification<SimplificationT, PointFilterT>;
+        simplification_type simplification(std::move(run_lines), std::move(run_points));
+        simplification.set_num_threads(options.num_threads);
+        simplification.set_options(run_options);
+        simplification.set_quantization(quantization);
+        simplification.pin_vertices(pinned);
+        if (options.pin_shared)
+        {
+            simplification.pin_shared_vertices();
+        }
+        if (snapshot != nullptr)
+        {
+            simplification.use_snapshot(*snapshot);
+        }
+        if (options.allocate_edges)
+        {
+            simplification.allocate_max_edges();
+        }
+        if (is_main_run && !options.previous_state_file_path.empty())
+        {
+            std::ifstream state_input(options.previous_state_file_path, std::ios::binary);
+            simplification.set_previous_state(simplification_type::state_type::read(state_input));
+        }
+        if (is_main_run && (!options.state_file_path.empty() || !options.graph_file_path.empty()))
+        {
+            simplification.record_state();
+        }
+        std::unique_ptr<shortcut_cache> cache;
+        if (is_main_run && !options.cache_file_path.empty())
+        {
+            cache.reset(new shortcut_cache(options.cache_file_path, options.cache_bytes));
+            simplification.use_cache(*cache);
+        }
+        std::unique_ptr<simplification_checkpoint> checkpoint;
+        if (is_main_run && !options.checkpoint_file_path.empty())
+        {
+            checkpoint.reset(new simplification_checkpoint(options.checkpoint_file_path, options.resume));
+            simplification.use_checkpoint(*checkpoint);
+        }
+
+        std::vector<std::vector<basic_poly_line<CoordinateT>>> simplified;
+        if (is_main_run && stream_line)
+        {
+            simplification.stream(options.max_edges, stream_line, options.keep_order);
+        }
+        else if (is_main_run && !levels.empty())
+        {
+            simplified = simplification(levels);
+        }
+        else
+        {
+            simplified.push_back(simplification(options.max_edges));
+        }
+        used_edges = simplification.used_edges();
+
+        if (is_main_run && options.write_indices && !stream_line)
+        {
+            std::ofstream index_output(options.output_file_path, std::ios::binary);
+            vertex_index_writer writer(index_output);
+            for (auto i = 0u; i < simplified.front().size(); ++i)
+            {
+                writer.write_line(simplified.front()[i].id, simplification.original_indices()[i]);
+            }
+            simplified.clear();
+        }
+
+        if (is_main_run && !options.state_file_path.empty())
+        {
+            std::ofstream state_output(options.state_file_path, std::ios::binary);
+            simplification.state().write(state_output);
+        }
+        if (is_main_run && !options.graph_file_path.empty())
+        {
+            std::ofstream graph_output(options.graph_file_path, std::ios::binary);
+            basic_shortcut_graph_file<CoordinateT>::write(graph_output, simplification.state());
+        }
+        if (cache)
+        {
+            cache->save();
+            std::cout << "Cache: " << cache->hits() << " hits, " << cache->misses() << " misses, "
+                      << cache->size() << " lines (" << cache->bytes() << " bytes)." << std::endl;
+        }
+        return simplified;
+    };
+
+    bool compare = options.compare_unbounded && (engine_options.window.is_bounded() || engine_options.max_deviation > 0);
+    std::vector<basic_poly_line<CoordinateT>> unbounded_lines;
+    std::vector<basic_point<CoordinateT>> unbounded_points;
+    if (compare)
+    {
+        unbounded_lines = lines;
+        unbounded_points = points;
+    }
+
+    unsigned used_edges = 0;
+    TIMER_START(simplification);
+    auto simplified = run(std::move(lines), std::move(points), engine_options, true, used_edges);
+    TIMER_STOP(simplification);
+    std::cout << "Took " << TIMER_MSEC(simplification) << " msec." << std::endl;
+
+    if (compare)
+    {
+        std::cout << "Unbounded run:" << std::endl;
+        unsigned unbounded_edges = 0;
+        TIMER_START(unbounded);
+        auto unbounded_options = engine_options;
+        unbounded_options.window = simplification_window();
+        unbounded_options.max_deviation = 0;
+        run(std::move(unbounded_lines), std::move(unbounded_points), unbounded_options, false, unbounded_edges);
+        TIMER_STOP(unbounded);
+        std::cout << "Took " << TIMER_MSEC(unbounded) << " msec." << std::endl;
+
+        auto difference = static_cast<int>(used_edges) - static_cast<int>(unbounded_edges);
+        std::cout << "Bounded run uses " << used_edges << " edges, " << difference << " more than the unbounded run ("
+                  << (unbounded_edges > 0 ? 100.0 * difference / unbounded_edges : 0.0) << "%)." << std::endl;
+    }
+
+    return simplified;
+}
+
+/// Runs the engine without converting the coordinates
+template<typename SimplificationT>
+using direct_simplification = SimplificationT;
+
+/// Selects the engine from the options. The engine filters its points with EngineFilterT
+/// and is wrapped into WrapperT, e.g. to convert the coordinates.
+template<template<typename> class WrapperT, typename EngineFilterT, typename PointFilterT,
+         typename CoordinateT = typename PointFilterT::coordinate_type>
+std::vector<std::vector<basic_poly_line<CoordinateT>>> simplify_with_engine(
+    std::vector<basic_poly_line<CoordinateT>>&& lines, std::vector<basic_point<CoordinateT>>&& points,
+    const std::vector<CoordinateT>& pinned, const basic_preprocessing_snapshot<CoordinateT>* snapshot,
+    const std::vector<detail_level>& levels, const line_output<CoordinateT>& stream_line, const simplification_options& engine_options,
+                                                               const deberg_options& options,
+    const quantization_parameters& quantization = quantization_parameters())
+{
+    if (options.use_douglas_peucker)
+    {
+        return simplify<WrapperT<douglas_peucker<EngineFilterT>>, PointFilterT>(
+                    std::move(lines), std::move(points), pinned, snapshot, levels, stream_line, engine_options, options, quantization);
+    }
+    else if (options.use_chunks)
+    {
+        return simplify<WrapperT<chunked_simplification<deberg<EngineFilterT>>>, PointFilterT>(
+                    std::move(lines), std::move(points), pinned, snapshot, levels, stream_line, engine_options, options, quantization);
+    }
+
+    return simplify<WrapperT<deberg<EngineFilterT>>, PointFilterT>(
+                std::move(lines), std::move(points), pinned, snapshot, levels, stream_line, engine_options, options, quantization);
+}
+
+template<typename QuantizerT>
+void simplify_quantized(const QuantizerT& quantizer, const deberg_options& options,
+                        const std::vector<poly_line>& lines, const std::vector<point>& points,
+                        const std::vector<point>& pinned)
+{
+    using point_filter = basic_bb_point_filter<typename QuantizerT::coordinate_type>;
+
+    // the window length and deviation are given in input units
+    auto engine_options = get_simplification_options(options);
+    engine_options.window.max_length /= options.quantization_resolution;
+    engine_options.max_deviation /= options.quantization_resolution;
+
+    using quantized_line = basic_poly_line<typename QuantizerT::coordinate_type>;
+    std::ofstream stream_output;
+    auto stream_line = get_stream_output<typename QuantizerT::coordinate_type>(stream_output, options,
+        [&quantizer](const quantized_line& line) { return quantizer.dequantize(line); });
+
+    // snapshots are not quantized
+    const basic_preprocessing_snapshot<typename QuantizerT::coordinate_type>* no_snapshot = nullptr;
+    auto simplified = simplify_with_engine<direct_simplification, point_filter, point_filter>(
+                        quantizer.quantize(lines), quantizer.quantize(points),
+                        point_locations(quantizer.quantize(pinned)), no_snapshot,
+                        get_detail_levels(options, options.quantization_resolution), stream_line, engine_options, options,
+                        quantizer.parameters());
+    for (auto k = 0u; k < simplified.size(); ++k)
+    {
+        write_lines(get_output_file_path(options, k), simplified[k], options, quantizer);
+    }
+}
+
+/// Selects the shortest path of every line from the shortcut graphs of an earlier run
+int select_main(int argc, char** argv)
+{
+    unsigned max_edges = 0;
+    std::stringstream param_buffer(argc > 1 ? argv[1] : "");
+    param_buffer >> max_edges;
+    if (argc != 4 || param_buffer.fail())
+    {
+        std::cout << "Error: could not parse arguments." << std::endl;
+        deberg_options().print_help();
+        return 1;
+    }
+
+    TIMER_START(load);
+    shortcut_graph_file graphs(argv[2]);
+    TIMER_STOP(load);
+    std::cout << "Mapped " << graphs.size() << " lines in " << TIMER_MSEC(load) << " msec." << std::endl;
+
+    TIMER_START(selection);
+    std::vector<poly_line> simplified(graphs.size());
+    unsigned used_edges = 0;
+    for (auto i = 0u; i < graphs.size(); ++i)
+    {
+        auto graph = graphs.line(i);
+        simplified[i].id = graph.id;
+        if (graph.number_of_nodes() == 0)
+        {
+            continue;
+        }
+
+        auto path = graph_util::shortest_dag_path_nodes(graph, 0, graph.number_of_nodes() - 1);
+        used_edges += path.size() - 1;
+        for (auto idx : path)
+        {
+            simplified[i].coordinates.push_back(graph.coordinate(idx));
+        }
+    }
+    TIMER_STOP(selection);
+
+    if (used_edges > max_edges)
+    {
+        std::cout << "Warning: There is no simplification using " << max_edges << " edges. " << used_edges << " edges is a minimum" << std::endl;
+    }
+    else
+    {
+        std::cout << "Used " << used_edges << " edges." << std::endl;
+    }
+    std::cout << "Took " << TIMER_MSEC(selection) << " msec." << std::endl;
+
+    write_lines(argv[3], simplified, deberg_options());
+    return 0;
+}
+
+/// Applies the kept vertices written with --indices to the input lines
+int expand_main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cout << "Error: could not parse arguments." << std::endl;
+        deberg_options().print_help();
+        return 1;
+    }
+
+    std::ifstream index_input(argv[1], std::ios::binary);
+    vertex_index_reader reader(index_input);
+    auto kept = reader.read();
+    deberg_options gml_options;
+    write_lines(argv[3], vertex_index_reader::expand(read_lines(argv[2], gml_options), kept), gml_options);
+    return 0;
+}
+
+/// Writes the input and its preprocessing to a snapshot that later runs map with --snapshot
+int prepare_main(int argc, char** argv)
+{
+    deberg_options options;
+    if (!options.parse_prepare(argc, argv))
+    {
+        std::cout << "Error: could not parse arguments." << std::endl;
+        options.print_help();
+        return 1;
+    }
+
+    TIMER_START(preparation);
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(
+        read_lines(options.line_file_path, options), read_points(options.point_file_path, options));
+    simplification.set_num_threads(options.num_threads);
+    if (!options.pin_file_path.empty())
+    {
+        simplification.pin_vertices(point_locations(read_points(options.pin_file_path, options)));
+    }
+    if (options.pin_shared)
+    {
+        simplification.pin_shared_vertices();
+    }
+    auto content = simplification.prepare();
+    TIMER_STOP(preparation);
+    std::cout << "Prepared " << content.lines.size() << " lines in " << TIMER_MSEC(preparation) << " msec." << std::endl;
+
+    std::ofstream snapshot_output(options.snapshot_file_path, std::ios::binary);
+    preprocessing_snapshot::write(snapshot_output, content);
+    return 0;
+}
+
+/// Simplifies the input of a request and returns the output in the format of the request's options
+template<typename SimplificationT>
+std::string serve_request(simplification_server::request_input&& input, const std::vector<coordinate>& pinned,
+                          const deberg_options& options)
+{
+    map_simplification<SimplificationT, bb_point_filter> simplification(std::move(input.lines), std::move(input.points));
+    simplification.set_options(get_simplification_options(options));
+    simplification.pin_vertices(pinned);
+    if (options.allocate_edges)
+    {
+        simplification.allocate_max_edges();
+    }
+    auto simplified = simplification(options.max_edges);
+
+    std::ostringstream output;
+    if (options.write_indices)
+    {
+        vertex_index_writer writer(output);
+        for (auto i = 0u; i < simplified.size(); ++i)
+        {
+            writer.write_line(simplified[i].id, simplification.original_indices()[i]);
+        }
+    }
+    else
+    {
+        auto write_line = get_line_writer(output, options);
+        for (const auto& l : simplified)
+        {
+            write_line(l);
+        }
+    }
+    return output.str();
+}
+
+/// Selects the engine of a request like simplify_with_engine
+template<template<typename> class WrapperT, typename EngineFilterT>
+std::string serve_with_engine(simplification_server::request_input&& input, const std::vector<coordinate>& pinned,
+                              const deberg_options& options)
+{
+    if (options.use_douglas_peucker)
+    {
+        return serve_request<WrapperT<douglas_peucker<EngineFilterT>>>(std::move(input), pinned, options);
+    }
+    else if (options.use_chunks)
+    {
+        return serve_request<WrapperT<chunked_simplification<deberg<EngineFilterT>>>>(std::move(input), pinned, options);
+    }
+
+    return serve_request<WrapperT<deberg<EngineFilterT>>>(std::move(input), pinned, options);
+}
+
+/// Keeps the input in memory and answers simplification requests from stdin on stdout
+int serve_main(int argc, char** argv)
+{
+    deberg_options options;
+    if (!options.parse_serve(argc, argv))
+    {
+        std::cout << "Error: could not parse arguments." << std::endl;
+        options.print_help();
+        return 1;
+    }
+
+    // stdout only carries responses, everything else is logged to stderr
+    std::ostream responses(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    TIMER_START(load);
+    std::vector<poly_line> lines;
+    std::vector<point> points;
+    std::vector<coordinate> pinned;
+    if (!options.snapshot_file_path.empty())
+    {
+        preprocessing_snapshot snapshot(options.snapshot_file_path);
+        lines = snapshot.lines();
+        points = snapshot.points();
+        pinned = snapshot.pinned_coordinates();
+    }
+    else
+    {
+        lines = read_lines(options.line_file_path, options);
+        points = read_points(options.point_file_path, options);
+
+        // shared vertices are found on the whole map, not only among the lines of a request
+        map_simplification<deberg<bb_point_filter>, bb_point_filter> pins(std::vector<poly_line>(lines), {});
+        if (!options.pin_file_path.empty())
+        {
+            pins.pin_vertices(point_locations(read_points(options.pin_file_path, options)));
+        }
+        if (options.pin_shared)
+        {
+            pins.pin_shared_vertices();
+        }
+        pinned = pins.pinned_vertices();
+    }
+    simplification_server server(std::move(lines), std::move(points));
+    TIMER_STOP(load);
+    std::cout << "Loaded " << server.size() << " lines in " << TIMER_MSEC(load) << " msec, serving on "
+              << options.num_threads << " threads." << std::endl;
+
+    server.serve(std::cin, responses, options.num_threads,
+        [&server, &pinned](const std::string& arguments)
+        {
+            std::istringstream argument_stream(arguments);
+            std::vector<std::string> tokens;
+            std::string token;
+            while (argument_stream >> token)
+            {
+                tokens.push_back(token);
+            }
+
+            deberg_options request_options;
+            if (!request_options.parse_request(tokens))
+            {
+                throw std::runtime_error("Could not parse the request.");
+            }
+
+            auto input = server.input(request_options.line_ids);
+            if (request_options.use_float32)
+            {
+                using local_filter = basic_bb_point_filter<local_coordinate>;
+                return serve_with_engine<local_frame_simplification, local_filter>(std::move(input), pinned, request_options);
+            }
+            return serve_with_engine<direct_simplification, bb_point_filter>(std::move(input), pinned, request_options);
+        });
+
+    std::cout.rdbuf(responses.rdbuf());
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
+    if (argc > 1 && std::string(argv[1]) == "select")
+    {
+        return select_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::string(argv[1]) == "expand")
+    {
+        return expand_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::string(argv[1]) == "prepare")
+    {
+        return prepare_main(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::string(argv[1]) == "serve")
+    {
+        return serve_main(argc - 1, argv + 1);
+    }
+
     deberg_options options;
     if (!options.parse(argc, argv))
     {
@@ -42,16 +655,80 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    auto lines = read_lines(options.line_file_path);
-    auto points = read_points(options.point_file_path);
+    auto engine_options = get_simplification_options(options);
 
-    TIMER_START(simplification);
-    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines), std::move(points));
-    auto simplified = simplification(options.max_edges);
-    TIMER_STOP(simplification);
-    std::cout << "Took " << TIMER_MSEC(simplification) << " msec." << std::endl;
+    std::unique_ptr<preprocessing_snapshot> snapshot;
+    std::vector<poly_line> lines;
+    std::vector<point> points;
+    std::vector<point> pinned;
+    if (!options.snapshot_file_path.empty())
+    {
+        TIMER_START(load);
+        snapshot.reset(new preprocessing_snapshot(options.snapshot_file_path));
+        lines = snapshot->lines();
+        points = snapshot->points();
+        TIMER_STOP(load);
+        std::cout << "Mapped " << snapshot->size() << " lines in " << TIMER_MSEC(load) << " msec." << std::endl;
+    }
+    else
+    {
+        lines = read_lines(options.line_file_path, options);
+        points = read_points(options.point_file_path, options);
+        if (!options.pin_file_path.empty())
+        {
+            pinned = read_points(options.pin_file_path, options);
+        }
+    }
+    // the snapshot also contains the shared vertices if it was prepared with --pin-shared
+    auto pinned_locations = snapshot ? snapshot->pinned_coordinates() : point_locations(pinned);
 
-    write_lines(options.output_file_path, simplified);
+    if (options.quantization_resolution > 0)
+    {
+        auto bounds = compute_bounds(lines, points);
+        if (compact_quantizer::fits(bounds.first, bounds.second, options.quantization_resolution))
+        {
+            std::cout << "Using 32bit quantized coordinates." << std::endl;
+            compact_quantizer grid(bounds.first, options.quantization_resolution);
+            simplify_quantized(grid, options, lines, points, pinned);
+        }
+        else if (quantizer::fits(bounds.first, bounds.second, options.quantization_resolution))
+        {
+            std::cout << "Using 64bit quantized coordinates." << std::endl;
+            quantizer grid(bounds.first, options.quantization_resolution);
+            simplify_quantized(grid, options, lines, points, pinned);
+        }
+        else
+        {
+            std::cout << "Error: resolution " << options.quantization_resolution << " is too fine for the extent of the input." << std::endl;
+            return 1;
+        }
+    }
+    else if (options.use_float32)
+    {
+        std::cout << "Using 32bit floating point coordinates." << std::endl;
+        using local_filter = basic_bb_point_filter<local_coordinate>;
+        std::ofstream stream_output;
+        auto stream_line = get_stream_output<coordinate>(stream_output, options, [](const poly_line& line) { return line; });
+        auto simplified = simplify_with_engine<local_frame_simplification, local_filter, bb_point_filter>(
+                            std::move(lines), std::move(points), pinned_locations, snapshot.get(), get_detail_levels(options, 1),
+                            stream_line, engine_options, options);
+        for (auto k = 0u; k < simplified.size(); ++k)
+        {
+            write_lines(get_output_file_path(options, k), simplified[k], options);
+        }
+    }
+    else
+    {
+        std::ofstream stream_output;
+        auto stream_line = get_stream_output<coordinate>(stream_output, options, [](const poly_line& line) { return line; });
+        auto simplified = simplify_with_engine<direct_simplification, bb_point_filter, bb_point_filter>(
+                            std::move(lines), std::move(points), pinned_locations, snapshot.get(), get_detail_levels(options, 1),
+                            stream_line, engine_options, options);
+        for (auto k = 0u; k < simplified.size(); ++k)
+        {
+            write_lines(get_output_file_path(options, k), simplified[k], options);
+        }
+    }
 
     return 0;
 }
@@ -1,43 +1,523 @@
 #ifndef DEBERG_OPTIONS_HPP
 #define DEBERG_OPTIONS_HPP
 
+#include <cstddef>
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 class deberg_options
 {
 public:
     bool parse(int argc, char** argv)
     {
-        if (argc < 5)
+        std::vector<std::string> positional;
+        if (!parse_options(argc, argv, positional))
         {
             return false;
         }
 
-        std::stringstream param_buffer;
-        param_buffer << argv[1];
-        param_buffer >> max_edges;
+        // the lines, points and pinned vertices are taken from the snapshot
+        if (!snapshot_file_path.empty())
+        {
+            if (positional.size() != 2 || quantization_resolution > 0 || !pin_file_path.empty() || pin_shared)
+            {
+                return false;
+            }
+            positional.insert(positional.begin() + 1, 2, std::string());
+        }
+
+        if (positional.size() < 4 || (use_float32 && quantization_resolution > 0)
+            || (!graph_file_path.empty() && quantization_resolution > 0)
+            || (resume && checkpoint_file_path.empty()) || chunk_size < chunk_overlap + 2
+            || (use_douglas_peucker && use_chunks) || (target_edges > 0 && !use_douglas_peucker)
+            || (!level_deviations.empty() && !level_edges.empty())
+            || (stream && (allocate_edges || !level_deviations.empty() || !level_edges.empty()))
+            || (keep_order && !stream)
+            || (goal_directed && (allocate_edges || !level_deviations.empty() || !level_edges.empty()
+                                  || !graph_file_path.empty()))
+            || (write_indices && (!level_deviations.empty() || !level_edges.empty() || output_format != "gml")))
+        {
+            return false;
+        }
+
+        if (!parse_value(positional[0], max_edges))
+        {
+            return false;
+        }
+
+        line_file_path = positional[1];
+        point_file_path = positional[2];
+        output_file_path = positional[3];
+        return true;
+    }
+
+    /// Parses the arguments of ./deberg prepare, argv[0] is the subcommand
+    bool parse_prepare(int argc, char** argv)
+    {
+        std::vector<std::string> positional;
+        if (!parse_options(argc, argv, positional) || positional.size() != 3 || !snapshot_file_path.empty()
+            || quantization_resolution > 0)
+        {
+            return false;
+        }
+
+        line_file_path = positional[0];
+        point_file_path = positional[1];
+        snapshot_file_path = positional[2];
+        return true;
+    }
+
+    /// Parses the arguments of ./deberg serve, argv[0] is the subcommand
+    bool parse_serve(int argc, char** argv)
+    {
+        std::vector<std::string> positional;
+        if (!parse_options(argc, argv, positional) || quantization_resolution > 0)
+        {
+            return false;
+        }
+
+        if (snapshot_file_path.empty() && positional.size() == 2)
+        {
+            line_file_path = positional[0];
+            point_file_path = positional[1];
+            return true;
+        }
+        return !snapshot_file_path.empty() && positional.empty() && pin_file_path.empty() && !pin_shared;
+    }
+
+    /// Parses the arguments of a request to ./deberg serve: MAX_EDGES [OPTIONS] [LINE_ID...].
+    /// Only options that change the simplification of the requested lines or its output are allowed.
+    bool parse_request(const std::vector<std::string>& arguments)
+    {
+        std::vector<char*> argv {const_cast<char*>("request")};
+        for (const auto& a : arguments)
+        {
+            argv.push_back(const_cast<char*>(a.c_str()));
+        }
 
-        line_file_path = std::string(argv[2]);
-        point_file_path = std::string(argv[3]);
-        output_file_path = std::string(argv[4]);
+        std::vector<std::string> positional;
+        if (!parse_options(argv.size(), argv.data(), positional) || positional.empty()
+            || quantization_resolution > 0 || !pin_file_path.empty() || pin_shared || compare_unbounded
+            || !level_deviations.empty() || !level_edges.empty() || stream || keep_order
+            || !graph_file_path.empty() || !checkpoint_file_path.empty() || resume || !cache_file_path.empty()
+            || !state_file_path.empty() || !previous_state_file_path.empty() || !snapshot_file_path.empty()
+            || input_format != "gml" || num_threads != 1 || chunk_size < chunk_overlap + 2
+            || (use_douglas_peucker && use_chunks) || (target_edges > 0 && !use_douglas_peucker)
+            || (write_indices && output_format != "gml")
+            || (goal_directed && allocate_edges))
+        {
+            return false;
+        }
+
+        if (!parse_value(positional[0], max_edges))
+        {
+            return false;
+        }
+        line_ids.resize(positional.size() - 1);
+        for (auto k = 0u; k < line_ids.size(); ++k)
+        {
+            if (!parse_value(positional[k + 1], line_ids[k]))
+            {
+                return false;
+            }
+        }
         return true;
     }
 
     void print_help() const
     {
-        std::cout << "./deberg MAX_EDGES LINE_FILE_PATH POINT_FILE_PATH OUTPUT_FILE_PATH\n" << std::endl
+        std::cout << "./deberg [OPTIONS] MAX_EDGES LINE_FILE_PATH POINT_FILE_PATH OUTPUT_FILE_PATH" << std::endl
+                  << "./deberg select MAX_EDGES GRAPH_FILE_PATH OUTPUT_FILE_PATH" << std::endl
+                  << "./deberg expand INDEX_FILE_PATH LINE_FILE_PATH OUTPUT_FILE_PATH" << std::endl
+                  << "./deberg prepare [OPTIONS] LINE_FILE_PATH POINT_FILE_PATH SNAPSHOT_FILE_PATH" << std::endl
+                  << "./deberg --snapshot SNAPSHOT_FILE_PATH [OPTIONS] MAX_EDGES OUTPUT_FILE_PATH" << std::endl
+                  << "./deberg serve [OPTIONS] LINE_FILE_PATH POINT_FILE_PATH" << std::endl
+                  << "./deberg serve --snapshot SNAPSHOT_FILE_PATH [--threads N]\n" << std::endl
                   << "\tMAX_EDGES            maximum number of edges in output" << std::endl
                   << "\tLINE_FILE_PATH       path to graphml line file" << std::endl
                   << "\tPOINT_FILE_PATH      path to graphml point file" << std::endl
-                  << "\tOUTPUT_FILE_PATH     path to output file" << std::endl;
+                  << "\tOUTPUT_FILE_PATH     path to output file" << std::endl
+                  << "\tGRAPH_FILE_PATH      shortcut graphs written with --graph" << std::endl
+                  << "\tINDEX_FILE_PATH      kept vertices written with --indices" << std::endl
+                  << "\tSNAPSHOT_FILE_PATH   preprocessed input written by ./deberg prepare, which" << std::endl
+                  << "\t                     takes --pin, --pin-shared, --input-format and --threads\n" << std::endl
+                  << "./deberg serve keeps the map in memory and answers requests from stdin, one per" << std::endl
+                  << "line: ID MAX_EDGES [OPTIONS] [LINE_ID...], all lines if no ids are given. The" << std::endl
+                  << "options change the engine, its bounds and the output format. Every response on" << std::endl
+                  << "stdout is a line \"ID ok|error BYTES MSEC\" followed by BYTES bytes of output." << std::endl
+                  << "The requests are processed on --threads workers, the pins apply to all of them.\n" << std::endl
+                  << "Options:" << std::endl
+                  << "\t--quantize RESOLUTION  snap coordinates to an integer grid with the given" << std::endl
+                  << "\t                       resolution and use exact integer predicates" << std::endl
+                  << "\t--float32              simplify each line with single precision coordinates" << std::endl
+                  << "\t                       relative to its bounding box" << std::endl
+                  << "\t--pin POINT_FILE_PATH  split lines at vertices with the coordinates of the" << std::endl
+                  << "\t                       given points and keep these vertices" << std::endl
+                  << "\t--pin-shared           split lines at vertices shared with other lines" << std::endl
+                  << "\t--window K             shortcuts end at most K vertices after their start" << std::endl
+                  << "\t--max-length LENGTH    shortcuts end within the given distance of their start" << std::endl
+                  << "\t--max-deviation D      removed vertices stay within distance D of their shortcut" << std::endl
+                  << "\t--work-budget N        simplify lines that process more than N candidate" << std::endl
+                  << "\t                       vertices with the fallback window instead" << std::endl
+                  << "\t--fallback-window K    window of lines exceeding the work budget (default 16)" << std::endl
+                  << "\t--compare-unbounded    also run without window and deviation bound and report" << std::endl
+                  << "\t                       the difference" << std::endl
+                  << "\t--allocate-edges       spend MAX_EDGES across all lines to minimize the largest" << std::endl
+                  << "\t                       deviation instead of using the fewest edges" << std::endl
+                  << "\t--level-deviations LIST" << std::endl
+                  << "\t                       write one output per deviation bound of the comma" << std::endl
+                  << "\t                       separated list, the level is inserted before the" << std::endl
+                  << "\t                       extension of OUTPUT_FILE_PATH, e.g. out.0.txt" << std::endl
+                  << "\t--level-edges LIST     like --level-deviations with the smallest deviation" << std::endl
+                  << "\t                       that fits into each number of edges" << std::endl
+                  << "\t--stream               write every line as soon as it is simplified, in the" << std::endl
+                  << "\t                       order they finish (not with --allocate-edges or levels)" << std::endl
+                  << "\t--keep-order           write the streamed lines in input order" << std::endl
+                  << "\t--indices              write the indices of the kept vertices of every line" << std::endl
+                  << "\t                       instead of their coordinates, see ./deberg expand" << std::endl
+                  << "\t                       (not with levels)" << std::endl
+                  << "\t--goal-directed        only compute the shortcuts of vertices reached by the" << std::endl
+                  << "\t                       search for the shortest path (not with --allocate-edges," << std::endl
+                  << "\t                       levels or --graph, which need all shortcuts)" << std::endl
+                  << "\t--funnel               find shortcuts with a funnel sweep instead of sorting" << std::endl
+                  << "\t--douglas-peucker      use the faster Douglas-Peucker engine with topology" << std::endl
+                  << "\t                       repair, --max-deviation is its tolerance" << std::endl
+                  << "\t--target-edges N       split every line into N edges with --douglas-peucker," << std::endl
+                  << "\t                       or more if the tolerance or the topology needs them" << std::endl
+                  << "\t--chunked              simplify long lines in overlapping chunks in parallel" << std::endl
+                  << "\t--chunk-size N         number of vertices per chunk (default 4096)" << std::endl
+                  << "\t--chunk-overlap N      number of vertices shared by two chunks (default 256)" << std::endl
+                  << "\t--state FILE           write the shortcuts of all lines to FILE" << std::endl
+                  << "\t--previous-state FILE  only simplify the lines that changed since the run" << std::endl
+                  << "\t                       that wrote FILE with the same options" << std::endl
+                  << "\t--graph FILE           write the shortcut graphs of all lines to FILE, see" << std::endl
+                  << "\t                       ./deberg select (not with --quantize)" << std::endl
+                  << "\t--checkpoint FILE      append the shortcuts of every completed line to FILE" << std::endl
+                  << "\t--resume               skip the lines that are already in the checkpoint" << std::endl
+                  << "\t--cache FILE           reuse the shortcuts of identical lines with identical" << std::endl
+                  << "\t                       points from earlier runs" << std::endl
+                  << "\t--cache-bytes N        maximal size of the cache (default 64 MiB)" << std::endl
+                  << "\t--input-format FORMAT  format of the line, point and pin files: gml (default)" << std::endl
+                  << "\t                       or wkb (records of id, size and WKB geometry)" << std::endl
+                  << "\t--output-format FORMAT format of the output: gml (default), wkb or geojson" << std::endl
+                  << "\t--snapshot FILE        map the input and its preprocessing from a snapshot" << std::endl
+                  << "\t                       written by ./deberg prepare (not with --quantize or pins)" << std::endl
+                  << "\t--threads N            number of threads used for simplification" << std::endl;
     }
 
-    unsigned max_edges;
+    unsigned max_edges = 0;
+    /// 0 disables quantization
+    double quantization_resolution = 0;
+    bool use_float32 = false;
+    bool pin_shared = false;
+    /// 0 disables the limit
+    unsigned window_vertices = 0;
+    /// 0 disables the limit
+    double window_length = 0;
+    /// 0 disables the bound
+    double max_deviation = 0;
+    /// 0 disables the target
+    unsigned target_edges = 0;
+    /// 0 disables the budget
+    std::size_t work_budget = 0;
+    unsigned fallback_window = 16;
+    bool compare_unbounded = false;
+    bool allocate_edges = false;
+    /// empty if only one level is written
+    std::vector<double> level_deviations;
+    /// empty if only one level is written
+    std::vector<unsigned> level_edges;
+    bool write_indices = false;
+    bool stream = false;
+    bool keep_order = false;
+    bool goal_directed = false;
+    bool use_funnel_sweep = false;
+    bool use_douglas_peucker = false;
+    bool use_chunks = false;
+    unsigned chunk_size = 4096;
+    unsigned chunk_overlap = 256;
+    unsigned num_threads = 1;
+    /// empty if no vertices are pinned explicitly
+    std::string pin_file_path;
+    /// empty if the shortcut graphs are not written
+    std::string graph_file_path;
+    /// empty if no checkpoint is written
+    std::string checkpoint_file_path;
+    bool resume = false;
+    /// empty if no cache is used
+    std::string cache_file_path;
+    std::size_t cache_bytes = 64 << 20;
+    /// empty if the state is not written
+    std::string state_file_path;
+    /// empty if all lines are simplified
+    std::string previous_state_file_path;
+    /// gml or wkb
+    std::string input_format = "gml";
+    /// gml, wkb or geojson
+    std::string output_format = "gml";
+    /// empty if the input is read from the line and point files
+    std::string snapshot_file_path;
+    /// lines of a request to ./deberg serve, empty if all lines are simplified
+    std::vector<unsigned> line_ids;
     std::string line_file_path;
     std::string point_file_path;
     std::string output_file_path;
+
+private:
+    /// Parses all options and collects the remaining arguments
+    bool parse_options(int argc, char** argv, std::vector<std::string>& positional)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument(argv[i]);
+            if (argument == "--quantize")
+            {
+                if (++i >= argc || !parse_value(argv[i], quantization_resolution) || !(quantization_resolution > 0))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--float32")
+            {
+                use_float32 = true;
+            }
+            else if (argument == "--pin")
+            {
+                if (++i >= argc)
+                {
+                    return false;
+                }
+                pin_file_path = argv[i];
+            }
+            else if (argument == "--pin-shared")
+            {
+                pin_shared = true;
+            }
+            else if (argument == "--window")
+            {
+                if (++i >= argc || !parse_value(argv[i], window_vertices) || window_vertices == 0)
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--max-length")
+            {
+                if (++i >= argc || !parse_value(argv[i], window_length) || !(window_length > 0))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--max-deviation")
+            {
+                if (++i >= argc || !parse_value(argv[i], max_deviation) || !(max_deviation > 0))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--target-edges")
+            {
+                if (++i >= argc || !parse_value(argv[i], target_edges) || target_edges == 0)
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--work-budget")
+            {
+                if (++i >= argc || !parse_value(argv[i], work_budget) || work_budget == 0)
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--fallback-window")
+            {
+                if (++i >= argc || !parse_value(argv[i], fallback_window) || fallback_window == 0)
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--compare-unbounded")
+            {
+                compare_unbounded = true;
+            }
+            else if (argument == "--allocate-edges")
+            {
+                allocate_edges = true;
+            }
+            else if (argument == "--level-deviations")
+            {
+                if (++i >= argc || !parse_list(argv[i], level_deviations))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--level-edges")
+            {
+                if (++i >= argc || !parse_list(argv[i], level_edges))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--stream")
+            {
+                stream = true;
+            }
+            else if (argument == "--keep-order")
+            {
+                keep_order = true;
+            }
+            else if (argument == "--indices")
+            {
+                write_indices = true;
+            }
+            else if (argument == "--goal-directed")
+            {
+                goal_directed = true;
+            }
+            else if (argument == "--funnel")
+            {
+                use_funnel_sweep = true;
+            }
+            else if (argument == "--douglas-peucker")
+            {
+                use_douglas_peucker = true;
+            }
+            else if (argument == "--chunked")
+            {
+                use_chunks = true;
+            }
+            else if (argument == "--chunk-size")
+            {
+                if (++i >= argc || !parse_value(argv[i], chunk_size))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--chunk-overlap")
+            {
+                if (++i >= argc || !parse_value(argv[i], chunk_overlap))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--state")
+            {
+                if (++i >= argc)
+                {
+                    return false;
+                }
+                state_file_path = argv[i];
+            }
+            else if (argument == "--previous-state")
+            {
+                if (++i >= argc)
+                {
+                    return false;
+                }
+                previous_state_file_path = argv[i];
+            }
+            else if (argument == "--graph")
+            {
+                if (++i >= argc)
+                {
+                    return false;
+                }
+                graph_file_path = argv[i];
+            }
+            else if (argument == "--checkpoint")
+            {
+                if (++i >= argc)
+                {
+                    return false;
+                }
+                checkpoint_file_path = argv[i];
+            }
+            else if (argument == "--resume")
+            {
+                resume = true;
+            }
+            else if (argument == "--cache")
+            {
+                if (++i >= argc)
+                {
+                    return false;
+                }
+                cache_file_path = argv[i];
+            }
+            else if (argument == "--cache-bytes")
+            {
+                if (++i >= argc || !parse_value(argv[i], cache_bytes))
+                {
+                    return false;
+                }
+            }
+            else if (argument == "--input-format")
+            {
+                if (++i >= argc || (std::string(argv[i]) != "gml" && std::string(argv[i]) != "wkb"))
+                {
+                    return false;
+                }
+                input_format = argv[i];
+            }
+            else if (argument == "--output-format")
+            {
+                if (++i >= argc || (std::string(argv[i]) != "gml" && std::string(argv[i]) != "wkb"
+                                    && std::string(argv[i]) != "geojson"))
+                {
+                    return false;
+                }
+                output_format = argv[i];
+            }
+            else if (argument == "--snapshot")
+            {
+                if (++i >= argc)
+                {
+                    return false;
+                }
+                snapshot_file_path = argv[i];
+            }
+            else if (argument == "--threads")
+            {
+                if (++i >= argc || !parse_value(argv[i], num_threads) || num_threads == 0)
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                positional.push_back(argument);
+            }
+        }
+
+        return true;
+    }
+
+    template<typename T>
+    static bool parse_value(const std::string& argument, T& value)
+    {
+        std::stringstream param_buffer(argument);
+        param_buffer >> value;
+        return !param_buffer.fail();
+    }
+
+    /// Parses a comma separated list of positive values
+    template<typename T>
+    static bool parse_list(const std::string& argument, std::vector<T>& values)
+    {
+        std::stringstream list_buffer(argument);
+        std::string item;
+        while (std::getline(list_buffer, item, ','))
+        {
+            T value;
+            if (!parse_value(item, value) || !(value > 0))
+            {
+                return false;
+            }
+            values.push_back(value);
+        }
+        return !values.empty();
+    }
 };
 
 #endif
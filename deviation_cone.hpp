@@ -0,0 +1,194 @@
+#ifndef DEVIATION_CONE_HPP
+#define DEVIATION_CONE_HPP
+
+#include "poly_line.hpp"
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/// Decides which shortcuts of an x-monotone line stay within max_deviation of the
+/// subpath they replace (Chan-Chin cones).
+///
+/// The forward cone of vertex i contains all directions whose ray from i passes within
+/// max_deviation of every vertex after i. The shortcut (i, j) is admissible iff its direction
+/// is in the cone built from the vertices between i and j and no vertex in between lies beyond
+/// j by more than max_deviation (the backward condition). If no vertex in between is farther
+/// from i than j, every vertex projects onto the shortcut and the backward condition holds;
+/// only if the line turns back its vertices are checked directly.
+///
+/// Cones only shrink, so once the forward cone of i is empty no later vertex is admissible.
+/// The cone of a vertex is swept when end() or admissible() first ask for it and is kept
+/// until another vertex is asked for, so only O(n) state is kept for the current fan.
+/// A max_deviation of 0 disables the bound.
+template<typename CoordinateT>
+class basic_deviation_cone
+{
+public:
+    using line_type = basic_poly_line<CoordinateT>;
+
+    basic_deviation_cone(const line_type& in_line, double in_max_deviation)
+    : line(in_line)
+    , max_deviation(in_max_deviation)
+    {
+    }
+
+    bool is_bounded() const
+    {
+        return max_deviation > 0;
+    }
+
+    /// Returns the vertex after the last candidate that can be admissible from i (exclusive).
+    /// The cone is only swept up to limit, which is returned if the cone is not empty before.
+    unsigned end(unsigned i, unsigned limit = std::numeric_limits<unsigned>::max())
+    {
+        const unsigned size = line.coordinates.size();
+        if (!is_bounded())
+        {
+            return size;
+        }
+
+        if (i != fan_first || (!is_closed && fan_end < std::min(limit, size)))
+        {
+            sweep(i, limit);
+        }
+        return std::min(fan_end, limit);
+    }
+
+    /// The edge (i, i+1) is always admissible
+    bool admissible(unsigned i, unsigned j)
+    {
+        if (!is_bounded())
+        {
+            return true;
+        }
+
+        BOOST_ASSERT(i < j);
+        if (i != fan_first || (!is_closed && j >= fan_end))
+        {
+            sweep(i, std::numeric_limits<unsigned>::max());
+        }
+        if (j >= fan_end || !in_cone[j - i - 1])
+        {
+            return false;
+        }
+
+        auto length = dx(i, j) * dx(i, j) + dy(i, j) * dy(i, j);
+        return length >= farthest[j - i - 1] || is_within(i, j);
+    }
+
+private:
+    struct angle_interval
+    {
+        double min = -std::numeric_limits<double>::infinity();
+        double max = std::numeric_limits<double>::infinity();
+        bool is_full = true;
+
+        bool empty() const
+        {
+            return min > max;
+        }
+
+        /// zero length directions are only inside of a full cone
+        bool contains(double dx, double dy) const
+        {
+            if (dx == 0 && dy == 0)
+            {
+                return is_full;
+            }
+            auto angle = std::atan2(dy, dx);
+            return min <= angle && angle <= max;
+        }
+
+        /// restricts the cone to the directions passing within radius of (dx, dy)
+        void restrict(double dx, double dy, double radius)
+        {
+            auto distance = std::sqrt(dx * dx + dy * dy);
+            if (distance <= radius)
+            {
+                return;
+            }
+
+            // the line is x-monotone increasing, so all angles are within [-pi/2, pi/2]
+            auto angle = std::atan2(dy, dx);
+            auto half_width = std::asin(radius / distance);
+            min = std::max(min, angle - half_width);
+            max = std::min(max, angle + half_width);
+            is_full = false;
+        }
+    };
+
+    double dx(unsigned from, unsigned to) const
+    {
+        return static_cast<double>(line.coordinates[to].x) - static_cast<double>(line.coordinates[from].x);
+    }
+
+    double dy(unsigned from, unsigned to) const
+    {
+        return static_cast<double>(line.coordinates[to].y) - static_cast<double>(line.coordinates[from].y);
+    }
+
+    /// Sweeps the forward cone of i until it is empty or reaches limit
+    void sweep(unsigned i, unsigned limit)
+    {
+        const unsigned size = line.coordinates.size();
+        fan_first = i;
+        fan_end = std::min(limit, size);
+        is_closed = false;
+        in_cone.clear();
+        farthest.clear();
+
+        angle_interval cone;
+        double farthest_length = 0;
+        for (auto j = i + 1; j < fan_end; ++j)
+        {
+            in_cone.push_back(cone.contains(dx(i, j), dy(i, j)));
+            farthest.push_back(farthest_length);
+            cone.restrict(dx(i, j), dy(i, j), max_deviation);
+            farthest_length = std::max(farthest_length, dx(i, j) * dx(i, j) + dy(i, j) * dy(i, j));
+            if (cone.empty())
+            {
+                fan_end = j + 1;
+                is_closed = true;
+                break;
+            }
+        }
+        if (fan_end == size)
+        {
+            is_closed = true;
+        }
+    }
+
+    /// Returns true if all vertices between i and j are within max_deviation of the segment
+    bool is_within(unsigned i, unsigned j) const
+    {
+        auto length = dx(i, j) * dx(i, j) + dy(i, j) * dy(i, j);
+        for (auto k = i + 1; k < j; ++k)
+        {
+            auto t = length > 0 ? std::max(0.0, std::min(1.0, (dx(i, k) * dx(i, j) + dy(i, k) * dy(i, j)) / length)) : 0.0;
+            if (std::hypot(dx(i, k) - t * dx(i, j), dy(i, k) - t * dy(i, j)) > max_deviation)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const line_type& line;
+    double max_deviation;
+
+    /// The cone of fan_first, swept up to fan_end (exclusive). is_closed is set if no
+    /// later vertex is admissible.
+    unsigned fan_first = std::numeric_limits<unsigned>::max();
+    unsigned fan_end = 0;
+    bool is_closed = false;
+    /// in_cone[j - fan_first - 1] is true if (fan_first, j) is in the forward cone
+    std::vector<bool> in_cone;
+    /// farthest[j - fan_first - 1] is the largest squared distance of a vertex between fan_first and j
+    std::vector<double> farthest;
+};
+
+#endif
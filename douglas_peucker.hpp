@@ -0,0 +1,159 @@
+#ifndef DOUGLAS_PEUCKER_HPP
+#define DOUGLAS_PEUCKER_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "shortcut.hpp"
+#include "geometry.hpp"
+#include "shortcut_validator.hpp"
+#include "simplification_options.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/// Douglas-Peucker simplification that repairs the topology while it recurses.
+///
+/// The shortcut (i, j) is accepted if all vertices between i and j are within
+/// max_deviation of it (0 means any deviation) and basic_shortcut_validator accepts it,
+/// i.e. no constraint point or vertex of the line is inside of or on the polygon formed by
+/// the subpath and the shortcut. Otherwise the subpath is split at its farthest vertex,
+/// which re-inserts that vertex. Edges of the line are always accepted.
+///
+/// With target_edges the accepted shortcuts are kept in a priority queue by the distance of
+/// their farthest vertex and the farthest one is split until the line has target_edges edges.
+/// The line gets more edges if the tolerance or the topology needs them.
+///
+/// The validity checks are local, but there is no bound on the number of edges and the
+/// worst case is quadratic like Douglas-Peucker itself.
+/// The result is a single path, so it plugs into map_simplification like deberg.
+template<typename PointFilterT>
+class douglas_peucker
+{
+public:
+    using coordinate_type = typename PointFilterT::coordinate_type;
+    using line_type = basic_poly_line<coordinate_type>;
+    using point_type = basic_point<coordinate_type>;
+    using point_filter_type = PointFilterT;
+
+    douglas_peucker(const line_type& in_line, std::vector<point_type>&& in_points,
+                    const simplification_options& options = simplification_options())
+    : line(in_line)
+    , max_deviation(options.max_deviation > 0 ? options.max_deviation : std::numeric_limits<double>::infinity())
+    , target_edges(options.target_edges)
+    {
+        point_locations.reserve(in_points.size());
+        for (const auto& p : in_points)
+        {
+            point_locations.push_back(p.location);
+        }
+    }
+
+    std::vector<shortcut> operator()() const
+    {
+        std::vector<shortcut> shortcuts;
+        if (line.coordinates.size() < 2)
+        {
+            return shortcuts;
+        }
+
+        basic_shortcut_validator<coordinate_type> is_valid(line, point_locations);
+
+        // accepted shortcuts that can still be split, the one with the farthest vertex on top
+        std::priority_queue<accepted_shortcut> accepted;
+        std::vector<std::pair<unsigned, unsigned>> subpaths {{0, line.coordinates.size() - 1}};
+        auto split = [&]()
+        {
+            while (!subpaths.empty())
+            {
+                auto i = subpaths.back().first;
+                auto j = subpaths.back().second;
+                subpaths.pop_back();
+
+                if (j == i + 1)
+                {
+                    shortcuts.emplace_back(i, j);
+                    continue;
+                }
+
+                auto farthest = farthest_vertex(i, j);
+                if (farthest.second <= max_deviation && is_valid(i, j))
+                {
+                    accepted.push(accepted_shortcut {farthest.second, i, j, farthest.first});
+                    continue;
+                }
+
+                subpaths.emplace_back(farthest.first, j);
+                subpaths.emplace_back(i, farthest.first);
+            }
+        };
+
+        split();
+        while (!accepted.empty() && shortcuts.size() + accepted.size() < target_edges)
+        {
+            auto s = accepted.top();
+            accepted.pop();
+            subpaths.emplace_back(s.farthest, s.last);
+            subpaths.emplace_back(s.first, s.farthest);
+            split();
+        }
+
+        for (; !accepted.empty(); accepted.pop())
+        {
+            shortcuts.emplace_back(accepted.top().first, accepted.top().last);
+        }
+        std::sort(shortcuts.begin(), shortcuts.end(),
+                  [](const shortcut& lhs, const shortcut& rhs) { return lhs.first < rhs.first; });
+
+        return shortcuts;
+    }
+
+private:
+    struct accepted_shortcut
+    {
+        double distance;
+        unsigned first;
+        unsigned last;
+        unsigned farthest;
+
+        bool operator<(const accepted_shortcut& other) const
+        {
+            return distance < other.distance;
+        }
+    };
+
+    /// Returns the vertex between i and j with the largest distance to the segment (i, j)
+    std::pair<unsigned, double> farthest_vertex(unsigned i, unsigned j) const
+    {
+        const auto& first = line.coordinates[i];
+        const auto& last = line.coordinates[j];
+        double dx = static_cast<double>(last.x) - static_cast<double>(first.x);
+        double dy = static_cast<double>(last.y) - static_cast<double>(first.y);
+        double length = dx * dx + dy * dy;
+
+        std::pair<unsigned, double> farthest {i + 1, -1};
+        for (auto k = i + 1; k < j; ++k)
+        {
+            double px = static_cast<double>(line.coordinates[k].x) - static_cast<double>(first.x);
+            double py = static_cast<double>(line.coordinates[k].y) - static_cast<double>(first.y);
+            double t = length > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / length)) : 0.0;
+            double distance = std::hypot(px - t * dx, py - t * dy);
+            if (distance > farthest.second)
+            {
+                farthest = std::make_pair(k, distance);
+            }
+        }
+
+        return farthest;
+    }
+
+    const line_type& line;
+    double max_deviation;
+    unsigned target_edges;
+    std::vector<coordinate_type> point_locations;
+};
+
+#endif
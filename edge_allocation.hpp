@@ -0,0 +1,287 @@
+#ifndef EDGE_ALLOCATION_HPP
+#define EDGE_ALLOCATION_HPP
+
+#include "poly_line.hpp"
+#include "shortcut.hpp"
+#include "geometry.hpp"
+#include "util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+/// Level of a multi-resolution simplification, either limited by the largest
+/// deviation of a removed vertex or by the number of edges of all lines
+struct detail_level
+{
+    double max_deviation = std::numeric_limits<double>::infinity();
+    /// Overrides max_deviation if not 0
+    unsigned max_edges = 0;
+};
+
+/// Distributes a global edge budget across the shortcut graphs of all lines.
+///
+/// The error of a shortcut is the largest distance of a vertex it removes, the error of a
+/// simplification the largest error of its shortcuts. Using only the shortcuts with an error
+/// of at most t, every line needs a minimal number of edges that only decreases with t.
+/// The smallest t whose lines fit into the budget is found by a binary search over the
+/// shortcut errors, so no line gets more edges than the others need to match its error
+/// and all lines together minimize the largest error.
+/// The edges (i, i+1) have no error, so every threshold is feasible.
+/// This needs the shortcut graphs of the lines without removed collinear vertices, since a
+/// shortcut that starts or ends inside a straight run can have the smallest error.
+///
+/// The distance to a segment is convex, so the error of a shortcut is taken at a vertex of the
+/// convex hull of the vertices it removes. The shortcuts of a vertex are evaluated by increasing
+/// last vertex while the hull grows, so an error costs O(h) for a hull of h vertices instead of
+/// one pass over all removed vertices. Only lines that are (close to) convex themselves have
+/// hulls with O(n) vertices and still take O(n) per shortcut.
+template<typename CoordinateT>
+class basic_edge_allocation
+{
+public:
+    using line_type = basic_poly_line<CoordinateT>;
+
+    /// The shortcuts of every line need to be sorted like the edges of a static_graph
+    basic_edge_allocation(const std::vector<line_type>& in_lines, const std::vector<std::vector<shortcut>>& in_shortcuts,
+                          unsigned num_threads = 1)
+    : lines(in_lines)
+    , shortcuts(in_shortcuts)
+    , errors(in_shortcuts.size())
+    {
+        util::parallel_for(num_threads, lines.size(),
+            [this](std::size_t i)
+            {
+                errors[i] = shortcut_errors(lines[i], shortcuts[i]);
+            });
+    }
+
+    /// Smallest error threshold whose simplification uses at most max_edges edges.
+    /// Returns infinity if even the simplification with all shortcuts uses more.
+    double threshold(unsigned max_edges) const
+    {
+        std::vector<double> candidates {0};
+        for (const auto& line_errors : errors)
+        {
+            candidates.insert(candidates.end(), line_errors.begin(), line_errors.end());
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        if (edges(candidates.back()) > max_edges)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        std::size_t first = 0;
+        std::size_t last = candidates.size() - 1;
+        while (first < last)
+        {
+            auto middle = first + (last - first) / 2;
+            if (edges(candidates[middle]) <= max_edges)
+            {
+                last = middle;
+            }
+            else
+            {
+                first = middle + 1;
+            }
+        }
+
+        return candidates[first];
+    }
+
+    /// Number of edges all lines need if they only use shortcuts with an error of at most max_error
+    std::size_t edges(double max_error) const
+    {
+        std::size_t num_edges = 0;
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            num_edges += line_edges(i, max_error);
+        }
+        return num_edges;
+    }
+
+    /// Shortcuts of line i with an error of at most max_error
+    std::vector<shortcut> filter(unsigned i, double max_error) const
+    {
+        std::vector<shortcut> filtered;
+        for (auto k = 0u; k < shortcuts[i].size(); ++k)
+        {
+            if (errors[i][k] <= max_error)
+            {
+                filtered.push_back(shortcuts[i][k]);
+            }
+        }
+        return filtered;
+    }
+
+    /// Shortcuts of all lines with an error of at most max_error
+    std::vector<std::vector<shortcut>> filter(double max_error) const
+    {
+        std::vector<std::vector<shortcut>> filtered(lines.size());
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            filtered[i] = filter(i, max_error);
+        }
+        return filtered;
+    }
+
+private:
+    /// Errors of all shortcuts of the line, using the convex hull of the removed vertices of every first vertex
+    static std::vector<double> shortcut_errors(const line_type& line, const std::vector<shortcut>& line_shortcuts)
+    {
+        std::vector<double> line_errors(line_shortcuts.size(), 0);
+        std::vector<unsigned> order(line_shortcuts.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&line_shortcuts](unsigned lhs, unsigned rhs)
+                  {
+                      return line_shortcuts[lhs].first < line_shortcuts[rhs].first
+                          || (line_shortcuts[lhs].first == line_shortcuts[rhs].first
+                              && line_shortcuts[lhs].last < line_shortcuts[rhs].last);
+                  });
+
+        std::vector<CoordinateT> hull;
+        for (auto begin = 0u; begin < order.size();)
+        {
+            const auto first = line_shortcuts[order[begin]].first;
+            hull.clear();
+            auto next = first + 1;
+
+            auto end = begin;
+            for (; end < order.size() && line_shortcuts[order[end]].first == first; ++end)
+            {
+                const auto& s = line_shortcuts[order[end]];
+                for (; next < s.last; ++next)
+                {
+                    add_to_hull(hull, line.coordinates[next]);
+                }
+
+                double error = 0;
+                for (const auto& c : hull)
+                {
+                    error = std::max(error, distance(line.coordinates[s.first], line.coordinates[s.last], c));
+                }
+                line_errors[order[end]] = error;
+            }
+            begin = end;
+        }
+
+        return line_errors;
+    }
+
+    /// Adds c to the counter clockwise convex hull, which may be a single vertex or a segment
+    static void add_to_hull(std::vector<CoordinateT>& hull, const CoordinateT& c)
+    {
+        if (hull.size() < 2)
+        {
+            if (hull.empty() || hull.front() != c)
+            {
+                hull.push_back(c);
+            }
+            return;
+        }
+
+        if (hull.size() == 2)
+        {
+            auto o = geometry::orientation(hull[0], hull[1], c);
+            if (o > 0)
+            {
+                hull.push_back(c);
+            }
+            else if (o < 0)
+            {
+                hull.insert(hull.begin() + 1, c);
+            }
+            // collinear vertices only extend the segment
+            else if (geometry::dot(hull[0], hull[1], c) < 0)
+            {
+                hull[0] = c;
+            }
+            else if (geometry::dot(hull[1], hull[0], c) < 0)
+            {
+                hull[1] = c;
+            }
+            return;
+        }
+
+        // the edges that see c form a chain whose inner vertices are replaced by c
+        const auto size = hull.size();
+        auto is_visible = [&hull, &c, size](std::size_t m)
+        {
+            return geometry::orientation(hull[m], hull[(m + 1) % size], c) < 0;
+        };
+        auto chain_begin = size;
+        for (auto m = 0u; m < size; ++m)
+        {
+            if (is_visible(m) && !is_visible((m + size - 1) % size))
+            {
+                chain_begin = m;
+                break;
+            }
+        }
+        if (chain_begin == size)
+        {
+            // c is inside of the hull
+            return;
+        }
+
+        auto chain_size = 1u;
+        while (chain_size < size && is_visible((chain_begin + chain_size) % size))
+        {
+            ++chain_size;
+        }
+
+        std::vector<CoordinateT> extended {c};
+        for (auto m = chain_begin + chain_size; m <= chain_begin + size; ++m)
+        {
+            extended.push_back(hull[m % size]);
+        }
+        hull.swap(extended);
+    }
+
+    /// Distance of c to the segment from first to last
+    static double distance(const CoordinateT& first, const CoordinateT& last, const CoordinateT& c)
+    {
+        double dx = static_cast<double>(last.x) - static_cast<double>(first.x);
+        double dy = static_cast<double>(last.y) - static_cast<double>(first.y);
+        double length = dx * dx + dy * dy;
+        double px = static_cast<double>(c.x) - static_cast<double>(first.x);
+        double py = static_cast<double>(c.y) - static_cast<double>(first.y);
+        double t = length > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / length)) : 0.0;
+        return std::hypot(px - t * dx, py - t * dy);
+    }
+
+    /// Fewest edges from the first to the last vertex, the shortcuts are ordered by their first vertex
+    unsigned line_edges(unsigned i, double max_error) const
+    {
+        const auto num_nodes = lines[i].coordinates.size();
+        if (num_nodes < 2)
+        {
+            return 0;
+        }
+
+        std::vector<unsigned> distance(num_nodes, std::numeric_limits<unsigned>::max());
+        distance[0] = 0;
+        for (auto k = 0u; k < shortcuts[i].size(); ++k)
+        {
+            const auto& s = shortcuts[i][k];
+            if (errors[i][k] <= max_error && distance[s.first] != std::numeric_limits<unsigned>::max())
+            {
+                distance[s.last] = std::min(distance[s.last], distance[s.first] + 1);
+            }
+        }
+        return distance.back();
+    }
+
+    const std::vector<line_type>& lines;
+    const std::vector<std::vector<shortcut>>& shortcuts;
+    std::vector<std::vector<double>> errors;
+};
+
+using edge_allocation = basic_edge_allocation<coordinate>;
+
+#endif
@@ -0,0 +1,138 @@
+#include "funnel_sweep.hpp"
+
+#include "geometry.hpp"
+
+#include <algorithm>
+#include <boost/assert.hpp>
+
+template<typename CoordinateT>
+basic_funnel_sweep<CoordinateT>::basic_funnel_sweep(const basic_poly_line<CoordinateT>& original_line,
+                                                    const std::vector<basic_point<CoordinateT>>& in_points)
+    : line(original_line)
+{
+    const auto& coordinates = line.coordinates;
+    points.reserve(in_points.size());
+    for (const auto& p : in_points)
+    {
+        // only points strictly inside the x-range of the line can be inside of a polygon
+        if (p.location.x > coordinates.front().x && p.location.x < coordinates.back().x)
+        {
+            points.push_back(classified_point {p.location, classify(p.location)});
+        }
+    }
+
+    std::sort(points.begin(), points.end(),
+              [](const classified_point& lhs, const classified_point& rhs) { return lhs.location.x < rhs.location.x; });
+}
+
+/// Compares the point to the vertices with the same x-coordinate (vertical edges)
+/// or to the edge that spans its x-coordinate.
+template<typename CoordinateT>
+typename basic_funnel_sweep<CoordinateT>::side basic_funnel_sweep<CoordinateT>::classify(const CoordinateT& location) const
+{
+    const auto& coordinates = line.coordinates;
+    auto first = std::lower_bound(coordinates.begin(), coordinates.end(), location,
+                                  [](const CoordinateT& lhs, const CoordinateT& rhs) { return lhs.x < rhs.x; });
+    BOOST_ASSERT(first != coordinates.begin() && first != coordinates.end());
+
+    if (first->x == location.x)
+    {
+        auto min_y = first->y;
+        auto max_y = first->y;
+        for (auto iter = first; iter != coordinates.end() && iter->x == location.x; ++iter)
+        {
+            min_y = std::min(min_y, iter->y);
+            max_y = std::max(max_y, iter->y);
+        }
+
+        if (location.y > max_y)
+        {
+            return side::ABOVE;
+        }
+        else if (location.y < min_y)
+        {
+            return side::BELOW;
+        }
+        return side::ON;
+    }
+
+    auto o = geometry::orientation(*(first - 1), *first, location);
+    if (o > 0)
+    {
+        return side::ABOVE;
+    }
+    else if (o < 0)
+    {
+        return side::BELOW;
+    }
+    return side::ON;
+}
+
+/// Note the returned shortcuts always contain the edge (i, i+1).
+template<typename CoordinateT>
+std::vector<shortcut> basic_funnel_sweep<CoordinateT>::operator()(unsigned i, unsigned end) const
+{
+    BOOST_ASSERT(end <= line.coordinates.size());
+    std::vector<shortcut> valid_shortcuts;
+
+    const auto& origin = line.coordinates[i];
+    auto point_iter = std::upper_bound(points.begin(), points.end(), origin.x,
+                                       [](decltype(origin.x) x, const classified_point& p) { return x < p.location.x; });
+
+    // the most clockwise point above and the most counter-clockwise point below the line
+    const CoordinateT* upper = nullptr;
+    const CoordinateT* lower = nullptr;
+    bool blocked = false;
+
+    for (auto j = i + 1; j < end; ++j)
+    {
+        const auto& target = line.coordinates[j];
+        for (; point_iter != points.end() && point_iter->location.x < target.x; ++point_iter)
+        {
+            const auto& location = point_iter->location;
+            if (point_iter->position == side::ON)
+            {
+                blocked = true;
+            }
+            else if (point_iter->position == side::ABOVE)
+            {
+                if (upper == nullptr || geometry::orientation(origin, *upper, location) < 0)
+                {
+                    upper = &location;
+                }
+            }
+            else
+            {
+                if (lower == nullptr || geometry::orientation(origin, *lower, location) > 0)
+                {
+                    lower = &location;
+                }
+            }
+        }
+
+        if (j == i + 1)
+        {
+            valid_shortcuts.emplace_back(i, j);
+            continue;
+        }
+
+        // the funnel is closed for all later vertices
+        if (blocked || (upper != nullptr && lower != nullptr && geometry::orientation(origin, *lower, *upper) <= 0))
+        {
+            break;
+        }
+
+        if ((upper == nullptr || geometry::orientation(origin, target, *upper) > 0) &&
+            (lower == nullptr || geometry::orientation(origin, target, *lower) < 0))
+        {
+            valid_shortcuts.emplace_back(i, j);
+        }
+    }
+
+    return valid_shortcuts;
+}
+
+template class basic_funnel_sweep<coordinate>;
+template class basic_funnel_sweep<local_coordinate>;
+template class basic_funnel_sweep<quantized_coordinate>;
+template class basic_funnel_sweep<compact_quantized_coordinate>;
@@ -0,0 +1,58 @@
+#ifndef FUNNEL_SWEEP_HPP
+#define FUNNEL_SWEEP_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "shortcut.hpp"
+
+#include <vector>
+
+/**
+ * Finds the valid shortcuts of an x-monotone increasing line without sorting.
+ *
+ * The polygon between the line and a shortcut (i, j) lies within the x-range of i and j
+ * and every vertical line crosses it once. A point in this range is inside iff it is on
+ * different sides of the line and the shortcut. So every point is classified once as above,
+ * below or on the line. Sweeping j to the right, the shortcut (i, j) must pass below the
+ * most clockwise point above the line and above the most counter-clockwise point below
+ * it. These two points form a funnel that only narrows, so the sweep stops once it is
+ * closed. Points on the line block all shortcuts that pass them.
+ */
+template<typename CoordinateT>
+class basic_funnel_sweep
+{
+public:
+    basic_funnel_sweep(const basic_poly_line<CoordinateT>& original_line, const std::vector<basic_point<CoordinateT>>& points);
+
+    std::vector<shortcut> operator()(unsigned i) const
+    {
+        return (*this)(i, line.coordinates.size());
+    }
+
+    /// Only considers shortcuts from i to vertices before end
+    std::vector<shortcut> operator()(unsigned i, unsigned end) const;
+
+private:
+    enum class side : char
+    {
+        BELOW,
+        ON,
+        ABOVE
+    };
+
+    struct classified_point
+    {
+        CoordinateT location;
+        side position;
+    };
+
+    side classify(const CoordinateT& location) const;
+
+    const basic_poly_line<CoordinateT>& line;
+    /// ordered by x
+    std::vector<classified_point> points;
+};
+
+using funnel_sweep = basic_funnel_sweep<coordinate>;
+
+#endif
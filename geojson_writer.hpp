@@ -0,0 +1,118 @@
+#ifndef GEOJSON_WRITER_HPP
+#define GEOJSON_WRITER_HPP
+
+#include "poly_line.hpp"
+#include "quantizer.hpp"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+/// Writes lines as a GeoJSON FeatureCollection, one feature at a time.
+///
+/// Like utils/lines_to_geojson.py the coordinates are converted from World Mercator (EPSG:54004)
+/// to longitude and latitude and every feature has the line id as property. The collection is
+/// closed by finish() or the destructor.
+class geojson_writer
+{
+public:
+    /// Writes the input coordinates unchanged if convert_to_wgs84 is not set
+    geojson_writer(std::ostream& output, bool convert_to_wgs84 = true)
+        : output(output)
+        , convert_to_wgs84(convert_to_wgs84)
+    {
+        output << "{\"type\":\"FeatureCollection\",\"features\":[";
+    }
+
+    ~geojson_writer()
+    {
+        finish();
+    }
+
+    geojson_writer(const geojson_writer&) = delete;
+    geojson_writer& operator=(const geojson_writer&) = delete;
+
+    void write(const std::vector<poly_line>& lines)
+    {
+        for (const auto& l : lines)
+        {
+            write_line(l);
+        }
+    }
+
+    /// Writes lines with quantized coordinates in their original coordinate system
+    template<typename QuantizedCoordinateT>
+    void write(const std::vector<basic_poly_line<QuantizedCoordinateT>>& lines,
+               const basic_quantizer<QuantizedCoordinateT>& quantizer)
+    {
+        for (const auto& l : lines)
+        {
+            write_line(quantizer.dequantize(l));
+        }
+    }
+
+    void write_line(const poly_line& line)
+    {
+        output << (num_features++ > 0 ? ",\n" : "\n")
+               << "{\"type\":\"Feature\",\"properties\":{\"id\":" << line.id << "},"
+               << "\"geometry\":{\"type\":\"LineString\",\"coordinates\":[";
+        output << std::setprecision(convert_to_wgs84 ? 10 : 9);
+        for (auto k = 0u; k < line.coordinates.size(); ++k)
+        {
+            auto c = convert_to_wgs84 ? to_wgs84(line.coordinates[k]) : line.coordinates[k];
+            output << (k > 0 ? "," : "") << "[" << c.x << "," << c.y << "]";
+        }
+        output << "]}}";
+
+        if (!output)
+        {
+            throw std::runtime_error("Could not write line " + std::to_string(line.id) + ".");
+        }
+    }
+
+    /// Closes the feature collection, nothing can be written afterwards
+    void finish()
+    {
+        if (!finished)
+        {
+            output << "\n]}" << std::endl;
+            finished = true;
+        }
+    }
+
+    /// Longitude and latitude in degrees of World Mercator coordinates on the WGS84 ellipsoid
+    static coordinate to_wgs84(const coordinate& c)
+    {
+        const double pi = std::acos(-1.0);
+        const double a = 6378137.0;
+        const double f = 1 / 298.257223563;
+        const double e = std::sqrt(f * (2 - f));
+
+        // the conformal latitude converges to the geodetic one in a few iterations
+        double t = std::exp(-c.y / a);
+        double latitude = pi / 2 - 2 * std::atan(t);
+        for (auto i = 0; i < 10; ++i)
+        {
+            double e_sin = e * std::sin(latitude);
+            double next = pi / 2 - 2 * std::atan(t * std::pow((1 - e_sin) / (1 + e_sin), e / 2));
+            if (std::abs(next - latitude) < 1e-12)
+            {
+                latitude = next;
+                break;
+            }
+            latitude = next;
+        }
+
+        return coordinate {c.x / a * 180 / pi, latitude * 180 / pi};
+    }
+
+private:
+    std::ostream& output;
+    bool convert_to_wgs84;
+    unsigned num_features = 0;
+    bool finished = false;
+};
+
+#endif
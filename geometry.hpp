@@ -36,7 +36,8 @@ namespace geometry
     }
 
     /// Transforms the path from the goven monoticity to be x-monotone-increasing
-    inline void make_x_monotone_increasing(monoticity mono, std::vector<coordinate>& path)
+    template<typename CoordinateT>
+    inline void make_x_monotone_increasing(monoticity mono, std::vector<CoordinateT>& path)
     {
         BOOST_ASSERT(mono != monoticity::INVALID);
 
@@ -66,7 +67,7 @@ namespace geometry
 
         // at this point we are always x-monotone descreasing: Mirror on y-Axis
         std::transform(path.begin(), path.end(), path.begin(),
-                       [](coordinate c)
+                       [](CoordinateT c)
                        {
                             c.x *= -1;
                             return c;
@@ -77,16 +78,48 @@ namespace geometry
     /// first_line_point and second_line_point.
     ///
     /// This vector is not normalized!
-    inline coordinate line_normal(const coordinate& first_line_point,
-                                  const coordinate& second_line_point)
+    template<typename CoordinateT>
+    inline CoordinateT line_normal(const CoordinateT& first_line_point,
+                                   const CoordinateT& second_line_point)
     {
-        return coordinate {-second_line_point.y + first_line_point.y,
-                            second_line_point.x - first_line_point.x};
+        return CoordinateT {-second_line_point.y + first_line_point.y,
+                             second_line_point.x - first_line_point.x};
     }
 
-    inline coordinate::value_type cross(const coordinate& a, const coordinate& b)
+    template<typename CoordinateT>
+    inline typename coordinate_traits<CoordinateT>::wide_type cross(const CoordinateT& a, const CoordinateT& b)
     {
-        return a.x * b.y - a.y * b.x;
+        using wide_type = typename coordinate_traits<CoordinateT>::wide_type;
+        return static_cast<wide_type>(a.x) * static_cast<wide_type>(b.y)
+             - static_cast<wide_type>(a.y) * static_cast<wide_type>(b.x);
+    }
+
+    /// Computes cross(second - origin, third - origin) without overflowing
+    /// for integer coordinates.
+    template<typename CoordinateT>
+    inline typename coordinate_traits<CoordinateT>::wide_type orientation(const CoordinateT& origin,
+                                                                          const CoordinateT& second,
+                                                                          const CoordinateT& third)
+    {
+        using wide_type = typename coordinate_traits<CoordinateT>::wide_type;
+        return (static_cast<wide_type>(second.x) - static_cast<wide_type>(origin.x))
+             * (static_cast<wide_type>(third.y)  - static_cast<wide_type>(origin.y))
+             - (static_cast<wide_type>(second.y) - static_cast<wide_type>(origin.y))
+             * (static_cast<wide_type>(third.x)  - static_cast<wide_type>(origin.x));
+    }
+
+    /// Computes dot(second - origin, third - origin) without overflowing
+    /// for integer coordinates.
+    template<typename CoordinateT>
+    inline typename coordinate_traits<CoordinateT>::wide_type dot(const CoordinateT& origin,
+                                                                  const CoordinateT& second,
+                                                                  const CoordinateT& third)
+    {
+        using wide_type = typename coordinate_traits<CoordinateT>::wide_type;
+        return (static_cast<wide_type>(second.x) - static_cast<wide_type>(origin.x))
+             * (static_cast<wide_type>(third.x)  - static_cast<wide_type>(origin.x))
+             + (static_cast<wide_type>(second.y) - static_cast<wide_type>(origin.y))
+             * (static_cast<wide_type>(third.y)  - static_cast<wide_type>(origin.y));
     }
 
     struct intersection_params
@@ -96,14 +129,22 @@ namespace geometry
         bool colinear;
     };
 
+    template<typename CoordinateT>
     inline intersection_params segment_intersection(
-            const coordinate& first_segment_a, const coordinate& first_segment_b,
-            const coordinate& second_segment_a, const coordinate& second_segment_b)
+            const CoordinateT& first_segment_a, const CoordinateT& first_segment_b,
+            const CoordinateT& second_segment_a, const CoordinateT& second_segment_b)
     {
+        using wide_type = typename coordinate_traits<CoordinateT>::wide_type;
+
         intersection_params params {0, 0, false};
-        const coordinate first_delta = first_segment_b - first_segment_a;
-        const coordinate second_delta = second_segment_b - second_segment_a;
-        auto direction_cross = cross(first_delta, second_delta);
+        const wide_type first_delta_x  = static_cast<wide_type>(first_segment_b.x)  - static_cast<wide_type>(first_segment_a.x);
+        const wide_type first_delta_y  = static_cast<wide_type>(first_segment_b.y)  - static_cast<wide_type>(first_segment_a.y);
+        const wide_type second_delta_x = static_cast<wide_type>(second_segment_b.x) - static_cast<wide_type>(second_segment_a.x);
+        const wide_type second_delta_y = static_cast<wide_type>(second_segment_b.y) - static_cast<wide_type>(second_segment_a.y);
+        const wide_type start_delta_x  = static_cast<wide_type>(second_segment_a.x) - static_cast<wide_type>(first_segment_a.x);
+        const wide_type start_delta_y  = static_cast<wide_type>(second_segment_a.y) - static_cast<wide_type>(first_segment_a.y);
+
+        auto direction_cross = first_delta_x * second_delta_y - first_delta_y * second_delta_x;
         // colinear
         if (direction_cross == 0)
         {
@@ -111,15 +152,18 @@ namespace geometry
         }
         else
         {
-            params.first_param  = cross((second_segment_a - first_segment_a), second_delta) / direction_cross;
-            params.second_param = cross((second_segment_a - first_segment_a), first_delta) / direction_cross;
+            params.first_param  = static_cast<double>(start_delta_x * second_delta_y - start_delta_y * second_delta_x)
+                                / static_cast<double>(direction_cross);
+            params.second_param = static_cast<double>(start_delta_x * first_delta_y - start_delta_y * first_delta_x)
+                                / static_cast<double>(direction_cross);
         }
 
         return params;
     }
 
-    inline bool segments_intersect(const coordinate& first_segment_a, const coordinate& first_segment_b,
-                                   const coordinate& second_segment_a, const coordinate& second_segment_b)
+    template<typename CoordinateT>
+    inline bool segments_intersect(const CoordinateT& first_segment_a, const CoordinateT& first_segment_b,
+                                   const CoordinateT& second_segment_a, const CoordinateT& second_segment_b)
     {
         auto params = segment_intersection(first_segment_a, first_segment_b, second_segment_a, second_segment_b);
         auto u = params.first_param;
@@ -132,12 +176,12 @@ namespace geometry
         return (u >= 0 && u <= 1.0) && (t >= 0 && t <= 1.0);
     }
 
-    inline point_position position_to_line(const coordinate& first_line_point,
-                                    const coordinate& second_line_point,
-                                    const coordinate& point)
+    template<typename CoordinateT>
+    inline point_position position_to_line(const CoordinateT& first_line_point,
+                                    const CoordinateT& second_line_point,
+                                    const CoordinateT& point)
     {
-        auto delta = point - first_line_point;
-        auto p = glm::dot(line_normal(first_line_point, second_line_point), delta);
+        auto p = orientation(first_line_point, second_line_point, point);
 
         if (p > 0)
             return point_position::LEFT_OF_LINE;
@@ -170,7 +214,8 @@ namespace geometry
 
     /// compares the slope of origin -> lhs and origin -> rhs and returns true
     /// if the slope of lhs is bigger than rhs.
-    inline bool slope_compare(const coordinate& origin, const coordinate& lhs, const coordinate& rhs)
+    template<typename CoordinateT>
+    inline bool slope_compare(const CoordinateT& origin, const CoordinateT& lhs, const CoordinateT& rhs)
     {
         BOOST_ASSERT(lhs.x >= origin.x);
         BOOST_ASSERT(rhs.x >= origin.x);
@@ -180,7 +225,7 @@ namespace geometry
         return position == point_position::RIGHT_OF_LINE ||
               (position == point_position::ON_LINE &&
                // origin -> rhs points in opposite direction
-               glm::dot(lhs - origin, rhs - origin) < 0);
+               dot(origin, lhs, rhs) < 0);
     }
 };
 #endif
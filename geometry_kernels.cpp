@@ -0,0 +1,457 @@
+#include "geometry_kernels.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DEBERG_HAS_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace geometry_kernels
+{
+
+bool uses_avx2()
+{
+#ifdef DEBERG_HAS_AVX2_KERNELS
+    static const bool has_avx2 = __builtin_cpu_supports("avx2");
+    return has_avx2;
+#else
+    return false;
+#endif
+}
+
+namespace detail
+{
+
+namespace
+{
+
+// The float versions widen every value to double first, which is what geometry.hpp does
+// for local_coordinate, so all versions evaluate the same double precision operations.
+
+template<typename ValueT>
+void orientation_signs_generic(double origin_x, double origin_y,
+                               const ValueT* second_x, const ValueT* second_y,
+                               const ValueT* third_x, const ValueT* third_y,
+                               std::size_t n, signed char* signs)
+{
+    for (auto k = 0u; k < n; ++k)
+    {
+        double o = (static_cast<double>(second_x[k]) - origin_x) * (static_cast<double>(third_y[k]) - origin_y)
+                 - (static_cast<double>(second_y[k]) - origin_y) * (static_cast<double>(third_x[k]) - origin_x);
+        signs[k] = o > 0 ? 1 : (o < 0 ? -1 : 0);
+    }
+}
+
+template<typename ValueT>
+void bounding_box_mask_generic(ValueT min_x, ValueT min_y, ValueT max_x, ValueT max_y,
+                               const ValueT* x, const ValueT* y,
+                               std::size_t n, unsigned char* inside)
+{
+    for (auto k = 0u; k < n; ++k)
+    {
+        inside[k] = x[k] > min_x && y[k] > min_y && x[k] < max_x && y[k] < max_y;
+    }
+}
+
+template<typename ValueT>
+void segments_intersect_mask_generic(double first_x, double first_y, double second_x, double second_y,
+                                     const ValueT* begin_x, const ValueT* begin_y,
+                                     const ValueT* end_x, const ValueT* end_y,
+                                     std::size_t n, unsigned char* intersects)
+{
+    const double query_delta_x = second_x - first_x;
+    const double query_delta_y = second_y - first_y;
+    for (auto k = 0u; k < n; ++k)
+    {
+        const double edge_delta_x = static_cast<double>(end_x[k]) - static_cast<double>(begin_x[k]);
+        const double edge_delta_y = static_cast<double>(end_y[k]) - static_cast<double>(begin_y[k]);
+        const double start_delta_x = first_x - static_cast<double>(begin_x[k]);
+        const double start_delta_y = first_y - static_cast<double>(begin_y[k]);
+
+        const double direction_cross = edge_delta_x * query_delta_y - edge_delta_y * query_delta_x;
+        if (direction_cross == 0)
+        {
+            intersects[k] = 0;
+            continue;
+        }
+
+        const double u = (start_delta_x * query_delta_y - start_delta_y * query_delta_x) / direction_cross;
+        const double t = (start_delta_x * edge_delta_y - start_delta_y * edge_delta_x) / direction_cross;
+        intersects[k] = (u >= 0 && u <= 1.0) && (t >= 0 && t <= 1.0);
+    }
+}
+
+#ifdef DEBERG_HAS_AVX2_KERNELS
+
+// Note: Only avx2 is enabled (not fma) so no multiply-add contraction can happen,
+// the results are bit-identical to the scalar versions.
+
+__attribute__((target("avx2")))
+inline __m256d load4(const double* values)
+{
+    return _mm256_loadu_pd(values);
+}
+
+__attribute__((target("avx2")))
+inline __m256d load4(const float* values)
+{
+    return _mm256_cvtps_pd(_mm_loadu_ps(values));
+}
+
+template<typename ValueT>
+__attribute__((target("avx2")))
+void orientation_signs_avx2_generic(double origin_x, double origin_y,
+                                    const ValueT* second_x, const ValueT* second_y,
+                                    const ValueT* third_x, const ValueT* third_y,
+                                    std::size_t n, signed char* signs)
+{
+    const __m256d ox = _mm256_set1_pd(origin_x);
+    const __m256d oy = _mm256_set1_pd(origin_y);
+    const __m256d zero = _mm256_setzero_pd();
+
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d sx = _mm256_sub_pd(load4(second_x + k), ox);
+        __m256d sy = _mm256_sub_pd(load4(second_y + k), oy);
+        __m256d tx = _mm256_sub_pd(load4(third_x + k), ox);
+        __m256d ty = _mm256_sub_pd(load4(third_y + k), oy);
+        __m256d o = _mm256_sub_pd(_mm256_mul_pd(sx, ty), _mm256_mul_pd(sy, tx));
+
+        int left = _mm256_movemask_pd(_mm256_cmp_pd(o, zero, _CMP_GT_OQ));
+        int right = _mm256_movemask_pd(_mm256_cmp_pd(o, zero, _CMP_LT_OQ));
+        for (auto lane = 0u; lane < 4; ++lane)
+        {
+            signs[k + lane] = ((left >> lane) & 1) ? 1 : (((right >> lane) & 1) ? -1 : 0);
+        }
+    }
+
+    orientation_signs_generic(origin_x, origin_y, second_x + k, second_y + k, third_x + k, third_y + k, n - k, signs + k);
+}
+
+template<typename ValueT>
+__attribute__((target("avx2")))
+void segments_intersect_mask_avx2_generic(double first_x, double first_y, double second_x, double second_y,
+                                          const ValueT* begin_x, const ValueT* begin_y,
+                                          const ValueT* end_x, const ValueT* end_y,
+                                          std::size_t n, unsigned char* intersects)
+{
+    const __m256d fx = _mm256_set1_pd(first_x);
+    const __m256d fy = _mm256_set1_pd(first_y);
+    const __m256d qx = _mm256_set1_pd(second_x - first_x);
+    const __m256d qy = _mm256_set1_pd(second_y - first_y);
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1.0);
+
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d bx = load4(begin_x + k);
+        __m256d by = load4(begin_y + k);
+        __m256d ex = _mm256_sub_pd(load4(end_x + k), bx);
+        __m256d ey = _mm256_sub_pd(load4(end_y + k), by);
+        __m256d sx = _mm256_sub_pd(fx, bx);
+        __m256d sy = _mm256_sub_pd(fy, by);
+
+        __m256d direction_cross = _mm256_sub_pd(_mm256_mul_pd(ex, qy), _mm256_mul_pd(ey, qx));
+        __m256d u = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(sx, qy), _mm256_mul_pd(sy, qx)), direction_cross);
+        __m256d t = _mm256_div_pd(_mm256_sub_pd(_mm256_mul_pd(sx, ey), _mm256_mul_pd(sy, ex)), direction_cross);
+
+        // NaN/inf lanes from a zero cross product are masked out by the first compare
+        __m256d mask = _mm256_and_pd(_mm256_cmp_pd(direction_cross, zero, _CMP_NEQ_OQ),
+                       _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(u, zero, _CMP_GE_OQ), _mm256_cmp_pd(u, one, _CMP_LE_OQ)),
+                                     _mm256_and_pd(_mm256_cmp_pd(t, zero, _CMP_GE_OQ), _mm256_cmp_pd(t, one, _CMP_LE_OQ))));
+        int bits = _mm256_movemask_pd(mask);
+        for (auto lane = 0u; lane < 4; ++lane)
+        {
+            intersects[k + lane] = (bits >> lane) & 1;
+        }
+    }
+
+    segments_intersect_mask_generic(first_x, first_y, second_x, second_y,
+                                    begin_x + k, begin_y + k, end_x + k, end_y + k, n - k, intersects + k);
+}
+
+#endif
+
+}
+
+void orientation_signs_scalar(double origin_x, double origin_y,
+                              const double* second_x, const double* second_y,
+                              const double* third_x, const double* third_y,
+                              std::size_t n, signed char* signs)
+{
+    orientation_signs_generic(origin_x, origin_y, second_x, second_y, third_x, third_y, n, signs);
+}
+
+void orientation_signs_scalar(double origin_x, double origin_y,
+                              const float* second_x, const float* second_y,
+                              const float* third_x, const float* third_y,
+                              std::size_t n, signed char* signs)
+{
+    orientation_signs_generic(origin_x, origin_y, second_x, second_y, third_x, third_y, n, signs);
+}
+
+void bounding_box_mask_scalar(double min_x, double min_y, double max_x, double max_y,
+                              const double* x, const double* y,
+                              std::size_t n, unsigned char* inside)
+{
+    bounding_box_mask_generic(min_x, min_y, max_x, max_y, x, y, n, inside);
+}
+
+void bounding_box_mask_scalar(float min_x, float min_y, float max_x, float max_y,
+                              const float* x, const float* y,
+                              std::size_t n, unsigned char* inside)
+{
+    bounding_box_mask_generic(min_x, min_y, max_x, max_y, x, y, n, inside);
+}
+
+void segments_intersect_mask_scalar(double first_x, double first_y, double second_x, double second_y,
+                                    const double* begin_x, const double* begin_y,
+                                    const double* end_x, const double* end_y,
+                                    std::size_t n, unsigned char* intersects)
+{
+    segments_intersect_mask_generic(first_x, first_y, second_x, second_y, begin_x, begin_y, end_x, end_y, n, intersects);
+}
+
+void segments_intersect_mask_scalar(double first_x, double first_y, double second_x, double second_y,
+                                    const float* begin_x, const float* begin_y,
+                                    const float* end_x, const float* end_y,
+                                    std::size_t n, unsigned char* intersects)
+{
+    segments_intersect_mask_generic(first_x, first_y, second_x, second_y, begin_x, begin_y, end_x, end_y, n, intersects);
+}
+
+#ifdef DEBERG_HAS_AVX2_KERNELS
+
+void orientation_signs_avx2(double origin_x, double origin_y,
+                            const double* second_x, const double* second_y,
+                            const double* third_x, const double* third_y,
+                            std::size_t n, signed char* signs)
+{
+    orientation_signs_avx2_generic(origin_x, origin_y, second_x, second_y, third_x, third_y, n, signs);
+}
+
+void orientation_signs_avx2(double origin_x, double origin_y,
+                            const float* second_x, const float* second_y,
+                            const float* third_x, const float* third_y,
+                            std::size_t n, signed char* signs)
+{
+    orientation_signs_avx2_generic(origin_x, origin_y, second_x, second_y, third_x, third_y, n, signs);
+}
+
+__attribute__((target("avx2")))
+void bounding_box_mask_avx2(double min_x, double min_y, double max_x, double max_y,
+                            const double* x, const double* y,
+                            std::size_t n, unsigned char* inside)
+{
+    const __m256d lower_x = _mm256_set1_pd(min_x);
+    const __m256d lower_y = _mm256_set1_pd(min_y);
+    const __m256d upper_x = _mm256_set1_pd(max_x);
+    const __m256d upper_y = _mm256_set1_pd(max_y);
+
+    std::size_t k = 0;
+    for (; k + 4 <= n; k += 4)
+    {
+        __m256d vx = _mm256_loadu_pd(x + k);
+        __m256d vy = _mm256_loadu_pd(y + k);
+        __m256d mask = _mm256_and_pd(_mm256_and_pd(_mm256_cmp_pd(vx, lower_x, _CMP_GT_OQ),
+                                                   _mm256_cmp_pd(vy, lower_y, _CMP_GT_OQ)),
+                                     _mm256_and_pd(_mm256_cmp_pd(vx, upper_x, _CMP_LT_OQ),
+                                                   _mm256_cmp_pd(vy, upper_y, _CMP_LT_OQ)));
+        int bits = _mm256_movemask_pd(mask);
+        for (auto lane = 0u; lane < 4; ++lane)
+        {
+            inside[k + lane] = (bits >> lane) & 1;
+        }
+    }
+
+    bounding_box_mask_generic(min_x, min_y, max_x, max_y, x + k, y + k, n - k, inside + k);
+}
+
+// comparisons need no widening, so 8 floats are tested at once
+__attribute__((target("avx2")))
+void bounding_box_mask_avx2(float min_x, float min_y, float max_x, float max_y,
+                            const float* x, const float* y,
+                            std::size_t n, unsigned char* inside)
+{
+    const __m256 lower_x = _mm256_set1_ps(min_x);
+    const __m256 lower_y = _mm256_set1_ps(min_y);
+    const __m256 upper_x = _mm256_set1_ps(max_x);
+    const __m256 upper_y = _mm256_set1_ps(max_y);
+
+    std::size_t k = 0;
+    for (; k + 8 <= n; k += 8)
+    {
+        __m256 vx = _mm256_loadu_ps(x + k);
+        __m256 vy = _mm256_loadu_ps(y + k);
+        __m256 mask = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(vx, lower_x, _CMP_GT_OQ),
+                                                  _mm256_cmp_ps(vy, lower_y, _CMP_GT_OQ)),
+                                    _mm256_and_ps(_mm256_cmp_ps(vx, upper_x, _CMP_LT_OQ),
+                                                  _mm256_cmp_ps(vy, upper_y, _CMP_LT_OQ)));
+        int bits = _mm256_movemask_ps(mask);
+        for (auto lane = 0u; lane < 8; ++lane)
+        {
+            inside[k + lane] = (bits >> lane) & 1;
+        }
+    }
+
+    bounding_box_mask_generic(min_x, min_y, max_x, max_y, x + k, y + k, n - k, inside + k);
+}
+
+void segments_intersect_mask_avx2(double first_x, double first_y, double second_x, double second_y,
+                                  const double* begin_x, const double* begin_y,
+                                  const double* end_x, const double* end_y,
+                                  std::size_t n, unsigned char* intersects)
+{
+    segments_intersect_mask_avx2_generic(first_x, first_y, second_x, second_y, begin_x, begin_y, end_x, end_y, n, intersects);
+}
+
+void segments_intersect_mask_avx2(double first_x, double first_y, double second_x, double second_y,
+                                  const float* begin_x, const float* begin_y,
+                                  const float* end_x, const float* end_y,
+                                  std::size_t n, unsigned char* intersects)
+{
+    segments_intersect_mask_avx2_generic(first_x, first_y, second_x, second_y, begin_x, begin_y, end_x, end_y, n, intersects);
+}
+
+#else
+
+void orientation_signs_avx2(double origin_x, double origin_y,
+                            const double* second_x, const double* second_y,
+                            const double* third_x, const double* third_y,
+                            std::size_t n, signed char* signs)
+{
+    orientation_signs_generic(origin_x, origin_y, second_x, second_y, third_x, third_y, n, signs);
+}
+
+void orientation_signs_avx2(double origin_x, double origin_y,
+                            const float* second_x, const float* second_y,
+                            const float* third_x, const float* third_y,
+                            std::size_t n, signed char* signs)
+{
+    orientation_signs_generic(origin_x, origin_y, second_x, second_y, third_x, third_y, n, signs);
+}
+
+void bounding_box_mask_avx2(double min_x, double min_y, double max_x, double max_y,
+                            const double* x, const double* y,
+                            std::size_t n, unsigned char* inside)
+{
+    bounding_box_mask_generic(min_x, min_y, max_x, max_y, x, y, n, inside);
+}
+
+void bounding_box_mask_avx2(float min_x, float min_y, float max_x, float max_y,
+                            const float* x, const float* y,
+                            std::size_t n, unsigned char* inside)
+{
+    bounding_box_mask_generic(min_x, min_y, max_x, max_y, x, y, n, inside);
+}
+
+void segments_intersect_mask_avx2(double first_x, double first_y, double second_x, double second_y,
+                                  const double* begin_x, const double* begin_y,
+                                  const double* end_x, const double* end_y,
+                                  std::size_t n, unsigned char* intersects)
+{
+    segments_intersect_mask_generic(first_x, first_y, second_x, second_y, begin_x, begin_y, end_x, end_y, n, intersects);
+}
+
+void segments_intersect_mask_avx2(double first_x, double first_y, double second_x, double second_y,
+                                  const float* begin_x, const float* begin_y,
+                                  const float* end_x, const float* end_y,
+                                  std::size_t n, unsigned char* intersects)
+{
+    segments_intersect_mask_generic(first_x, first_y, second_x, second_y, begin_x, begin_y, end_x, end_y, n, intersects);
+}
+
+#endif
+
+}
+
+void orientation_signs(const coordinate& origin,
+                       const double* second_x, const double* second_y,
+                       const double* third_x, const double* third_y,
+                       std::size_t n, signed char* signs)
+{
+    if (uses_avx2())
+    {
+        detail::orientation_signs_avx2(origin.x, origin.y, second_x, second_y, third_x, third_y, n, signs);
+    }
+    else
+    {
+        detail::orientation_signs_scalar(origin.x, origin.y, second_x, second_y, third_x, third_y, n, signs);
+    }
+}
+
+void bounding_box_mask(const coordinate& min, const coordinate& max,
+                       const double* x, const double* y,
+                       std::size_t n, unsigned char* inside)
+{
+    if (uses_avx2())
+    {
+        detail::bounding_box_mask_avx2(min.x, min.y, max.x, max.y, x, y, n, inside);
+    }
+    else
+    {
+        detail::bounding_box_mask_scalar(min.x, min.y, max.x, max.y, x, y, n, inside);
+    }
+}
+
+void segments_intersect_mask(const coordinate& first, const coordinate& second,
+                             const double* begin_x, const double* begin_y,
+                             const double* end_x, const double* end_y,
+                             std::size_t n, unsigned char* intersects)
+{
+    if (uses_avx2())
+    {
+        detail::segments_intersect_mask_avx2(first.x, first.y, second.x, second.y, begin_x, begin_y, end_x, end_y, n, intersects);
+    }
+    else
+    {
+        detail::segments_intersect_mask_scalar(first.x, first.y, second.x, second.y, begin_x, begin_y, end_x, end_y, n, intersects);
+    }
+}
+
+void orientation_signs(const local_coordinate& origin,
+                       const float* second_x, const float* second_y,
+                       const float* third_x, const float* third_y,
+                       std::size_t n, signed char* signs)
+{
+    if (uses_avx2())
+    {
+        detail::orientation_signs_avx2(origin.x, origin.y, second_x, second_y, third_x, third_y, n, signs);
+    }
+    else
+    {
+        detail::orientation_signs_scalar(origin.x, origin.y, second_x, second_y, third_x, third_y, n, signs);
+    }
+}
+
+void bounding_box_mask(const local_coordinate& min, const local_coordinate& max,
+                       const float* x, const float* y,
+                       std::size_t n, unsigned char* inside)
+{
+    if (uses_avx2())
+    {
+        detail::bounding_box_mask_avx2(min.x, min.y, max.x, max.y, x, y, n, inside);
+    }
+    else
+    {
+        detail::bounding_box_mask_scalar(min.x, min.y, max.x, max.y, x, y, n, inside);
+    }
+}
+
+void segments_intersect_mask(const local_coordinate& first, const local_coordinate& second,
+                             const float* begin_x, const float* begin_y,
+                             const float* end_x, const float* end_y,
+                             std::size_t n, unsigned char* intersects)
+{
+    if (uses_avx2())
+    {
+        detail::segments_intersect_mask_avx2(first.x, first.y, second.x, second.y, begin_x, begin_y, end_x, end_y, n, intersects);
+    }
+    else
+    {
+        detail::segments_intersect_mask_scalar(first.x, first.y, second.x, second.y, begin_x, begin_y, end_x, end_y, n, intersects);
+    }
+}
+
+}
@@ -0,0 +1,168 @@
+#ifndef GEOMETRY_KERNELS_HPP
+#define GEOMETRY_KERNELS_HPP
+
+#include "geometry.hpp"
+#include "point.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/// Batched versions of the predicates in geometry.hpp that work on
+/// coordinates stored as structure of arrays.
+///
+/// For double and local (float) coordinates an AVX2 implementation is
+/// selected at runtime if the CPU supports it. It evaluates the exact same
+/// floating point operations as the scalar predicates, so both give identical
+/// results. Like geometry.hpp the float kernels compute in double precision.
+namespace geometry_kernels
+{
+    /// Coordinates stored as structure of arrays
+    template<typename CoordinateT>
+    struct coordinate_array
+    {
+        using value_type = typename coordinate_traits<CoordinateT>::value_type;
+
+        coordinate_array() = default;
+
+        template<typename ForwardIter>
+        coordinate_array(ForwardIter begin, ForwardIter end)
+        {
+            for (auto iter = begin; iter != end; ++iter)
+            {
+                x.push_back(iter->x);
+                y.push_back(iter->y);
+            }
+        }
+
+        std::size_t size() const
+        {
+            return x.size();
+        }
+
+        std::vector<value_type> x;
+        std::vector<value_type> y;
+    };
+
+    /// True if the AVX2 kernels are used
+    bool uses_avx2();
+
+    namespace detail
+    {
+        void orientation_signs_scalar(double origin_x, double origin_y,
+                                      const double* second_x, const double* second_y,
+                                      const double* third_x, const double* third_y,
+                                      std::size_t n, signed char* signs);
+        void orientation_signs_avx2(double origin_x, double origin_y,
+                                    const double* second_x, const double* second_y,
+                                    const double* third_x, const double* third_y,
+                                    std::size_t n, signed char* signs);
+        void orientation_signs_scalar(double origin_x, double origin_y,
+                                      const float* second_x, const float* second_y,
+                                      const float* third_x, const float* third_y,
+                                      std::size_t n, signed char* signs);
+        void orientation_signs_avx2(double origin_x, double origin_y,
+                                    const float* second_x, const float* second_y,
+                                    const float* third_x, const float* third_y,
+                                    std::size_t n, signed char* signs);
+
+        void bounding_box_mask_scalar(double min_x, double min_y, double max_x, double max_y,
+                                      const double* x, const double* y,
+                                      std::size_t n, unsigned char* inside);
+        void bounding_box_mask_avx2(double min_x, double min_y, double max_x, double max_y,
+                                    const double* x, const double* y,
+                                    std::size_t n, unsigned char* inside);
+        void bounding_box_mask_scalar(float min_x, float min_y, float max_x, float max_y,
+                                      const float* x, const float* y,
+                                      std::size_t n, unsigned char* inside);
+        void bounding_box_mask_avx2(float min_x, float min_y, float max_x, float max_y,
+                                    const float* x, const float* y,
+                                    std::size_t n, unsigned char* inside);
+
+        void segments_intersect_mask_scalar(double first_x, double first_y, double second_x, double second_y,
+                                            const double* begin_x, const double* begin_y,
+                                            const double* end_x, const double* end_y,
+                                            std::size_t n, unsigned char* intersects);
+        void segments_intersect_mask_avx2(double first_x, double first_y, double second_x, double second_y,
+                                          const double* begin_x, const double* begin_y,
+                                          const double* end_x, const double* end_y,
+                                          std::size_t n, unsigned char* intersects);
+        void segments_intersect_mask_scalar(double first_x, double first_y, double second_x, double second_y,
+                                            const float* begin_x, const float* begin_y,
+                                            const float* end_x, const float* end_y,
+                                            std::size_t n, unsigned char* intersects);
+        void segments_intersect_mask_avx2(double first_x, double first_y, double second_x, double second_y,
+                                          const float* begin_x, const float* begin_y,
+                                          const float* end_x, const float* end_y,
+                                          std::size_t n, unsigned char* intersects);
+    }
+
+    /// signs[k] is 1 if third[k] is left of origin -> second[k], -1 if right of it and 0 if on the line.
+    template<typename CoordinateT, typename ValueT = typename coordinate_traits<CoordinateT>::value_type>
+    void orientation_signs(const CoordinateT& origin,
+                           const ValueT* second_x, const ValueT* second_y,
+                           const ValueT* third_x, const ValueT* third_y,
+                           std::size_t n, signed char* signs)
+    {
+        for (auto k = 0u; k < n; ++k)
+        {
+            auto o = geometry::orientation(origin, CoordinateT {second_x[k], second_y[k]}, CoordinateT {third_x[k], third_y[k]});
+            signs[k] = o > 0 ? 1 : (o < 0 ? -1 : 0);
+        }
+    }
+
+    void orientation_signs(const coordinate& origin,
+                           const double* second_x, const double* second_y,
+                           const double* third_x, const double* third_y,
+                           std::size_t n, signed char* signs);
+
+    void orientation_signs(const local_coordinate& origin,
+                           const float* second_x, const float* second_y,
+                           const float* third_x, const float* third_y,
+                           std::size_t n, signed char* signs);
+
+    /// inside[k] is 1 if (x[k], y[k]) is strictly inside the bounding box [min, max].
+    template<typename CoordinateT, typename ValueT = typename coordinate_traits<CoordinateT>::value_type>
+    void bounding_box_mask(const CoordinateT& min, const CoordinateT& max,
+                           const ValueT* x, const ValueT* y,
+                           std::size_t n, unsigned char* inside)
+    {
+        for (auto k = 0u; k < n; ++k)
+        {
+            inside[k] = x[k] > min.x && y[k] > min.y && x[k] < max.x && y[k] < max.y;
+        }
+    }
+
+    void bounding_box_mask(const coordinate& min, const coordinate& max,
+                           const double* x, const double* y,
+                           std::size_t n, unsigned char* inside);
+
+    void bounding_box_mask(const local_coordinate& min, const local_coordinate& max,
+                           const float* x, const float* y,
+                           std::size_t n, unsigned char* inside);
+
+    /// intersects[k] is 1 if geometry::segments_intersect(begin[k], end[k], first, second) is true.
+    template<typename CoordinateT, typename ValueT = typename coordinate_traits<CoordinateT>::value_type>
+    void segments_intersect_mask(const CoordinateT& first, const CoordinateT& second,
+                                 const ValueT* begin_x, const ValueT* begin_y,
+                                 const ValueT* end_x, const ValueT* end_y,
+                                 std::size_t n, unsigned char* intersects)
+    {
+        for (auto k = 0u; k < n; ++k)
+        {
+            intersects[k] = geometry::segments_intersect(CoordinateT {begin_x[k], begin_y[k]}, CoordinateT {end_x[k], end_y[k]},
+                                                         first, second);
+        }
+    }
+
+    void segments_intersect_mask(const coordinate& first, const coordinate& second,
+                                 const double* begin_x, const double* begin_y,
+                                 const double* end_x, const double* end_y,
+                                 std::size_t n, unsigned char* intersects);
+
+    void segments_intersect_mask(const local_coordinate& first, const local_coordinate& second,
+                                 const float* begin_x, const float* begin_y,
+                                 const float* end_x, const float* end_y,
+                                 std::size_t n, unsigned char* intersects);
+}
+
+#endif
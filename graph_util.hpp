@@ -1,6 +1,7 @@
 #ifndef GRAPH_UTIL_HPP
 #define GRAPH_UTIL_HPP
 
+#include <deque>
 #include <vector>
 #include <stack>
 #include <limits>
@@ -126,6 +127,24 @@ namespace graph_util
 
         return info;
     }
+
+    /// Nodes of the shortest path from source to target, target must be reachable
+    template<typename GraphT>
+    std::deque<unsigned> shortest_dag_path_nodes(const GraphT& graph, unsigned source, unsigned target)
+    {
+        auto info = shortest_dag_path(graph, source, target);
+
+        std::deque<unsigned> path;
+        auto current = target;
+        while (current != source)
+        {
+            path.push_front(current);
+            current = info.parents[current];
+        }
+        path.push_front(source);
+
+        return path;
+    }
 }
 
 #endif
@@ -2,6 +2,7 @@
 #define LINE_WRITER_HPP
 
 #include "poly_line.hpp"
+#include "quantizer.hpp"
 
 #include <iostream>
 #include <sstream>
@@ -25,7 +26,19 @@ public:
         }
 
     }
-private:
+
+    /// Writes lines with quantized coordinates in their original coordinate system
+    template<typename QuantizedCoordinateT>
+    void write(const std::vector<basic_poly_line<QuantizedCoordinateT>>& lines,
+               const basic_quantizer<QuantizedCoordinateT>& quantizer)
+    {
+        for (const auto& l : lines)
+        {
+            write_line(quantizer.dequantize(l));
+        }
+    }
+
+    /// Writes a single line and flushes it, so it can be read while the output is written
     void write_line(const poly_line& line)
     {
         const std::string temp_start = "<gml:LineString srsName=\"EPSG:54004\" xmlns:gml=\"http://www.opengis.net/gml\"><gml:coordinates decimal=\".\" cs=\",\" ts=\" \">";
@@ -39,6 +52,7 @@ private:
         output << temp_end << std::endl;
     }
 
+private:
     std::ostream& output;
 };
 
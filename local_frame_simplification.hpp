@@ -0,0 +1,111 @@
+#ifndef LOCAL_FRAME_SIMPLIFICATION_HPP
+#define LOCAL_FRAME_SIMPLIFICATION_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "shortcut.hpp"
+#include "shortcut_validator.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/// Runs SimplificationT on a copy of the line and its points that is translated
+/// to the lower left corner of the bounding box of the line and converted to
+/// SimplificationT::coordinate_type.
+///
+/// With single precision coordinates this halves the memory that is moved through
+/// the stages, while the offsets stay small enough to keep most of the precision.
+/// Rounding can still move a point to the other side of a shortcut, so every shortcut is
+/// checked again in the original coordinates and dropped if a point or vertex is inside of
+/// or on its polygon (see basic_shortcut_validator). The edges of the line are always kept,
+/// so the result stays free of intersections but may use more edges than in double precision.
+template<typename SimplificationT>
+class local_frame_simplification
+{
+public:
+    using local_coordinate_type = typename SimplificationT::coordinate_type;
+    using local_value_type = typename coordinate_traits<local_coordinate_type>::value_type;
+
+    /// Additional arguments are passed to SimplificationT
+    template<typename... ArgsT>
+    local_frame_simplification(const poly_line& in_line, std::vector<point>&& in_points, ArgsT&&... args)
+        : line(in_line)
+        , point_locations(locations(in_points))
+        , origin(bounding_box_origin(in_line))
+        , local_line(to_local_frame(in_line))
+        , simplification(local_line, to_local_frame(in_points), std::forward<ArgsT>(args)...)
+    {
+    }
+
+    std::vector<shortcut> operator()() const
+    {
+        auto shortcuts = simplification();
+
+        basic_shortcut_validator<coordinate> is_valid(line, point_locations);
+        shortcuts.erase(std::remove_if(shortcuts.begin(), shortcuts.end(),
+                                       [&is_valid](const shortcut& s) { return s.last > s.first + 1 && !is_valid(s.first, s.last); }),
+                        shortcuts.end());
+        return shortcuts;
+    }
+
+private:
+    static std::vector<coordinate> locations(const std::vector<point>& points)
+    {
+        std::vector<coordinate> point_locations;
+        point_locations.reserve(points.size());
+        for (const auto& p : points)
+        {
+            point_locations.push_back(p.location);
+        }
+        return point_locations;
+    }
+
+    static coordinate bounding_box_origin(const poly_line& line)
+    {
+        coordinate min {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+        for (const auto& c : line.coordinates)
+        {
+            min.x = std::min(min.x, c.x);
+            min.y = std::min(min.y, c.y);
+        }
+        return min;
+    }
+
+    local_coordinate_type to_local_frame(const coordinate& c) const
+    {
+        return local_coordinate_type {static_cast<local_value_type>(c.x - origin.x),
+                                      static_cast<local_value_type>(c.y - origin.y)};
+    }
+
+    basic_poly_line<local_coordinate_type> to_local_frame(const poly_line& line) const
+    {
+        basic_poly_line<local_coordinate_type> local {line.id, {}};
+        local.coordinates.reserve(line.coordinates.size());
+        for (const auto& c : line.coordinates)
+        {
+            local.coordinates.push_back(to_local_frame(c));
+        }
+        return local;
+    }
+
+    std::vector<basic_point<local_coordinate_type>> to_local_frame(const std::vector<point>& points) const
+    {
+        std::vector<basic_point<local_coordinate_type>> local;
+        local.reserve(points.size());
+        for (const auto& p : points)
+        {
+            local.push_back(basic_point<local_coordinate_type> {p.line_id, p.id, to_local_frame(p.location)});
+        }
+        return local;
+    }
+
+    const poly_line& line;
+    std::vector<coordinate> point_locations;
+    coordinate origin;
+    basic_poly_line<local_coordinate_type> local_line;
+    SimplificationT simplification;
+};
+
+#endif
@@ -5,21 +5,272 @@
 #include "shortcut.hpp"
 #include "static_graph.hpp"
 #include "graph_util.hpp"
+#include "vertex_reduction.hpp"
+#include "simplification_options.hpp"
+#include "simplification_state.hpp"
+#include "shortcut_cache.hpp"
+#include "simplification_checkpoint.hpp"
+#include "edge_allocation.hpp"
+#include "preprocessing_snapshot.hpp"
+#include "point_grid.hpp"
+#include "util.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
 template<typename SimplificationT, typename PointFilterT>
 class map_simplification
 {
 public:
-    map_simplification(std::vector<poly_line>&& in_lines, std::vector<point>&& in_points)
+    using coordinate_type = typename PointFilterT::coordinate_type;
+    using line_type = basic_poly_line<coordinate_type>;
+    using point_type = basic_point<coordinate_type>;
+    using state_type = basic_simplification_state<coordinate_type>;
+    using snapshot_content_type = basic_preprocessing<coordinate_type>;
+    using snapshot_type = basic_preprocessing_snapshot<coordinate_type>;
+
+    map_simplification(std::vector<line_type>&& in_lines, std::vector<point_type>&& in_points)
         : lines(in_lines), points(in_points)
     {
     }
 
-    std::vector<poly_line> operator()(unsigned max_edges)
+    std::vector<line_type> operator()(unsigned max_edges)
     {
-        // ensure crossing free simplification by extending the point set
+        if (allocate_edges)
+        {
+            require_all_shortcuts();
+        }
+        find_duplicate_lines();
+        auto shortcut_lists = compute_shortcuts();
+        if (allocate_edges)
+        {
+            basic_edge_allocation<coordinate_type> allocation(lines, shortcut_lists, num_threads);
+            allocated_deviation = allocation.threshold(max_edges);
+            if (std::isfinite(allocated_deviation))
+            {
+                shortcut_lists = allocation.filter(allocated_deviation);
+                std::cout << "Allocated " << max_edges << " edges, the largest deviation is " << allocated_deviation << "." << std::endl;
+            }
+        }
+
+        return select_shortcuts(max_edges, std::move(shortcut_lists));
+    }
+
+    /// Simplifies the map once for every level of detail. The shortcut graphs are only computed
+    /// once, every level selects its paths among the shortcuts within its error threshold.
+    /// original_indices(), used_edges() and max_deviation() refer to the last level.
+    std::vector<std::vector<line_type>> operator()(const std::vector<detail_level>& levels)
+    {
+        require_all_shortcuts();
+        computes_levels = true;
+        find_duplicate_lines();
+        auto shortcut_lists = compute_shortcuts();
+        basic_edge_allocation<coordinate_type> allocation(lines, shortcut_lists, num_threads);
+
+        std::vector<std::vector<line_type>> simplified_levels;
+        for (const auto& level : levels)
+        {
+            auto max_edges = std::numeric_limits<unsigned>::max();
+            allocated_deviation = level.max_deviation;
+            if (level.max_edges > 0)
+            {
+                max_edges = level.max_edges;
+                allocated_deviation = allocation.threshold(max_edges);
+            }
+
+            std::cout << "Level " << simplified_levels.size() << ": ";
+            simplified_levels.push_back(select_shortcuts(max_edges, allocation.filter(allocated_deviation)));
+        }
+
+        return simplified_levels;
+    }
+
+    /// Called with every simplified line and the indices of its vertices in the input line by stream()
+    using line_callback = std::function<void(const line_type& simplified_line, const std::vector<unsigned>& original_indices)>;
+
+    /// Simplifies the map like operator(), but selects the path of every line as soon as its shortcuts
+    /// are complete and passes it to callback instead of waiting for all lines. If keep_order is set,
+    /// finished lines are buffered until all earlier lines are passed, otherwise they are passed in the
+    /// order they finish. Calls of callback never overlap. Not available with allocate_max_edges().
+    void stream(unsigned max_edges, const line_callback& callback, bool keep_order)
+    {
+        if (allocate_edges)
+        {
+            throw std::runtime_error("Allocating the edges needs the shortcuts of all lines and can not be streamed.");
+        }
+
+        find_duplicate_lines();
+        simplified_vertex_indices.assign(lines.size(), std::vector<unsigned>());
+        num_used_edges = 0;
+
+        // holds the finished lines until they are passed, and the originals of duplicates
+        std::vector<line_type> simplified(lines.size());
+        std::vector<char> is_finished(lines.size(), false);
+        std::vector<char> has_copies(lines.size(), false);
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            has_copies[duplicate_of[i]] = has_copies[duplicate_of[i]] || duplicate_of[i] != i;
+        }
+        std::mutex output_mutex;
+        unsigned next_line = 0;
+        auto pass_line = [&](unsigned line_idx)
+        {
+            callback(simplified[line_idx], simplified_vertex_indices[line_idx]);
+            if (!has_copies[line_idx])
+            {
+                line_type().coordinates.swap(simplified[line_idx].coordinates);
+            }
+        };
+
+        compute_shortcuts(
+            [&](unsigned line_idx, const std::vector<shortcut>& shortcuts)
+            {
+                if (duplicate_of[line_idx] != line_idx)
+                {
+                    copy_simplified_line(line_idx, simplified);
+                }
+                else
+                {
+                    select_path(line_idx, std::vector<shortcut>(shortcuts), simplified[line_idx]);
+                }
+
+                std::lock_guard<std::mutex> lock(output_mutex);
+                num_used_edges += simplified[line_idx].coordinates.size() - 1;
+                if (!keep_order)
+                {
+                    pass_line(line_idx);
+                    return;
+                }
+
+                is_finished[line_idx] = true;
+                for (; next_line < lines.size() && is_finished[next_line]; ++next_line)
+                {
+                    pass_line(next_line);
+                }
+            });
+
+        report_used_edges(max_edges);
+    }
+
+    /// Lines are split at interior vertices with one of these coordinates and
+    /// the pieces are simplified independently. Pinned vertices are always kept.
+    void pin_vertices(const std::vector<coordinate_type>& coordinates)
+    {
+        pinned_coordinates.insert(pinned_coordinates.end(), coordinates.begin(), coordinates.end());
+        std::sort(pinned_coordinates.begin(), pinned_coordinates.end(), coordinate_less);
+        pinned_coordinates.erase(std::unique(pinned_coordinates.begin(), pinned_coordinates.end()), pinned_coordinates.end());
+    }
+
+    /// Sorted coordinates of all pinned vertices
+    const std::vector<coordinate_type>& pinned_vertices() const
+    {
+        return pinned_coordinates;
+    }
+
+    /// Pins all vertices that are shared by at least two lines
+    void pin_shared_vertices()
+    {
+        std::vector<std::pair<coordinate_type, unsigned>> vertices;
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            for (const auto& c : lines[i].coordinates)
+            {
+                vertices.emplace_back(c, i);
+            }
+        }
+        std::sort(vertices.begin(), vertices.end(),
+                  [](const std::pair<coordinate_type, unsigned>& lhs, const std::pair<coordinate_type, unsigned>& rhs)
+                  {
+                      return coordinate_less(lhs.first, rhs.first) ||
+                             (lhs.first == rhs.first && lhs.second < rhs.second);
+                  });
+
+        std::vector<coordinate_type> shared;
+        for (auto k = 1u; k < vertices.size(); ++k)
+        {
+            if (vertices[k].first == vertices[k-1].first && vertices[k].second != vertices[k-1].second &&
+                (shared.empty() || shared.back() != vertices[k].first))
+            {
+                shared.push_back(vertices[k].first);
+            }
+        }
+
+        pin_vertices(shared);
+    }
+
+    /// Options that are passed to every SimplificationT
+    void set_options(const simplification_options& new_options)
+    {
+        options = new_options;
+    }
+
+    /// Origin and resolution of the quantizer of the coordinates, recorded in the state
+    void set_quantization(const quantization_parameters& new_quantization)
+    {
+        quantization = new_quantization;
+    }
+
+    /// Keeps the input and the shortcuts of every line of the next simplification, see state()
+    void record_state()
+    {
+        recording = true;
+    }
+
+    /// State of the last simplification if record_state() was called before
+    const state_type& state() const
+    {
+        return current_state;
+    }
+
+    /// Reuses the shortcuts of all lines of a previous run whose geometry did not change and
+    /// whose bounding box contains no point or vertex that was added, removed or moved.
+    /// A state of a different engine, other options, another quantization or vertex reduction is ignored.
+    void set_previous_state(state_type&& state)
+    {
+        previous_state = std::move(state);
+        has_previous_state = true;
+    }
+
+    /// Looks up the shortcuts of every line and piece in the cache before simplifying it
+    /// and adds the shortcuts of the simplified ones. The cache must outlive the simplification.
+    void use_cache(shortcut_cache& new_cache)
+    {
+        cache = &new_cache;
+    }
+
+    /// Appends the shortcuts of every line to the checkpoint as soon as they are complete and
+    /// skips the lines the checkpoint already contains for the same input and options.
+    /// The checkpoint must outlive the simplification.
+    void use_checkpoint(simplification_checkpoint& new_checkpoint)
+    {
+        checkpoint = &new_checkpoint;
+    }
+
+    /// Runs everything that happens before the lines are simplified: the point filter, the vertex
+    /// reduction and the split at pinned vertices. The result can be written to a snapshot and
+    /// passed to use_snapshot() of later simplifications of the same input. The collinear vertices
+    /// are always removed, simplifications that need to keep them only use the filtered points.
+    snapshot_content_type prepare()
+    {
+        snapshot_content_type content;
+        content.lines = lines;
+        content.points = points;
+        content.pinned_coordinates = pinned_coordinates;
+        content.line_states.resize(lines.size());
+
+        find_duplicate_lines();
         for (const auto& l : lines)
         {
             for (const auto& c : l.coordinates)
@@ -27,51 +278,877 @@ public:
                 points.push_back({l.id, static_cast<unsigned>(points.size()), c});
             }
         }
+        reduced_vertex_indices.assign(lines.size(), std::vector<unsigned>());
 
-        std::vector<std::vector<shortcut>> collected_shorcuts;
+        util::parallel_for(num_threads, lines.size(),
+            [&](std::size_t i)
+            {
+                // duplicates use the preprocessing of their original
+                if (duplicate_of[i] != i)
+                {
+                    return;
+                }
 
-        for (const auto& l : lines)
-        {
-            PointFilterT filter(l.coordinates.begin(), l.coordinates.end(), l.id);
-            auto filtered_points = filter(points);
-            SimplificationT simplification(l, std::move(filtered_points));
+                std::vector<point_type> line_points;
+                auto pieces = preprocess_line(i, line_points, true);
+
+                // the filter keeps the order of the points
+                auto& line_state = content.line_states[i];
+                auto idx = 0u;
+                for (const auto& p : line_points)
+                {
+                    while (!same_point(points[idx], p))
+                    {
+                        ++idx;
+                    }
+                    line_state.candidates.push_back(idx++);
+                }
+                line_state.reduced_indices = reduced_vertex_indices[i];
+                for (const auto& piece : pieces)
+                {
+                    line_state.piece_ends.push_back(piece.last_idx);
+                }
+            });
 
-            collected_shorcuts.push_back(simplification());
+        lines = content.lines;
+        points = content.points;
+        reduced_vertex_indices.clear();
+        return content;
+    }
+
+    /// Takes the preprocessing of every line from the snapshot instead of computing it.
+    /// The snapshot needs to be prepared from the same lines, points and pinned vertices
+    /// and must outlive the simplification.
+    void use_snapshot(const snapshot_type& new_snapshot)
+    {
+        if (new_snapshot.size() != lines.size() || new_snapshot.num_points() != points.size() ||
+            new_snapshot.pinned_coordinates() != pinned_coordinates)
+        {
+            throw std::runtime_error("The snapshot was prepared for a different input.");
         }
+        snapshot = &new_snapshot;
+    }
+
+    /// Spends max_edges across all lines such that the largest deviation of a removed vertex is minimal,
+    /// instead of using the fewest edges for every line. See basic_edge_allocation.
+    /// Like the levels of detail this keeps the vertices inside straight runs.
+    void allocate_max_edges()
+    {
+        allocate_edges = true;
+    }
+
+    /// Largest deviation of the last simplification with allocate_max_edges(),
+    /// infinity if max_edges is below the minimal number of edges
+    double max_deviation() const
+    {
+        return allocated_deviation;
+    }
+
+    /// Number of edges of the last simplification
+    unsigned used_edges() const
+    {
+        return num_used_edges;
+    }
+
+    /// Number of threads used to simplify the lines and their pieces
+    void set_num_threads(unsigned threads)
+    {
+        num_threads = std::max(threads, 1u);
+    }
 
-        return select_shortcuts(max_edges, std::move(collected_shorcuts));
+    /// Indices of the vertices of each simplified line in the corresponding input line
+    const std::vector<std::vector<unsigned>>& original_indices() const
+    {
+        return simplified_vertex_indices;
+    }
+
+    /// Ids of the lines that exceeded the work budget in the last simplification
+    const std::vector<unsigned>& fallback_lines() const
+    {
+        return fallback_line_ids;
+    }
+
+    /// Number of lines whose shortcuts were taken from the previous state in the last simplification
+    unsigned reused_lines() const
+    {
+        return num_reused_lines;
+    }
+
+    /// Number of lines that have the same coordinates as an earlier line, in the same or opposite direction.
+    /// Only the first copy is simplified, the others use its result.
+    unsigned duplicate_lines() const
+    {
+        return num_duplicate_lines;
+    }
+
+    /// Number of duplicated and collinear vertices that were removed before simplification
+    unsigned removed_vertices() const
+    {
+        return num_removed_vertices;
     }
 
 private:
+    /// The vertices first_idx to last_idx of a line
+    struct line_piece
+    {
+        unsigned line_idx;
+        unsigned first_idx;
+        unsigned last_idx;
+    };
 
-    std::vector<poly_line> select_shortcuts(unsigned max_edges, std::vector<std::vector<shortcut>>&& in_shortcut_lists) const
+    using line_complete_callback = std::function<void(unsigned line_idx, const std::vector<shortcut>& shortcuts)>;
+
+    static bool coordinate_less(const coordinate_type& lhs, const coordinate_type& rhs)
     {
-        std::vector<std::vector<shortcut>> shortcut_lists(in_shortcut_lists);
-        std::vector<poly_line> simplified(shortcut_lists.size());
+        return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+    }
 
-        unsigned num_used_edges = 0;
-        for (auto i = 0u; i < shortcut_lists.size(); ++i)
+    static bool same_point(const point_type& lhs, const point_type& rhs)
+    {
+        return lhs.id == rhs.id && lhs.line_id == rhs.line_id && lhs.location == rhs.location;
+    }
+
+    std::vector<bool> find_pinned(const line_type& line) const
+    {
+        if (pinned_coordinates.empty())
+        {
+            return {};
+        }
+
+        std::vector<bool> pinned(line.coordinates.size());
+        for (auto idx = 0u; idx < line.coordinates.size(); ++idx)
+        {
+            pinned[idx] = std::binary_search(pinned_coordinates.begin(), pinned_coordinates.end(),
+                                             line.coordinates[idx], coordinate_less);
+        }
+        return pinned;
+    }
+
+    /// Splits the reduced line at its pinned interior vertices
+    std::vector<line_piece> split_at_pinned(unsigned line_idx, const std::vector<bool>& pinned) const
+    {
+        const auto& original_indices = reduced_vertex_indices[line_idx];
+        unsigned last_idx = lines[line_idx].coordinates.size() - 1;
+
+        std::vector<line_piece> pieces;
+        unsigned first_idx = 0;
+        for (auto idx = 1u; idx < last_idx && !pinned.empty(); ++idx)
+        {
+            if (pinned[original_indices[idx]])
+            {
+                pieces.push_back(line_piece {line_idx, first_idx, idx});
+                first_idx = idx;
+            }
+        }
+        pieces.push_back(line_piece {line_idx, first_idx, last_idx});
+
+        return pieces;
+    }
+
+    template<typename IterT>
+    static std::size_t hash_coordinates(IterT begin, IterT end)
+    {
+        using value_type = typename coordinate_traits<coordinate_type>::value_type;
+        std::hash<value_type> hash_value;
+        std::size_t hash = 0;
+        for (auto iter = begin; iter != end; ++iter)
+        {
+            hash = (hash * 31 + hash_value(iter->x)) * 31 + hash_value(iter->y);
+        }
+        return hash;
+    }
+
+    /// Finds every line that repeats the coordinates of an earlier line, possibly reversed
+    void find_duplicate_lines()
+    {
+        duplicate_of.resize(lines.size());
+        std::iota(duplicate_of.begin(), duplicate_of.end(), 0u);
+        reversed_duplicate.assign(lines.size(), false);
+
+        // both directions of a line have the same key
+        std::unordered_map<std::size_t, std::vector<unsigned>> originals;
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            const auto& coordinates = lines[i].coordinates;
+            if (coordinates.size() < 2)
+            {
+                continue;
+            }
+
+            auto forward = hash_coordinates(coordinates.begin(), coordinates.end());
+            auto backward = hash_coordinates(coordinates.rbegin(), coordinates.rend());
+            auto& candidates = originals[std::min(forward, backward)];
+            for (auto c : candidates)
+            {
+                const auto& original = lines[c].coordinates;
+                if (original.size() != coordinates.size())
+                {
+                    continue;
+                }
+                if (std::equal(original.begin(), original.end(), coordinates.begin()))
+                {
+                    duplicate_of[i] = c;
+                    break;
+                }
+                if (std::equal(original.begin(), original.end(), coordinates.rbegin()))
+                {
+                    duplicate_of[i] = c;
+                    reversed_duplicate[i] = true;
+                    break;
+                }
+            }
+
+            if (duplicate_of[i] == i)
+            {
+                candidates.push_back(i);
+            }
+        }
+
+        num_duplicate_lines = 0;
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            num_duplicate_lines += duplicate_of[i] != i;
+        }
+        if (num_duplicate_lines > 0)
+        {
+            std::cout << "Found " << num_duplicate_lines << " duplicate lines, each geometry is simplified once." << std::endl;
+        }
+    }
+
+    /// Shortcuts of the duplicate line_idx given the shortcuts of its original
+    std::vector<shortcut> duplicate_shortcuts(unsigned line_idx, const std::vector<shortcut>& original_shortcuts) const
+    {
+        if (!reversed_duplicate[line_idx])
+        {
+            return original_shortcuts;
+        }
+
+        unsigned last_idx = lines[line_idx].coordinates.size() - 1;
+        std::vector<shortcut> shortcuts;
+        shortcuts.reserve(original_shortcuts.size());
+        for (const auto& s : original_shortcuts)
+        {
+            shortcuts.emplace_back(last_idx - s.last, last_idx - s.first);
+        }
+        std::sort(shortcuts.begin(), shortcuts.end(),
+                  [](const shortcut& lhs, const shortcut& rhs)
+                  {
+                      return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.last < rhs.last);
+                  });
+        return shortcuts;
+    }
+
+    /// Copies the simplified original of the duplicate line_idx
+    void copy_simplified_line(unsigned line_idx, std::vector<line_type>& simplified)
+    {
+        auto original_idx = duplicate_of[line_idx];
+        simplified[line_idx].id = lines[line_idx].id;
+        simplified[line_idx].coordinates = simplified[original_idx].coordinates;
+        simplified_vertex_indices[line_idx] = simplified_vertex_indices[original_idx];
+        if (reversed_duplicate[line_idx])
+        {
+            unsigned last_idx = reduced_vertex_indices[line_idx].back();
+            std::reverse(simplified[line_idx].coordinates.begin(), simplified[line_idx].coordinates.end());
+            std::reverse(simplified_vertex_indices[line_idx].begin(), simplified_vertex_indices[line_idx].end());
+            for (auto& idx : simplified_vertex_indices[line_idx])
+            {
+                idx = last_idx - idx;
+            }
+        }
+    }
+
+    static constexpr unsigned NO_PREVIOUS_LINE = std::numeric_limits<unsigned>::max();
+
+    /// Returns the index of every line in the previous state, or NO_PREVIOUS_LINE if it needs to be simplified.
+    /// The filtered point set of a line can only change if a point or vertex inside of its bounding box changed.
+    std::vector<unsigned> find_reusable_lines() const
+    {
+        std::vector<unsigned> previous_idx(lines.size(), NO_PREVIOUS_LINE);
+        if (!has_previous_state || previous_state.pinned_coordinates != pinned_coordinates ||
+            previous_state.line_states.size() != previous_state.lines.size())
+        {
+            return previous_idx;
+        }
+        if (!previous_state.is_compatible(typeid(SimplificationT).name(), options, quantization, removes_collinear_vertices()))
+        {
+            std::cout << "The previous state was computed with a different engine, options, quantization or vertex"
+                      << " reduction and is ignored." << std::endl;
+            return previous_idx;
+        }
+
+        // points and vertices of the extended point set that were added, removed or moved
+        using location = std::tuple<unsigned, typename coordinate_traits<coordinate_type>::value_type,
+                                    typename coordinate_traits<coordinate_type>::value_type>;
+        auto extended_locations = [](const std::vector<line_type>& extended_lines, const std::vector<point_type>& extended_points)
+        {
+            std::vector<location> locations;
+            for (const auto& p : extended_points)
+            {
+                locations.emplace_back(p.line_id, p.location.x, p.location.y);
+            }
+            for (const auto& l : extended_lines)
+            {
+                for (const auto& c : l.coordinates)
+                {
+                    locations.emplace_back(l.id, c.x, c.y);
+                }
+            }
+            std::sort(locations.begin(), locations.end());
+            return locations;
+        };
+        auto previous_locations = extended_locations(previous_state.lines, previous_state.points);
+        auto current_locations = extended_locations(lines, points);
+        std::vector<location> changed;
+        std::set_symmetric_difference(previous_locations.begin(), previous_locations.end(),
+                                      current_locations.begin(), current_locations.end(),
+                                      std::back_inserter(changed));
+
+        std::vector<coordinate_type> changed_coordinates;
+        for (const auto& c : changed)
+        {
+            changed_coordinates.push_back(coordinate_type {std::get<1>(c), std::get<2>(c)});
+        }
+        basic_point_grid<coordinate_type> grid(changed_coordinates);
+
+        // ids that occur more than once are never reused
+        std::map<unsigned, unsigned> previous_ids;
+        for (auto idx = 0u; idx < previous_state.lines.size(); ++idx)
+        {
+            auto inserted = previous_ids.insert(std::make_pair(previous_state.lines[idx].id, idx));
+            if (!inserted.second)
+            {
+                inserted.first->second = NO_PREVIOUS_LINE;
+            }
+        }
+
+        for (auto i = 0u; i < lines.size(); ++i)
         {
-            auto num_nodes = lines[i].coordinates.size();
-            static_graph<shortcut> shortcut_graph(num_nodes, std::move(shortcut_lists[i]));
-            auto path_info = graph_util::shortest_dag_path(shortcut_graph, 0, num_nodes-1);
+            const auto& l = lines[i];
+            auto iter = previous_ids.find(l.id);
+            if (l.coordinates.empty() || iter == previous_ids.end() || iter->second == NO_PREVIOUS_LINE ||
+                previous_state.lines[iter->second].coordinates != l.coordinates)
+            {
+                continue;
+            }
+
+            auto min = l.coordinates.front();
+            auto max = l.coordinates.front();
+            for (const auto& c : l.coordinates)
+            {
+                min.x = std::min(min.x, c.x);
+                min.y = std::min(min.y, c.y);
+                max.x = std::max(max.x, c.x);
+                max.y = std::max(max.y, c.y);
+            }
+
+            bool is_affected = false;
+            grid.query(min, max, [&is_affected](unsigned) { is_affected = true; });
+            if (!is_affected)
+            {
+                previous_idx[i] = iter->second;
+            }
+        }
+
+        // a line id is only reused once
+        std::vector<unsigned> sorted_idx(previous_idx);
+        std::sort(sorted_idx.begin(), sorted_idx.end());
+        for (auto k = 1u; k < sorted_idx.size(); ++k)
+        {
+            if (sorted_idx[k] != NO_PREVIOUS_LINE && sorted_idx[k] == sorted_idx[k - 1])
+            {
+                std::replace(previous_idx.begin(), previous_idx.end(), sorted_idx[k], NO_PREVIOUS_LINE);
+            }
+        }
+
+        return previous_idx;
+    }
+
+    /// Options passed to SimplificationT, with the threads left over by the parallel pieces
+    simplification_options engine_options() const
+    {
+        auto line_options = options;
+        line_options.num_threads = engine_threads;
+        return line_options;
+    }
+
+    /// Options of the simplification of lines that exceed the work budget
+    simplification_options fallback_options() const
+    {
+        auto fallback = engine_options();
+        fallback.work_budget = 0;
+        if (fallback.window.max_vertices == 0 || fallback.window.max_vertices > options.fallback_window)
+        {
+            fallback.window.max_vertices = options.fallback_window;
+        }
+        return fallback;
+    }
+
+    /// Runs SimplificationT and falls back to a windowed simplification if it exceeds the work budget
+    std::vector<shortcut> simplify(const line_type& line, std::vector<point_type>&& line_points, bool& fell_back) const
+    {
+        if (options.work_budget == 0)
+        {
+            SimplificationT simplification(line, std::move(line_points), engine_options());
+            return simplification();
+        }
+
+        try
+        {
+            auto points_copy = line_points;
+            SimplificationT simplification(line, std::move(points_copy), engine_options());
+            return simplification();
+        }
+        catch (const work_budget_exceeded&)
+        {
+            fell_back = true;
+            SimplificationT simplification(line, std::move(line_points), fallback_options());
+            return simplification();
+        }
+    }
+
+    /// Identifies the reduced line, its points, pieces and the options in the checkpoint
+    std::uint64_t checkpoint_key(const line_type& line, const std::vector<point_type>& line_points,
+                                 const std::vector<line_piece>& line_pieces) const
+    {
+        auto key = shortcut_cache::hash_line<SimplificationT>(line, options) ^ (shortcut_cache::hash_points(line_points) * 31);
+        for (const auto& p : line_pieces)
+        {
+            key = key * 31 + p.last_idx;
+        }
+        return key;
+    }
+
+    std::vector<shortcut> simplify_cached(const line_type& line, std::vector<point_type>&& line_points, bool& fell_back) const
+    {
+        if (cache == nullptr)
+        {
+            return simplify(line, std::move(line_points), fell_back);
+        }
+
+        shortcut_cache::key k {shortcut_cache::hash_line<SimplificationT>(line, options),
+                               shortcut_cache::hash_points(line_points)};
+        std::vector<shortcut> shortcuts;
+        if (cache->find(k, shortcuts, fell_back))
+        {
+            return shortcuts;
+        }
+
+        shortcuts = simplify(line, std::move(line_points), fell_back);
+        cache->insert(k, shortcuts, fell_back);
+        return shortcuts;
+    }
+
+    /// The vertices of the line outside of a piece constrain it like any other point.
+    std::vector<shortcut> simplify_piece(const line_piece& piece, std::vector<point_type>& filtered_points, bool& fell_back) const
+    {
+        const auto& l = lines[piece.line_idx];
+        if (piece.first_idx == 0 && piece.last_idx + 1 == l.coordinates.size())
+        {
+            return simplify_cached(l, std::move(filtered_points), fell_back);
+        }
+
+        line_type piece_line {l.id, std::vector<coordinate_type>(l.coordinates.begin() + piece.first_idx,
+                                                                 l.coordinates.begin() + piece.last_idx + 1)};
+
+        std::vector<point_type> outside_vertices;
+        for (auto idx = 0u; idx < l.coordinates.size(); ++idx)
+        {
+            if (idx < piece.first_idx || idx > piece.last_idx)
+            {
+                outside_vertices.push_back({point_type::NO_LINE_ID, idx, l.coordinates[idx]});
+            }
+        }
+
+        PointFilterT filter(piece_line.coordinates.begin(), piece_line.coordinates.end(), l.id);
+        auto piece_points = filter(filtered_points);
+        auto piece_outside_vertices = filter(outside_vertices);
+        piece_points.insert(piece_points.end(), piece_outside_vertices.begin(), piece_outside_vertices.end());
+
+        auto shortcuts = simplify_cached(piece_line, std::move(piece_points), fell_back);
+        for (auto& s : shortcuts)
+        {
+            s.first += piece.first_idx;
+            s.last += piece.first_idx;
+            if (s.split_edge != NO_EDGE_ID)
+            {
+                s.split_edge += piece.first_idx;
+            }
+        }
+
+        return shortcuts;
+    }
+
+    /// Goal directed engines only return one shortest path per subpath, see simplification_options::goal_directed
+    void require_all_shortcuts() const
+    {
+        if (options.goal_directed)
+        {
+            throw std::runtime_error("The edge allocation and the levels of detail need all shortcuts,"
+                                     " which a goal directed simplification does not compute.");
+        }
+    }
+
+    /// Collinear vertices can only be removed if every valid shortcut may be used, see basic_vertex_reduction.
+    /// The edge allocation and the levels of detail filter the shortcuts by their error like a deviation bound.
+    bool removes_collinear_vertices() const
+    {
+        return options.max_deviation <= 0 && !allocate_edges && !computes_levels;
+    }
+
+    /// Filters the points of line i, removes its redundant vertices and splits it at its pinned vertices.
+    /// Expects the extended point set.
+    std::vector<line_piece> preprocess_line(unsigned i, std::vector<point_type>& line_points, bool remove_collinear)
+    {
+        auto& l = lines[i];
+        PointFilterT filter(l.coordinates.begin(), l.coordinates.end(), l.id);
+        line_points = filter(points);
+
+        return reduce_line(i, line_points, remove_collinear);
+    }
+
+    /// Removes the redundant vertices of line i and splits it at its pinned vertices
+    std::vector<line_piece> reduce_line(unsigned i, const std::vector<point_type>& line_points, bool remove_collinear)
+    {
+        auto& l = lines[i];
+
+        // the extended point set still contains the removed vertices
+        auto pinned = find_pinned(l);
+        basic_vertex_reduction<coordinate_type> reduction(l, line_points, pinned, remove_collinear);
+        auto reduced = reduction();
+        l = std::move(reduced.line);
+        reduced_vertex_indices[i] = std::move(reduced.original_indices);
+
+        return split_at_pinned(i, pinned);
+    }
+
+    /// Same as preprocess_line, but takes the results from the snapshot.
+    /// prepare() always removes the collinear vertices, otherwise only the points of the snapshot are used.
+    std::vector<line_piece> snapshot_line(unsigned i, std::vector<point_type>& line_points)
+    {
+        line_points.clear();
+        for (auto idx : snapshot->candidates(i))
+        {
+            line_points.push_back(points[idx]);
+        }
+        if (!removes_collinear_vertices())
+        {
+            return reduce_line(i, line_points, false);
+        }
+
+        auto reduced_indices = snapshot->reduced_indices(i);
+        std::vector<coordinate_type> reduced_coordinates;
+        reduced_coordinates.reserve(reduced_indices.size());
+        for (auto idx : reduced_indices)
+        {
+            reduced_coordinates.push_back(lines[i].coordinates[idx]);
+        }
+        lines[i].coordinates = std::move(reduced_coordinates);
+        reduced_vertex_indices[i].assign(reduced_indices.begin(), reduced_indices.end());
+
+        std::vector<line_piece> pieces;
+        unsigned first_idx = 0;
+        for (auto last_idx : snapshot->piece_ends(i))
+        {
+            pieces.push_back(line_piece {i, first_idx, last_idx});
+            first_idx = last_idx;
+        }
+        return pieces;
+    }
+
+    /// Shortcuts of every line, sorted like the edges of a static_graph. Expects find_duplicate_lines().
+    /// line_complete is called with the index and the shortcuts of every line as soon as they are final,
+    /// possibly from several threads at once. A duplicate line is completed right after its original.
+    std::vector<std::vector<shortcut>> compute_shortcuts(const line_complete_callback& line_complete = line_complete_callback())
+    {
+        auto previous_idx = find_reusable_lines();
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            if (duplicate_of[i] != i)
+            {
+                previous_idx[i] = NO_PREVIOUS_LINE;
+            }
+        }
+        if (recording)
+        {
+            current_state.lines = lines;
+            current_state.points = points;
+            current_state.pinned_coordinates = pinned_coordinates;
+            current_state.engine = typeid(SimplificationT).name();
+            current_state.options = options;
+            current_state.quantization = quantization;
+            current_state.removes_collinear = removes_collinear_vertices();
+        }
+
+        // ensure crossing free simplification by extending the point set
+        for (const auto& l : lines)
+        {
+            for (const auto& c : l.coordinates)
+            {
+                points.push_back({l.id, static_cast<unsigned>(points.size()), c});
+            }
+        }
+
+        std::vector<std::vector<point_type>> line_points(lines.size());
+        std::vector<std::vector<line_piece>> line_pieces(lines.size());
+        std::vector<unsigned> line_removed_vertices(lines.size());
+        std::vector<std::uint64_t> line_keys(lines.size());
+        std::vector<std::vector<shortcut>> resumed_shortcuts(lines.size());
+        std::vector<char> line_resumed(lines.size(), false);
+        std::vector<char> line_fell_back(lines.size(), false);
+        reduced_vertex_indices.assign(lines.size(), std::vector<unsigned>());
+
+        util::parallel_for(num_threads, lines.size(),
+            [&](std::size_t i)
+            {
+                auto& l = lines[i];
+                if (duplicate_of[i] != i)
+                {
+                    return;
+                }
+                if (previous_idx[i] != NO_PREVIOUS_LINE)
+                {
+                    const auto& previous = previous_state.line_states[previous_idx[i]];
+                    line_removed_vertices[i] = l.coordinates.size() - previous.reduced_line.coordinates.size();
+                    l = previous.reduced_line;
+                    reduced_vertex_indices[i] = previous.reduced_indices;
+                    return;
+                }
+
+                auto num_vertices = l.coordinates.size();
+                if (snapshot != nullptr)
+                {
+                    line_pieces[i] = snapshot_line(i, line_points[i]);
+                }
+                else
+                {
+                    line_pieces[i] = preprocess_line(i, line_points[i], removes_collinear_vertices());
+                }
+                line_removed_vertices[i] = num_vertices - l.coordinates.size();
+
+                if (checkpoint != nullptr)
+                {
+                    line_keys[i] = checkpoint_key(l, line_points[i], line_pieces[i]);
+                    bool fell_back = false;
+                    if (checkpoint->find(l.id, line_keys[i], resumed_shortcuts[i], fell_back))
+                    {
+                        line_resumed[i] = true;
+                        line_fell_back[i] = fell_back;
+                        line_pieces[i].clear();
+                    }
+                }
+            });
+
+        // duplicates take the reduced line of the first copy
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            auto c = duplicate_of[i];
+            if (c == i)
+            {
+                continue;
+            }
+
+            unsigned last_idx = lines[i].coordinates.size() - 1;
+            line_removed_vertices[i] = lines[i].coordinates.size() - lines[c].coordinates.size();
+            lines[i].coordinates = lines[c].coordinates;
+            reduced_vertex_indices[i] = reduced_vertex_indices[c];
+            if (reversed_duplicate[i])
+            {
+                std::reverse(lines[i].coordinates.begin(), lines[i].coordinates.end());
+                std::reverse(reduced_vertex_indices[i].begin(), reduced_vertex_indices[i].end());
+                for (auto& idx : reduced_vertex_indices[i])
+                {
+                    idx = last_idx - idx;
+                }
+            }
+        }
+
+        num_removed_vertices = std::accumulate(line_removed_vertices.begin(), line_removed_vertices.end(), 0u);
+        std::cout << "Removed " << num_removed_vertices << " redundant vertices." << std::endl;
+        num_reused_lines = std::count_if(previous_idx.begin(), previous_idx.end(),
+                                         [](unsigned idx) { return idx != NO_PREVIOUS_LINE; });
+        if (has_previous_state)
+        {
+            std::cout << "Reused " << num_reused_lines << " of " << lines.size() << " lines." << std::endl;
+        }
+        if (checkpoint != nullptr)
+        {
+            auto num_resumed = std::count(line_resumed.begin(), line_resumed.end(), true);
+            std::cout << "Resumed " << num_resumed << " of " << lines.size() << " lines from the checkpoint." << std::endl;
+        }
+
+        std::vector<line_piece> pieces;
+        std::vector<unsigned> first_piece {0};
+        for (const auto& p : line_pieces)
+        {
+            pieces.insert(pieces.end(), p.begin(), p.end());
+            first_piece.push_back(pieces.size());
+        }
+
+        std::vector<std::vector<unsigned>> copies(lines.size());
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            if (duplicate_of[i] != i)
+            {
+                copies[duplicate_of[i]].push_back(i);
+            }
+        }
+
+        std::vector<std::vector<shortcut>> collected_shorcuts(lines.size());
+        auto complete_line = [&](unsigned line_idx)
+        {
+            if (line_complete)
+            {
+                line_complete(line_idx, collected_shorcuts[line_idx]);
+            }
+            for (auto c : copies[line_idx])
+            {
+                collected_shorcuts[c] = duplicate_shortcuts(c, collected_shorcuts[line_idx]);
+                if (line_complete)
+                {
+                    line_complete(c, collected_shorcuts[c]);
+                }
+            }
+        };
+
+        // lines without pieces are already complete
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            if (previous_idx[i] != NO_PREVIOUS_LINE)
+            {
+                collected_shorcuts[i] = previous_state.line_states[previous_idx[i]].shortcuts;
+                complete_line(i);
+            }
+            else if (line_resumed[i])
+            {
+                collected_shorcuts[i] = std::move(resumed_shortcuts[i]);
+                complete_line(i);
+            }
+        }
+
+        // the pieces already run in parallel, the engines share the remaining threads
+        engine_threads = std::max(1u, options.num_threads
+                                      / static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(num_threads, pieces.size()))));
+
+        // the last piece of a line to finish stitches the pieces back together
+        std::vector<std::atomic<unsigned>> remaining_pieces(lines.size());
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            remaining_pieces[i].store(first_piece[i + 1] - first_piece[i]);
+        }
+
+        std::vector<std::vector<shortcut>> piece_shortcuts(pieces.size());
+        std::vector<char> piece_fell_back(pieces.size(), false);
+        util::parallel_for(num_threads, pieces.size(),
+            [&](std::size_t k)
+            {
+                bool fell_back = false;
+                auto line_idx = pieces[k].line_idx;
+                piece_shortcuts[k] = simplify_piece(pieces[k], line_points[line_idx], fell_back);
+                piece_fell_back[k] = fell_back;
+
+                if (remaining_pieces[line_idx].fetch_sub(1) != 1)
+                {
+                    return;
+                }
+
+                auto& line_shortcuts = collected_shorcuts[line_idx];
+                bool line_fell_back = false;
+                for (auto piece_idx = first_piece[line_idx]; piece_idx < first_piece[line_idx + 1]; ++piece_idx)
+                {
+                    line_shortcuts.insert(line_shortcuts.end(), piece_shortcuts[piece_idx].begin(), piece_shortcuts[piece_idx].end());
+                    line_fell_back = line_fell_back || piece_fell_back[piece_idx];
+                    std::vector<shortcut>().swap(piece_shortcuts[piece_idx]);
+                }
+                if (checkpoint != nullptr)
+                {
+                    checkpoint->append(lines[line_idx].id, line_keys[line_idx], line_shortcuts, line_fell_back);
+                }
+                complete_line(line_idx);
+            });
+
+        for (auto k = 0u; k < pieces.size(); ++k)
+        {
+            line_fell_back[pieces[k].line_idx] = line_fell_back[pieces[k].line_idx] || piece_fell_back[k];
+        }
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            line_fell_back[i] = line_fell_back[duplicate_of[i]];
+        }
+        fallback_line_ids.clear();
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            if (line_fell_back[i])
+            {
+                fallback_line_ids.push_back(lines[i].id);
+            }
+        }
+        if (!fallback_line_ids.empty())
+        {
+            std::cout << fallback_line_ids.size() << " lines exceeded the work budget and were simplified with a window of "
+                      << fallback_options().window.max_vertices << " vertices:";
+            for (auto id : fallback_line_ids)
+            {
+                std::cout << " " << id;
+            }
+            std::cout << std::endl;
+        }
+
+        if (recording)
+        {
+            current_state.line_states.resize(lines.size());
+            for (auto i = 0u; i < lines.size(); ++i)
+            {
+                current_state.line_states[i] = typename state_type::line_state {lines[i], reduced_vertex_indices[i], collected_shorcuts[i]};
+            }
+        }
 
-            num_used_edges += path_info.distance[num_nodes-1];
-            simplified[i].id = lines[i].id;
+        return collected_shorcuts;
+    }
 
-            std::deque<coordinate> simplified_path;
-            unsigned current_parent_idx = num_nodes-1;
-            while (current_parent_idx != 0)
+    std::vector<line_type> select_shortcuts(unsigned max_edges, std::vector<std::vector<shortcut>>&& in_shortcut_lists)
+    {
+        std::vector<std::vector<shortcut>> shortcut_lists(in_shortcut_lists);
+        std::vector<line_type> simplified(shortcut_lists.size());
+
+        simplified_vertex_indices.assign(shortcut_lists.size(), std::vector<unsigned>());
+
+        num_used_edges = 0;
+        for (auto i = 0u; i < shortcut_lists.size(); ++i)
+        {
+            // copies of a line use the same path, so shared borders stay identical
+            if (duplicate_of[i] != i)
             {
-                simplified_path.push_front(lines[i].coordinates[current_parent_idx]);
-                current_parent_idx = path_info.parents[current_parent_idx];
+                copy_simplified_line(i, simplified);
+                num_used_edges += simplified[i].coordinates.size() - 1;
+                continue;
             }
-            simplified_path.push_front(lines[i].coordinates.front());
-            simplified[i].coordinates = std::vector<coordinate>(simplified_path.begin(), simplified_path.end());
 
-            BOOST_ASSERT(path_info.distance[num_nodes-1] == simplified[i].coordinates.size() - 1);
+            select_path(i, std::move(shortcut_lists[i]), simplified[i]);
+            num_used_edges += simplified[i].coordinates.size() - 1;
         }
 
+        report_used_edges(max_edges);
+        return simplified;
+    }
+
+    /// Sets the simplified line to the shortest path through the shortcuts of line line_idx
+    void select_path(unsigned line_idx, std::vector<shortcut>&& shortcuts, line_type& simplified_line)
+    {
+        auto num_nodes = lines[line_idx].coordinates.size();
+        static_graph<shortcut> shortcut_graph(num_nodes, std::move(shortcuts));
+        auto simplified_path = graph_util::shortest_dag_path_nodes(shortcut_graph, 0, num_nodes-1);
+
+        simplified_line.id = lines[line_idx].id;
+        simplified_vertex_indices[line_idx].clear();
+        for (auto idx : simplified_path)
+        {
+            simplified_line.coordinates.push_back(lines[line_idx].coordinates[idx]);
+            simplified_vertex_indices[line_idx].push_back(reduced_vertex_indices[line_idx][idx]);
+        }
+    }
+
+    void report_used_edges(unsigned max_edges) const
+    {
         if (num_used_edges > max_edges)
         {
             std::cout << "Warning: There is no simplification using " << max_edges << " edges. " << num_used_edges << " edges is a minimum" << std::endl;
@@ -80,13 +1157,40 @@ private:
         {
             std::cout << "Used " << num_used_edges << " edges." << std::endl;
         }
-
-        return simplified;
     }
 
-    std::vector<poly_line> lines;
-    std::vector<point> points;
+    std::vector<line_type> lines;
+    std::vector<point_type> points;
+    std::vector<std::vector<unsigned>> reduced_vertex_indices;
+    std::vector<std::vector<unsigned>> simplified_vertex_indices;
+    std::vector<coordinate_type> pinned_coordinates;
+    std::vector<unsigned> fallback_line_ids;
+    /// Index of the first line with the same coordinates, the line itself if there is none
+    std::vector<unsigned> duplicate_of;
+    std::vector<char> reversed_duplicate;
+    shortcut_cache* cache = nullptr;
+    simplification_checkpoint* checkpoint = nullptr;
+    const snapshot_type* snapshot = nullptr;
+    state_type previous_state;
+    state_type current_state;
+    bool has_previous_state = false;
+    quantization_parameters quantization;
+    bool recording = false;
+    bool allocate_edges = false;
+    bool computes_levels = false;
+    double allocated_deviation = std::numeric_limits<double>::infinity();
+    simplification_options options;
+    unsigned num_removed_vertices = 0;
+    unsigned num_reused_lines = 0;
+    unsigned num_duplicate_lines = 0;
+    unsigned num_used_edges = 0;
+    unsigned num_threads = 1;
+    /// threads of each SimplificationT, see engine_options()
+    unsigned engine_threads = 1;
 };
 
+template<typename SimplificationT, typename PointFilterT>
+constexpr unsigned map_simplification<SimplificationT, PointFilterT>::NO_PREVIOUS_LINE;
+
 #endif
 
@@ -2,7 +2,9 @@
 
 #include <algorithm>
 
-std::vector<monotone_decomposition::monotone_subpath> monotone_decomposition::get_monotone_subpaths(const poly_line& line) const
+template<typename CoordinateT>
+std::vector<typename basic_monotone_decomposition<CoordinateT>::monotone_subpath>
+basic_monotone_decomposition<CoordinateT>::get_monotone_subpaths(const basic_poly_line<CoordinateT>& line) const
 {
     const auto& path = line.coordinates;
     BOOST_ASSERT(path.size() >= 2);
@@ -40,8 +42,8 @@ std::vector<monotone_decomposition::monotone_subpath> monotone_decomposition::ge
 
         if (next_mono == geometry::monoticity::INVALID)
         {
-            subpaths.emplace_back(monotone_decomposition::monotone_subpath {
-                                    poly_line {line.id, std::vector<coordinate>(path.begin() + last_pos, path.begin() + (i+1))},
+            subpaths.emplace_back(monotone_subpath {
+                                    basic_poly_line<CoordinateT> {line.id, std::vector<CoordinateT>(path.begin() + last_pos, path.begin() + (i+1))},
                                     last_pos,
                                     i+1,
                                     mono
@@ -56,8 +58,8 @@ std::vector<monotone_decomposition::monotone_subpath> monotone_decomposition::ge
     }
 
     // finish last subpath
-    subpaths.emplace_back(monotone_decomposition::monotone_subpath {
-                            poly_line {line.id, std::vector<coordinate>(path.begin() + last_pos, path.end())},
+    subpaths.emplace_back(monotone_subpath {
+                            basic_poly_line<CoordinateT> {line.id, std::vector<CoordinateT>(path.begin() + last_pos, path.end())},
                             last_pos,
                             static_cast<unsigned>(path.size()),
                             mono
@@ -65,3 +67,8 @@ std::vector<monotone_decomposition::monotone_subpath> monotone_decomposition::ge
 
     return subpaths;
 }
+
+template class basic_monotone_decomposition<coordinate>;
+template class basic_monotone_decomposition<local_coordinate>;
+template class basic_monotone_decomposition<quantized_coordinate>;
+template class basic_monotone_decomposition<compact_quantized_coordinate>;
@@ -10,18 +10,19 @@
 #include <vector>
 
 
-class monotone_decomposition
+template<typename CoordinateT>
+class basic_monotone_decomposition
 {
 public:
     struct monotone_subpath
     {
-        poly_line line;
+        basic_poly_line<CoordinateT> line;
         unsigned begin_idx;
         unsigned end_idx;
         geometry::monoticity mono;
     };
 
-    std::vector<monotone_subpath> operator()(const poly_line& line)
+    std::vector<monotone_subpath> operator()(const basic_poly_line<CoordinateT>& line)
     {
         auto subpaths = get_monotone_subpaths(line);
         for (auto& s : subpaths)
@@ -33,7 +34,9 @@ public:
     }
 
 private:
-    std::vector<monotone_subpath> get_monotone_subpaths(const poly_line& line) const;
+    std::vector<monotone_subpath> get_monotone_subpaths(const basic_poly_line<CoordinateT>& line) const;
 };
 
+using monotone_decomposition = basic_monotone_decomposition<coordinate>;
+
 #endif
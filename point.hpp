@@ -2,20 +2,77 @@
 #define POINT_HPP
 
 #include <glm/glm.hpp>
+#include <glm/gtc/type_precision.hpp>
+
+#include <climits>
 #include <iostream>
 
 using coordinate = glm::dvec2;
+/// Coordinates on a quantized integer grid, see quantizer.hpp
+using quantized_coordinate = glm::i64vec2;
+/// Quantized coordinates if the extent of the data fits into 32bit offsets
+using compact_quantized_coordinate = glm::i32vec2;
+/// Single precision coordinates relative to a local origin, see local_frame_simplification.hpp
+using local_coordinate = glm::f32vec2;
+
+/// Selects the types used to evaluate geometric predicates.
+/// The wide_type is big enough to hold the product of two coordinate
+/// differences exactly (for integer coordinates) or at least without
+/// loosing precision compared to the input (for floating point coordinates).
+template<typename CoordinateT>
+struct coordinate_traits;
+
+template<>
+struct coordinate_traits<coordinate>
+{
+    using value_type = double;
+    using wide_type = double;
+    static constexpr bool is_exact = false;
+};
 
-struct point
+template<>
+struct coordinate_traits<local_coordinate>
 {
+    using value_type = float;
+    using wide_type = double;
+    static constexpr bool is_exact = false;
+};
+
+template<>
+struct coordinate_traits<quantized_coordinate>
+{
+    using value_type = glm::i64;
+    using wide_type = __int128;
+    static constexpr bool is_exact = true;
+};
+
+template<>
+struct coordinate_traits<compact_quantized_coordinate>
+{
+    using value_type = glm::i32;
+    using wide_type = glm::i64;
+    static constexpr bool is_exact = true;
+};
+
+template<typename CoordinateT>
+struct basic_point
+{
+    using coordinate_type = CoordinateT;
+
     static constexpr unsigned NO_LINE_ID = UINT_MAX;
     // id of the line this point belongs to, NO_LINE_ID if its an external point
     unsigned line_id;
     unsigned id;
-    coordinate location;
+    CoordinateT location;
 };
 
-inline std::ostream& operator<<(std::ostream& lhs, const coordinate& rhs)
+template<typename CoordinateT>
+constexpr unsigned basic_point<CoordinateT>::NO_LINE_ID;
+
+using point = basic_point<coordinate>;
+
+template<typename T, glm::precision P>
+inline std::ostream& operator<<(std::ostream& lhs, const glm::tvec2<T, P>& rhs)
 {
     lhs << "("  << rhs.x << ", " << rhs.y << ")";
     return lhs;
@@ -1,5 +1,6 @@
 #include "point_distributor.hpp"
 #include "geometry.hpp"
+#include "geometry_kernels.hpp"
 #include "util.hpp"
 #include "sweepline_state.hpp"
 
@@ -11,29 +12,39 @@
 /// Returns an assignment of points for the given tangents that each imply a facet
 ///
 /// The sweep line algorithm only works if std::stable_sort is used, since the vertices are originally sorted by x-coordinate!
-std::vector<point_distributor::point_assignment> point_distributor::operator()(unsigned i, const std::vector<shortcut>& tangents) const
+template<typename CoordinateT>
+std::vector<typename basic_point_distributor<CoordinateT>::point_assignment>
+basic_point_distributor<CoordinateT>::operator()(unsigned i, const std::vector<shortcut>& tangents, unsigned end) const
 {
-    std::vector<point_distributor::point_assignment> assignments;
+    BOOST_ASSERT(end <= line.coordinates.size());
+    std::vector<point_assignment> assignments;
 
-    const coordinate& origin = line.coordinates[i];
-    auto slope_cmp = [&origin](const coordinate& lhs, const coordinate& rhs)
+    const CoordinateT& origin = line.coordinates[i];
+    auto slope_cmp = [&origin](const CoordinateT& lhs, const CoordinateT& rhs)
                      {
                           return geometry::slope_compare(origin, lhs, rhs);
                      };
 
     unsigned points_begin_idx = right_of_vertex_index[i];
-    auto point_odering = util::compute_odering(point_coordinates.begin() + points_begin_idx, point_coordinates.end(),
+    auto points_end = point_coordinates.end();
+    if (end < line.coordinates.size())
+    {
+        // the line is x-monotone, so points right of the window can't be inside any facette
+        points_end = std::upper_bound(point_coordinates.begin() + points_begin_idx, point_coordinates.end(), line.coordinates[end - 1].x,
+                                      [](const typename coordinate_traits<CoordinateT>::value_type x, const CoordinateT& c) { return x < c.x; });
+    }
+    auto point_odering = util::compute_odering(point_coordinates.begin() + points_begin_idx, points_end,
                                                slope_cmp);
 
     unsigned vertex_begin_idx = i + 1;
-    auto vertex_odering = util::compute_odering(line.coordinates.begin() + vertex_begin_idx, line.coordinates.end(),
+    auto vertex_odering = util::compute_odering(line.coordinates.begin() + vertex_begin_idx, line.coordinates.begin() + end,
                                                 slope_cmp);
 
     auto num_vertices = vertex_odering.size();
 
-    sweepline_state state(line.coordinates, i);
+    basic_sweepline_state<CoordinateT> state(line.coordinates, i);
 
-    using edge_assignment = std::pair<sweepline_state::edge, unsigned>;
+    using edge_assignment = std::pair<typename basic_sweepline_state<CoordinateT>::edge, unsigned>;
     std::vector<edge_assignment> edge_assignments;
 
     auto point_vertex_compare =
@@ -59,41 +70,67 @@ std::vector<point_distributor::point_assignment> point_distributor::operator()(u
             }
         };
 
+    // orientation of every edge k -> k+1 after the vertex i relative to the origin,
+    // indexed by k - vertex_begin_idx
+    std::vector<signed char> edge_signs(num_vertices > 0 ? num_vertices - 1 : 0);
+    const auto* x = line_coordinates.x.data();
+    const auto* y = line_coordinates.y.data();
+    geometry_kernels::orientation_signs(origin, x + vertex_begin_idx, y + vertex_begin_idx,
+                                        x + vertex_begin_idx + 1, y + vertex_begin_idx + 1,
+                                        edge_signs.size(), edge_signs.data());
+
+    // Same as geometry::slope_compare(origin, first, second) for an edge with the given orientation.
+    // Since the orientation is antisymmetric slope_compare(origin, second, first) is the same as
+    // calling this with the negated orientation.
+    auto edge_slope_compare =
+        [&origin](signed char sign, const CoordinateT& first, const CoordinateT& second)
+        {
+            return sign < 0 || (sign == 0 && geometry::dot(origin, first, second) < 0);
+        };
+
     // We don't insert segments that are _on_ the sweep line.
     // This only works because we can be sure there is no point on a line segment.
     auto process_vertex =
-        [this, num_vertices, vertex_begin_idx, &origin, &state](const std::size_t& vertex_idx)
+        [this, num_vertices, vertex_begin_idx, &edge_signs, &edge_slope_compare, &state](const std::size_t& vertex_idx)
         {
             state.move_sweepline(line.coordinates[vertex_begin_idx + vertex_idx]);
 
+            const auto& current = line.coordinates[vertex_begin_idx + vertex_idx];
+
             // insert edge to the next vertex
             // ignores last vertex because there is no next vertex
             if (vertex_idx < num_vertices - 1)
             {
+                const auto& next = line.coordinates[vertex_begin_idx + vertex_idx + 1];
+                auto sign = edge_signs[vertex_idx];
+
                 // next edge goes down -> new to sweep line
-                if (geometry::slope_compare(origin, line.coordinates[vertex_begin_idx + vertex_idx], line.coordinates[vertex_begin_idx + vertex_idx + 1]))
+                if (edge_slope_compare(sign, current, next))
                 {
-                    state.insert_edge(sweepline_state::edge {vertex_begin_idx + vertex_idx, vertex_begin_idx + vertex_idx + 1});
+                    state.insert_edge(typename basic_sweepline_state<CoordinateT>::edge {vertex_begin_idx + vertex_idx, vertex_begin_idx + vertex_idx + 1});
                 }
                 // edge goes up -> does not intersect anymore
-                else if (geometry::slope_compare(origin, line.coordinates[vertex_begin_idx + vertex_idx + 1], line.coordinates[vertex_begin_idx + vertex_idx]))
+                else if (edge_slope_compare(-sign, next, current))
                 {
-                    state.remove_edge(sweepline_state::edge {vertex_begin_idx + vertex_idx, vertex_begin_idx + vertex_idx + 1});
+                    state.remove_edge(typename basic_sweepline_state<CoordinateT>::edge {vertex_begin_idx + vertex_idx, vertex_begin_idx + vertex_idx + 1});
                 }
             }
             // insert edge to previous vertex
             // ignores the first and also the second vertices because edges to first vertex are always on the sweepline
             if (vertex_idx > 0)
             {
+                const auto& previous = line.coordinates[vertex_begin_idx + vertex_idx - 1];
+                auto sign = edge_signs[vertex_idx - 1];
+
                 // previous edge goes down -> new to sweep line
-                if (geometry::slope_compare(origin, line.coordinates[vertex_begin_idx + vertex_idx], line.coordinates[vertex_begin_idx + vertex_idx - 1]))
+                if (edge_slope_compare(-sign, current, previous))
                 {
-                    state.insert_edge(sweepline_state::edge {vertex_begin_idx + vertex_idx - 1, vertex_begin_idx + vertex_idx});
+                    state.insert_edge(typename basic_sweepline_state<CoordinateT>::edge {vertex_begin_idx + vertex_idx - 1, vertex_begin_idx + vertex_idx});
                 }
                 // edge goes up -> does not intersect anymore
-                else if (geometry::slope_compare(origin, line.coordinates[vertex_begin_idx + vertex_idx - 1], line.coordinates[vertex_begin_idx + vertex_idx]))
+                else if (edge_slope_compare(sign, previous, current))
                 {
-                    state.remove_edge(sweepline_state::edge {vertex_begin_idx + vertex_idx - 1, vertex_begin_idx + vertex_idx});
+                    state.remove_edge(typename basic_sweepline_state<CoordinateT>::edge {vertex_begin_idx + vertex_idx - 1, vertex_begin_idx + vertex_idx});
                 }
             }
         };
@@ -173,13 +210,14 @@ std::vector<point_distributor::point_assignment> point_distributor::operator()(u
 
 /// Sorts points and builds up lookup array for each vertex
 /// to determine which points are right of it
-void point_distributor::prepare_points(std::vector<point>& points,
-                                       std::vector<unsigned>& right_of_vertex_index,
-                                       std::vector<coordinate>& point_coordinates) const
+template<typename CoordinateT>
+void basic_point_distributor<CoordinateT>::prepare_points(std::vector<basic_point<CoordinateT>>& points,
+                                                          std::vector<unsigned>& right_of_vertex_index,
+                                                          std::vector<CoordinateT>& point_coordinates) const
 {
     // sort points by x coordinate
     std::sort(points.begin(), points.end(),
-              [](const point& lhs, const point& rhs)
+              [](const basic_point<CoordinateT>& lhs, const basic_point<CoordinateT>& rhs)
               {
                 return lhs.location.x < rhs.location.x;
               });
@@ -187,7 +225,7 @@ void point_distributor::prepare_points(std::vector<point>& points,
     // extract coordinates
     point_coordinates.resize(points.size());
     std::transform(points.begin(), points.end(), point_coordinates.begin(),
-                   [](const point& p)
+                   [](const basic_point<CoordinateT>& p)
                    {
                      return p.location;
                    });
@@ -206,3 +244,8 @@ void point_distributor::prepare_points(std::vector<point>& points,
         vertex_idx++;
     }
 }
+
+template class basic_point_distributor<coordinate>;
+template class basic_point_distributor<local_coordinate>;
+template class basic_point_distributor<quantized_coordinate>;
+template class basic_point_distributor<compact_quantized_coordinate>;
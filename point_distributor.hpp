@@ -3,32 +3,44 @@
 
 #include "poly_line.hpp"
 #include "shortcut.hpp"
+#include "geometry_kernels.hpp"
 
 #include <algorithm>
 #include <vector>
 #include <memory>
 
-class point_distributor
+template<typename CoordinateT>
+class basic_point_distributor
 {
 public:
-    using point_assignment = std::pair<point, unsigned>;
+    using point_assignment = std::pair<basic_point<CoordinateT>, unsigned>;
 
-    point_distributor(const poly_line& original_line, const std::vector<point>& in_points)
+    basic_point_distributor(const basic_poly_line<CoordinateT>& original_line, const std::vector<basic_point<CoordinateT>>& in_points)
         : line(original_line)
         , points(in_points)
+        , line_coordinates(original_line.coordinates.begin(), original_line.coordinates.end())
     {
         prepare_points(points, right_of_vertex_index, point_coordinates);
     }
 
-    std::vector<point_assignment> operator()(unsigned i, const std::vector<shortcut>& tangents) const;
+    std::vector<point_assignment> operator()(unsigned i, const std::vector<shortcut>& tangents) const
+    {
+        return (*this)(i, tangents, line.coordinates.size());
+    }
+
+    /// Only considers the vertices before end and the points left of the vertex end-1
+    std::vector<point_assignment> operator()(unsigned i, const std::vector<shortcut>& tangents, unsigned end) const;
 
 private:
-    void prepare_points(std::vector<point>& points, std::vector<unsigned>& right_of_vertex_index, std::vector<coordinate>& point_coordinates) const;
+    void prepare_points(std::vector<basic_point<CoordinateT>>& points, std::vector<unsigned>& right_of_vertex_index, std::vector<CoordinateT>& point_coordinates) const;
 
-    const poly_line& line;
-    std::vector<point> points;
-    std::vector<coordinate> point_coordinates;
+    const basic_poly_line<CoordinateT>& line;
+    std::vector<basic_point<CoordinateT>> points;
+    geometry_kernels::coordinate_array<CoordinateT> line_coordinates;
+    std::vector<CoordinateT> point_coordinates;
     std::vector<unsigned> right_of_vertex_index;
 };
 
+using point_distributor = basic_point_distributor<coordinate>;
+
 #endif
@@ -0,0 +1,124 @@
+#ifndef POINT_GRID_HPP
+#define POINT_GRID_HPP
+
+#include "point.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+/// Uniform grid over a set of locations that reports all locations inside a query box.
+///
+/// The grid has about one cell per location. The locations of a cell are stored
+/// consecutively, so a query only touches the cells overlapping the box.
+template<typename CoordinateT>
+class basic_point_grid
+{
+public:
+    basic_point_grid(const std::vector<CoordinateT>& in_locations)
+    : locations(in_locations)
+    {
+        if (locations.empty())
+        {
+            return;
+        }
+
+        min_x = max_x = static_cast<double>(locations.front().x);
+        min_y = max_y = static_cast<double>(locations.front().y);
+        for (const auto& l : locations)
+        {
+            min_x = std::min(min_x, static_cast<double>(l.x));
+            min_y = std::min(min_y, static_cast<double>(l.y));
+            max_x = std::max(max_x, static_cast<double>(l.x));
+            max_y = std::max(max_y, static_cast<double>(l.y));
+        }
+
+        num_columns = num_rows = std::max(1u, static_cast<unsigned>(std::sqrt(static_cast<double>(locations.size()))));
+        cell_width = std::max((max_x - min_x) / num_columns, std::numeric_limits<double>::min());
+        cell_height = std::max((max_y - min_y) / num_rows, std::numeric_limits<double>::min());
+
+        // counting sort of the locations by cell
+        cell_begin.assign(num_columns * num_rows + 1, 0);
+        std::vector<unsigned> cells(locations.size());
+        for (auto idx = 0u; idx < locations.size(); ++idx)
+        {
+            cells[idx] = cell(column(locations[idx].x), row(locations[idx].y));
+            ++cell_begin[cells[idx] + 1];
+        }
+        for (auto c = 1u; c < cell_begin.size(); ++c)
+        {
+            cell_begin[c] += cell_begin[c - 1];
+        }
+        cell_locations.resize(locations.size());
+        auto cell_end = cell_begin;
+        for (auto idx = 0u; idx < locations.size(); ++idx)
+        {
+            cell_locations[cell_end[cells[idx]]++] = idx;
+        }
+    }
+
+    /// Calls op(idx) for every location idx inside of the closed box [min, max]
+    template<typename OpT>
+    void query(const CoordinateT& min, const CoordinateT& max, OpT op) const
+    {
+        if (locations.empty())
+        {
+            return;
+        }
+
+        auto first_column = column(min.x);
+        auto last_column = column(max.x);
+        auto first_row = row(min.y);
+        auto last_row = row(max.y);
+        for (auto r = first_row; r <= last_row; ++r)
+        {
+            for (auto c = first_column; c <= last_column; ++c)
+            {
+                auto id = cell(c, r);
+                for (auto k = cell_begin[id]; k < cell_begin[id + 1]; ++k)
+                {
+                    const auto& l = locations[cell_locations[k]];
+                    if (l.x >= min.x && l.x <= max.x && l.y >= min.y && l.y <= max.y)
+                    {
+                        op(cell_locations[k]);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    template<typename ValueT>
+    unsigned column(ValueT x) const
+    {
+        auto c = std::floor((static_cast<double>(x) - min_x) / cell_width);
+        return static_cast<unsigned>(std::max(0.0, std::min(c, num_columns - 1.0)));
+    }
+
+    template<typename ValueT>
+    unsigned row(ValueT y) const
+    {
+        auto r = std::floor((static_cast<double>(y) - min_y) / cell_height);
+        return static_cast<unsigned>(std::max(0.0, std::min(r, num_rows - 1.0)));
+    }
+
+    unsigned cell(unsigned c, unsigned r) const
+    {
+        return r * num_columns + c;
+    }
+
+    const std::vector<CoordinateT>& locations;
+    double min_x = 0;
+    double min_y = 0;
+    double max_x = 0;
+    double max_y = 0;
+    double cell_width = 1;
+    double cell_height = 1;
+    unsigned num_columns = 0;
+    unsigned num_rows = 0;
+    std::vector<unsigned> cell_begin;
+    std::vector<unsigned> cell_locations;
+};
+
+#endif
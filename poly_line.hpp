@@ -5,10 +5,15 @@
 
 #include <vector>
 
-struct poly_line
+template<typename CoordinateT>
+struct basic_poly_line
 {
+    using coordinate_type = CoordinateT;
+
     unsigned id;
-    std::vector<coordinate> coordinates;
+    std::vector<CoordinateT> coordinates;
 };
 
+using poly_line = basic_poly_line<coordinate>;
+
 #endif
@@ -0,0 +1,391 @@
+#ifndef PREPROCESSING_SNAPSHOT_HPP
+#define PREPROCESSING_SNAPSHOT_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Input of a simplification together with everything it computes before simplifying a line,
+/// see map_simplification::prepare()
+template<typename CoordinateT>
+struct basic_preprocessing
+{
+    struct line_preprocessing
+    {
+        /// Indices of the points in the bounding box of the line in the extended point set,
+        /// which are the input points followed by the vertices of all lines
+        std::vector<unsigned> candidates;
+        /// Indices of the vertices that are left after the vertex reduction
+        std::vector<unsigned> reduced_indices;
+        /// Last vertex of every piece of the reduced line
+        std::vector<unsigned> piece_ends;
+    };
+
+    std::vector<basic_poly_line<CoordinateT>> lines;
+    std::vector<basic_point<CoordinateT>> points;
+    std::vector<CoordinateT> pinned_coordinates;
+    std::vector<line_preprocessing> line_states;
+};
+
+/// Preprocessing of a map, written once by ./deberg prepare and memory mapped by every run.
+///
+/// Like basic_shortcut_graph_file the file is a header followed by 8 byte aligned arrays,
+/// so nothing is parsed on load. Only the candidates, reduced indices and piece ends are used in
+/// place and shared by several processes through the page cache. lines() and points() copy the
+/// input, since map_simplification owns it and appends the vertices to the points, so loading a
+/// snapshot still takes O(input) time and memory per process, just without parsing.
+/// Every per line array is indexed by a global offset array with a sentinel.
+template<typename CoordinateT>
+class basic_preprocessing_snapshot
+{
+public:
+    using value_type = typename coordinate_traits<CoordinateT>::value_type;
+    using line_type = basic_poly_line<CoordinateT>;
+    using point_type = basic_point<CoordinateT>;
+
+    /// Indices of a single line inside of the mapping
+    class index_range
+    {
+    public:
+        index_range(const std::uint32_t* first, const std::uint32_t* last)
+        : first(first)
+        , last(last)
+        {
+        }
+
+        const std::uint32_t* begin() const
+        {
+            return first;
+        }
+
+        const std::uint32_t* end() const
+        {
+            return last;
+        }
+
+        std::size_t size() const
+        {
+            return last - first;
+        }
+
+    private:
+        const std::uint32_t* first;
+        const std::uint32_t* last;
+    };
+
+    static void write(std::ostream& output, const basic_preprocessing<CoordinateT>& preprocessing)
+    {
+        header h;
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.value_size = sizeof(value_type);
+        h.padding = 0;
+        h.num_lines = preprocessing.lines.size();
+        h.num_points = preprocessing.points.size();
+        h.num_pinned = preprocessing.pinned_coordinates.size();
+        h.num_vertices = 0;
+        h.num_candidates = 0;
+        h.num_reduced = 0;
+        h.num_pieces = 0;
+        for (auto i = 0u; i < preprocessing.lines.size(); ++i)
+        {
+            h.num_vertices += preprocessing.lines[i].coordinates.size();
+            h.num_candidates += preprocessing.line_states[i].candidates.size();
+            h.num_reduced += preprocessing.line_states[i].reduced_indices.size();
+            h.num_pieces += preprocessing.line_states[i].piece_ends.size();
+        }
+        output.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+        std::uint64_t written = sizeof(h);
+        auto write_array = [&output, &written](const void* data, std::size_t bytes)
+        {
+            output.write(static_cast<const char*>(data), bytes);
+            written += bytes;
+            static const char zeros[ALIGNMENT] = {};
+            output.write(zeros, padding(written));
+            written += padding(written);
+        };
+        auto write_coordinates = [&write_array](const std::vector<CoordinateT>& coordinates)
+        {
+            std::vector<value_type> values;
+            values.reserve(2 * coordinates.size());
+            for (const auto& c : coordinates)
+            {
+                values.push_back(c.x);
+                values.push_back(c.y);
+            }
+            write_array(values.data(), values.size() * sizeof(value_type));
+        };
+        // the per line arrays of all lines and the offsets of every line
+        auto write_line_arrays = [&write_array](const std::vector<std::vector<unsigned>>& arrays)
+        {
+            std::vector<std::uint64_t> begin {0};
+            std::vector<std::uint32_t> values;
+            for (const auto& a : arrays)
+            {
+                values.insert(values.end(), a.begin(), a.end());
+                begin.push_back(values.size());
+            }
+            write_array(begin.data(), begin.size() * sizeof(std::uint64_t));
+            write_array(values.data(), values.size() * sizeof(std::uint32_t));
+        };
+
+        std::vector<std::uint32_t> line_ids;
+        std::vector<std::uint64_t> line_begin {0};
+        std::vector<CoordinateT> vertices;
+        for (const auto& l : preprocessing.lines)
+        {
+            line_ids.push_back(l.id);
+            vertices.insert(vertices.end(), l.coordinates.begin(), l.coordinates.end());
+            line_begin.push_back(vertices.size());
+        }
+        write_array(line_ids.data(), line_ids.size() * sizeof(std::uint32_t));
+        write_array(line_begin.data(), line_begin.size() * sizeof(std::uint64_t));
+        write_coordinates(vertices);
+
+        std::vector<std::uint32_t> point_ids;
+        std::vector<std::uint32_t> point_line_ids;
+        std::vector<CoordinateT> locations;
+        for (const auto& p : preprocessing.points)
+        {
+            point_ids.push_back(p.id);
+            point_line_ids.push_back(p.line_id);
+            locations.push_back(p.location);
+        }
+        write_array(point_ids.data(), point_ids.size() * sizeof(std::uint32_t));
+        write_array(point_line_ids.data(), point_line_ids.size() * sizeof(std::uint32_t));
+        write_coordinates(locations);
+        write_coordinates(preprocessing.pinned_coordinates);
+
+        std::vector<std::vector<unsigned>> candidates;
+        std::vector<std::vector<unsigned>> reduced_indices;
+        std::vector<std::vector<unsigned>> piece_ends;
+        for (const auto& s : preprocessing.line_states)
+        {
+            candidates.push_back(s.candidates);
+            reduced_indices.push_back(s.reduced_indices);
+            piece_ends.push_back(s.piece_ends);
+        }
+        write_line_arrays(candidates);
+        write_line_arrays(reduced_indices);
+        write_line_arrays(piece_ends);
+
+        if (!output)
+        {
+            throw std::runtime_error("Could not write the preprocessing snapshot.");
+        }
+    }
+
+    /// Maps the file read only
+    basic_preprocessing_snapshot(const std::string& file_path)
+    {
+        int fd = ::open(file_path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not open " + file_path + ".");
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(header))
+        {
+            ::close(fd);
+            throw std::runtime_error(file_path + " is not a preprocessing snapshot.");
+        }
+        mapped_size = info.st_size;
+        mapping = ::mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::runtime_error("Could not map " + file_path + ".");
+        }
+
+        try
+        {
+            locate_arrays(file_path);
+        }
+        catch (...)
+        {
+            ::munmap(mapping, mapped_size);
+            throw;
+        }
+    }
+
+    ~basic_preprocessing_snapshot()
+    {
+        ::munmap(mapping, mapped_size);
+    }
+
+    basic_preprocessing_snapshot(const basic_preprocessing_snapshot&) = delete;
+    basic_preprocessing_snapshot& operator=(const basic_preprocessing_snapshot&) = delete;
+
+    /// Number of lines
+    std::size_t size() const
+    {
+        return h->num_lines;
+    }
+
+    /// Number of input points, without the vertices of the extended point set
+    std::size_t num_points() const
+    {
+        return h->num_points;
+    }
+
+    /// Copies the lines out of the mapping
+    std::vector<line_type> lines() const
+    {
+        std::vector<line_type> copied(h->num_lines);
+        for (auto i = 0u; i < copied.size(); ++i)
+        {
+            copied[i].id = line_ids[i];
+            copied[i].coordinates.assign(vertices + line_begin[i], vertices + line_begin[i + 1]);
+        }
+        return copied;
+    }
+
+    /// Copies the input points out of the mapping
+    std::vector<point_type> points() const
+    {
+        std::vector<point_type> copied(h->num_points);
+        for (auto k = 0u; k < copied.size(); ++k)
+        {
+            copied[k].id = point_ids[k];
+            copied[k].line_id = point_line_ids[k];
+            copied[k].location = locations[k];
+        }
+        return copied;
+    }
+
+    std::vector<CoordinateT> pinned_coordinates() const
+    {
+        return std::vector<CoordinateT>(pinned, pinned + h->num_pinned);
+    }
+
+    index_range candidates(std::size_t line_idx) const
+    {
+        return line_range(candidate_begin, candidate_indices, line_idx);
+    }
+
+    index_range reduced_indices(std::size_t line_idx) const
+    {
+        return line_range(reduced_begin, reduced, line_idx);
+    }
+
+    index_range piece_ends(std::size_t line_idx) const
+    {
+        return line_range(piece_begin, pieces, line_idx);
+    }
+
+private:
+    struct header
+    {
+        char magic[8];
+        std::uint32_t value_size;
+        std::uint32_t padding;
+        std::uint64_t num_lines;
+        std::uint64_t num_points;
+        std::uint64_t num_pinned;
+        std::uint64_t num_vertices;
+        std::uint64_t num_candidates;
+        std::uint64_t num_reduced;
+        std::uint64_t num_pieces;
+    };
+
+    static constexpr std::size_t ALIGNMENT = 8;
+    static constexpr char MAGIC[8] = {'D', 'B', 'P', 'R', 'E', 'P', '0', '1'};
+
+    static std::size_t padding(std::uint64_t offset)
+    {
+        return (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT;
+    }
+
+    static index_range line_range(const std::uint64_t* begin, const std::uint32_t* values, std::size_t line_idx)
+    {
+        return index_range(values + begin[line_idx], values + begin[line_idx + 1]);
+    }
+
+    void locate_arrays(const std::string& file_path)
+    {
+        h = static_cast<const header*>(mapping);
+        if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw std::runtime_error(file_path + " is not a preprocessing snapshot.");
+        }
+        if (h->value_size != sizeof(value_type))
+        {
+            throw std::runtime_error(file_path + " uses a different coordinate type.");
+        }
+
+        std::uint64_t offset = sizeof(header);
+        auto next_array = [&](std::uint64_t bytes)
+        {
+            if (offset + bytes > mapped_size)
+            {
+                throw std::runtime_error(file_path + " is truncated.");
+            }
+            const auto* array = static_cast<const char*>(mapping) + offset;
+            offset += bytes + padding(offset + bytes);
+            return array;
+        };
+        auto next_indices = [&](std::uint64_t size)
+        {
+            return reinterpret_cast<const std::uint32_t*>(next_array(size * sizeof(std::uint32_t)));
+        };
+        auto next_offsets = [&]()
+        {
+            return reinterpret_cast<const std::uint64_t*>(next_array((h->num_lines + 1) * sizeof(std::uint64_t)));
+        };
+        auto next_coordinates = [&](std::uint64_t size)
+        {
+            return reinterpret_cast<const CoordinateT*>(next_array(size * 2 * sizeof(value_type)));
+        };
+
+        line_ids = next_indices(h->num_lines);
+        line_begin = next_offsets();
+        vertices = next_coordinates(h->num_vertices);
+        point_ids = next_indices(h->num_points);
+        point_line_ids = next_indices(h->num_points);
+        locations = next_coordinates(h->num_points);
+        pinned = next_coordinates(h->num_pinned);
+        candidate_begin = next_offsets();
+        candidate_indices = next_indices(h->num_candidates);
+        reduced_begin = next_offsets();
+        reduced = next_indices(h->num_reduced);
+        piece_begin = next_offsets();
+        pieces = next_indices(h->num_pieces);
+    }
+
+    void* mapping = nullptr;
+    std::size_t mapped_size = 0;
+    const header* h = nullptr;
+    const std::uint32_t* line_ids = nullptr;
+    const std::uint64_t* line_begin = nullptr;
+    const CoordinateT* vertices = nullptr;
+    const std::uint32_t* point_ids = nullptr;
+    const std::uint32_t* point_line_ids = nullptr;
+    const CoordinateT* locations = nullptr;
+    const CoordinateT* pinned = nullptr;
+    const std::uint64_t* candidate_begin = nullptr;
+    const std::uint32_t* candidate_indices = nullptr;
+    const std::uint64_t* reduced_begin = nullptr;
+    const std::uint32_t* reduced = nullptr;
+    const std::uint64_t* piece_begin = nullptr;
+    const std::uint32_t* pieces = nullptr;
+};
+
+template<typename CoordinateT>
+constexpr char basic_preprocessing_snapshot<CoordinateT>::MAGIC[8];
+
+using preprocessing = basic_preprocessing<coordinate>;
+using preprocessing_snapshot = basic_preprocessing_snapshot<coordinate>;
+
+#endif
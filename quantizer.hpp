@@ -0,0 +1,172 @@
+#ifndef QUANTIZER_HPP
+#define QUANTIZER_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Returns the lower left and upper right corner of the bounding box
+/// of all given lines and points.
+inline std::pair<coordinate, coordinate> compute_bounds(const std::vector<poly_line>& lines, const std::vector<point>& points)
+{
+    coordinate min {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    coordinate max {-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()};
+
+    auto extend = [&min, &max](const coordinate& c)
+                  {
+                      min.x = std::min(min.x, c.x);
+                      min.y = std::min(min.y, c.y);
+                      max.x = std::max(max.x, c.x);
+                      max.y = std::max(max.y, c.y);
+                  };
+
+    for (const auto& l : lines)
+    {
+        std::for_each(l.coordinates.begin(), l.coordinates.end(), extend);
+    }
+    for (const auto& p : points)
+    {
+        extend(p.location);
+    }
+
+    return std::make_pair(min, max);
+}
+
+/// Origin and resolution of a quantizer, a resolution of 0 stands for coordinates that are not quantized
+struct quantization_parameters
+{
+    quantization_parameters() = default;
+
+    quantization_parameters(const coordinate& origin, double resolution)
+    : origin(origin)
+    , resolution(resolution)
+    {
+    }
+
+    coordinate origin {0, 0};
+    double resolution = 0;
+
+    bool operator==(const quantization_parameters& other) const
+    {
+        return origin == other.origin && resolution == other.resolution;
+    }
+
+    bool operator!=(const quantization_parameters& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/// Maps coordinates to an integer grid with a fixed origin and resolution.
+///
+/// All geometric predicates are exact on quantized coordinates as long as
+/// all offsets from the origin are below MAX_OFFSET (see coordinate_traits).
+template<typename QuantizedCoordinateT>
+class basic_quantizer
+{
+public:
+    using coordinate_type = QuantizedCoordinateT;
+    using value_type = typename coordinate_traits<QuantizedCoordinateT>::value_type;
+
+    /// Differences of two offsets need one bit, the products of differences
+    /// need to fit into the wide_type.
+    static constexpr value_type MAX_OFFSET = (value_type(1) << (sizeof(value_type) * 8 - 2)) - 1;
+
+    basic_quantizer(const coordinate& origin, double resolution)
+        : origin(origin)
+        , resolution(resolution)
+    {
+        if (!(resolution > 0))
+        {
+            throw std::runtime_error("Quantization resolution must be positive.");
+        }
+    }
+
+    /// Returns true if all coordinates in the bounding box [min, max] can be quantized
+    /// relative to min without exceeding MAX_OFFSET.
+    static bool fits(const coordinate& min, const coordinate& max, double resolution)
+    {
+        auto max_offset = static_cast<double>(MAX_OFFSET);
+        return std::round((max.x - min.x) / resolution) <= max_offset &&
+               std::round((max.y - min.y) / resolution) <= max_offset;
+    }
+
+    quantization_parameters parameters() const
+    {
+        return quantization_parameters {origin, resolution};
+    }
+
+    QuantizedCoordinateT quantize(const coordinate& c) const
+    {
+        return QuantizedCoordinateT {static_cast<value_type>(std::llround((c.x - origin.x) / resolution)),
+                                     static_cast<value_type>(std::llround((c.y - origin.y) / resolution))};
+    }
+
+    coordinate dequantize(const QuantizedCoordinateT& c) const
+    {
+        return coordinate {origin.x + static_cast<double>(c.x) * resolution,
+                           origin.y + static_cast<double>(c.y) * resolution};
+    }
+
+    std::vector<basic_poly_line<QuantizedCoordinateT>> quantize(const std::vector<poly_line>& lines) const
+    {
+        std::vector<basic_poly_line<QuantizedCoordinateT>> quantized_lines;
+        quantized_lines.reserve(lines.size());
+
+        for (const auto& l : lines)
+        {
+            basic_poly_line<QuantizedCoordinateT> quantized_line {l.id, {}};
+            quantized_line.coordinates.reserve(l.coordinates.size());
+            for (const auto& c : l.coordinates)
+            {
+                quantized_line.coordinates.push_back(quantize(c));
+            }
+            quantized_lines.push_back(std::move(quantized_line));
+        }
+
+        return quantized_lines;
+    }
+
+    std::vector<basic_point<QuantizedCoordinateT>> quantize(const std::vector<point>& points) const
+    {
+        std::vector<basic_point<QuantizedCoordinateT>> quantized_points;
+        quantized_points.reserve(points.size());
+
+        for (const auto& p : points)
+        {
+            quantized_points.push_back(basic_point<QuantizedCoordinateT> {p.line_id, p.id, quantize(p.location)});
+        }
+
+        return quantized_points;
+    }
+
+    poly_line dequantize(const basic_poly_line<QuantizedCoordinateT>& line) const
+    {
+        poly_line dequantized_line {line.id, {}};
+        dequantized_line.coordinates.reserve(line.coordinates.size());
+        for (const auto& c : line.coordinates)
+        {
+            dequantized_line.coordinates.push_back(dequantize(c));
+        }
+
+        return dequantized_line;
+    }
+
+private:
+    coordinate origin;
+    double resolution;
+};
+
+template<typename QuantizedCoordinateT>
+constexpr typename basic_quantizer<QuantizedCoordinateT>::value_type basic_quantizer<QuantizedCoordinateT>::MAX_OFFSET;
+
+using quantizer = basic_quantizer<quantized_coordinate>;
+using compact_quantizer = basic_quantizer<compact_quantized_coordinate>;
+
+#endif
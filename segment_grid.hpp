@@ -0,0 +1,182 @@
+#ifndef SEGMENT_GRID_HPP
+#define SEGMENT_GRID_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/// Uniform grid over the edges of a line that reports the edges near a horizontal ray.
+///
+/// Every edge is stored in the cells its segment passes through, so a long edge only takes
+/// the cells along it and not those of its bounding box. Like basic_point_grid the grid has
+/// about one cell per edge.
+template<typename CoordinateT>
+class basic_segment_grid
+{
+public:
+    basic_segment_grid(const std::vector<CoordinateT>& in_vertices)
+    : vertices(in_vertices)
+    {
+        if (vertices.size() < 2)
+        {
+            return;
+        }
+
+        min_x = max_x = static_cast<double>(vertices.front().x);
+        min_y = max_y = static_cast<double>(vertices.front().y);
+        for (const auto& v : vertices)
+        {
+            min_x = std::min(min_x, static_cast<double>(v.x));
+            min_y = std::min(min_y, static_cast<double>(v.y));
+            max_x = std::max(max_x, static_cast<double>(v.x));
+            max_y = std::max(max_y, static_cast<double>(v.y));
+        }
+
+        num_columns = num_rows = std::max(1u, static_cast<unsigned>(std::sqrt(static_cast<double>(vertices.size() - 1))));
+        cell_width = std::max((max_x - min_x) / num_columns, std::numeric_limits<double>::min());
+        cell_height = std::max((max_y - min_y) / num_rows, std::numeric_limits<double>::min());
+
+        // counting sort of the edges by cell, like basic_point_grid
+        cell_begin.assign(num_columns * num_rows + 1, 0);
+        for (auto k = 0u; k + 1 < vertices.size(); ++k)
+        {
+            for_each_cell(k, [this](unsigned id) { ++cell_begin[id + 1]; });
+        }
+        for (auto c = 1u; c < cell_begin.size(); ++c)
+        {
+            cell_begin[c] += cell_begin[c - 1];
+        }
+        edges.resize(cell_begin.back());
+        auto next = cell_begin;
+        for (auto k = 0u; k + 1 < vertices.size(); ++k)
+        {
+            for_each_cell(k, [this, &next, k](unsigned id) { edges[next[id]++] = k; });
+        }
+    }
+
+    /// Number of edges query_ray() looks at (edges in several cells count more than once), at most limit
+    std::size_t ray_size(const CoordinateT& p, double ray_max_x, std::size_t limit) const
+    {
+        if (!is_on_grid(p))
+        {
+            return 0;
+        }
+
+        auto r = row(static_cast<double>(p.y));
+        std::size_t size = 0;
+        for (auto c = column(static_cast<double>(p.x)); c <= column(ray_max_x) && size < limit; ++c)
+        {
+            size += cell_begin[cell(c, r) + 1] - cell_begin[cell(c, r)];
+        }
+        return std::min(size, limit);
+    }
+
+    /// Calls op(k) once for every edge (k, k + 1) that may intersect the horizontal segment from p to (max_x, p.y).
+    /// All edges that intersect it are reported.
+    template<typename OpT>
+    void query_ray(const CoordinateT& p, double ray_max_x, OpT op) const
+    {
+        if (!is_on_grid(p))
+        {
+            return;
+        }
+
+        auto r = row(static_cast<double>(p.y));
+        std::vector<unsigned> found;
+        for (auto c = column(static_cast<double>(p.x)); c <= column(ray_max_x); ++c)
+        {
+            auto id = cell(c, r);
+            found.insert(found.end(), edges.begin() + cell_begin[id], edges.begin() + cell_begin[id + 1]);
+        }
+
+        // long edges are stored in several cells
+        std::sort(found.begin(), found.end());
+        found.erase(std::unique(found.begin(), found.end()), found.end());
+        for (auto k : found)
+        {
+            op(k);
+        }
+    }
+
+private:
+    /// Returns false if no ray from p to the right can meet an edge
+    bool is_on_grid(const CoordinateT& p) const
+    {
+        return vertices.size() >= 2 && static_cast<double>(p.y) >= min_y && static_cast<double>(p.y) <= max_y
+               && static_cast<double>(p.x) <= max_x;
+    }
+
+    /// Calls op(cell) for the cells of every row the edge passes through, widened by a column against rounding
+    template<typename OpT>
+    void for_each_cell(unsigned k, OpT op) const
+    {
+        double ax = static_cast<double>(vertices[k].x);
+        double ay = static_cast<double>(vertices[k].y);
+        double bx = static_cast<double>(vertices[k + 1].x);
+        double by = static_cast<double>(vertices[k + 1].y);
+
+        auto first_row = row(std::min(ay, by));
+        auto last_row = row(std::max(ay, by));
+        for (auto r = first_row; r <= last_row; ++r)
+        {
+            // x range of the part of the edge inside of the row
+            double x0 = std::min(ax, bx);
+            double x1 = std::max(ax, bx);
+            if (ay != by)
+            {
+                double y0 = std::max(std::min(ay, by), min_y + r * cell_height);
+                double y1 = std::min(std::max(ay, by), min_y + (r + 1) * cell_height);
+                // rows are clamped at the border of the grid, their band may miss the edge by rounding
+                if (y0 <= y1)
+                {
+                    double xa = ax + (bx - ax) * (y0 - ay) / (by - ay);
+                    double xb = ax + (bx - ax) * (y1 - ay) / (by - ay);
+                    x0 = std::max(x0, std::min(xa, xb));
+                    x1 = std::min(x1, std::max(xa, xb));
+                }
+            }
+
+            auto first_column = column(x0);
+            auto last_column = column(x1);
+            first_column = first_column > 0 ? first_column - 1 : 0;
+            last_column = std::min(last_column + 1, num_columns - 1);
+            for (auto c = first_column; c <= last_column; ++c)
+            {
+                op(cell(c, r));
+            }
+        }
+    }
+
+    unsigned column(double x) const
+    {
+        auto c = std::floor((x - min_x) / cell_width);
+        return static_cast<unsigned>(std::max(0.0, std::min(c, num_columns - 1.0)));
+    }
+
+    unsigned row(double y) const
+    {
+        auto r = std::floor((y - min_y) / cell_height);
+        return static_cast<unsigned>(std::max(0.0, std::min(r, num_rows - 1.0)));
+    }
+
+    unsigned cell(unsigned c, unsigned r) const
+    {
+        return r * num_columns + c;
+    }
+
+    const std::vector<CoordinateT>& vertices;
+    double min_x = 0;
+    double min_y = 0;
+    double max_x = 0;
+    double max_y = 0;
+    double cell_width = 1;
+    double cell_height = 1;
+    unsigned num_columns = 0;
+    unsigned num_rows = 0;
+    std::vector<unsigned> cell_begin;
+    std::vector<unsigned> edges;
+};
+
+#endif
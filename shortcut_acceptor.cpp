@@ -5,7 +5,8 @@
 #include "poly_line.hpp"
 #include "util.hpp"
 
-shortcut_acceptor::shortcut_acceptor(const poly_line& line) : line(line)
+template<typename CoordinateT>
+basic_shortcut_acceptor<CoordinateT>::basic_shortcut_acceptor(const basic_poly_line<CoordinateT>& line) : line(line)
 {
 }
 
@@ -13,15 +14,18 @@ shortcut_acceptor::shortcut_acceptor(const poly_line& line) : line(line)
 /// assigements must be ordered by the facette number (index of the confining tangent)
 /// Note the returned shortcuts always contain the edge (i, i+1).
 /// We need this to get a nice sequence of edges for the topological sorting step.
-std::vector<shortcut> shortcut_acceptor::operator()(unsigned i, const std::vector<shortcut>& tangents, const std::vector<point_assignment>& assignments) const
+template<typename CoordinateT>
+std::vector<shortcut> basic_shortcut_acceptor<CoordinateT>::operator()(unsigned i, const std::vector<shortcut>& tangents, const std::vector<point_assignment>& assignments,
+                                                                       unsigned end) const
 {
+    BOOST_ASSERT(end <= line.coordinates.size());
     std::vector<shortcut> valid_shortcuts;
 
     const auto& origin = line.coordinates[i];
 
     unsigned vertex_begin_idx = i + 1;
-    auto vertex_deque = static_permuation_deque(util::compute_odering(line.coordinates.begin() + vertex_begin_idx, line.coordinates.end(),
-                                                   [&origin](const coordinate& lhs, const coordinate& rhs)
+    auto vertex_deque = static_permuation_deque(util::compute_odering(line.coordinates.begin() + vertex_begin_idx, line.coordinates.begin() + end,
+                                                   [&origin](const CoordinateT& lhs, const CoordinateT& rhs)
                                                    {
                                                        return geometry::slope_compare(origin, lhs, rhs);
                                                    })
@@ -87,3 +91,7 @@ std::vector<shortcut> shortcut_acceptor::operator()(unsigned i, const std::vecto
     return valid_shortcuts;
 }
 
+template class basic_shortcut_acceptor<coordinate>;
+template class basic_shortcut_acceptor<local_coordinate>;
+template class basic_shortcut_acceptor<quantized_coordinate>;
+template class basic_shortcut_acceptor<compact_quantized_coordinate>;
@@ -6,17 +6,27 @@
 
 #include <vector>
 
-class shortcut_acceptor
+template<typename CoordinateT>
+class basic_shortcut_acceptor
 {
 public:
-    using point_assignment = point_distributor::point_assignment;
+    using point_assignment = typename basic_point_distributor<CoordinateT>::point_assignment;
 
-    shortcut_acceptor(const poly_line& line);
+    basic_shortcut_acceptor(const basic_poly_line<CoordinateT>& line);
 
-    std::vector<shortcut> operator()(unsigned i, const std::vector<shortcut>& tangents, const std::vector<point_assignment>& assignments) const;
+    std::vector<shortcut> operator()(unsigned i, const std::vector<shortcut>& tangents, const std::vector<point_assignment>& assignments) const
+    {
+        return (*this)(i, tangents, assignments, line.coordinates.size());
+    }
+
+    /// Only accepts shortcuts from i to vertices before end
+    std::vector<shortcut> operator()(unsigned i, const std::vector<shortcut>& tangents, const std::vector<point_assignment>& assignments,
+                                     unsigned end) const;
 
 private:
-    const poly_line& line;
+    const basic_poly_line<CoordinateT>& line;
 };
 
+using shortcut_acceptor = basic_shortcut_acceptor<coordinate>;
+
 #endif
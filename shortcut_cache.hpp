@@ -0,0 +1,308 @@
+#ifndef SHORTCUT_CACHE_HPP
+#define SHORTCUT_CACHE_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "shortcut.hpp"
+#include "simplification_options.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+/// Content-addressed cache of the shortcuts of a line.
+///
+/// The key is the hash of the line's coordinates together with the engine and its options
+/// plus the hash of the filtered point set. Identical lines with identical nearby points
+/// get the same shortcuts, so they only need to be simplified once across runs.
+/// The cache keeps at most max_bytes of shortcuts and evicts the least recently used lines.
+class shortcut_cache
+{
+public:
+    struct key
+    {
+        std::uint64_t line_hash;
+        std::uint64_t points_hash;
+
+        bool operator==(const key& other) const
+        {
+            return line_hash == other.line_hash && points_hash == other.points_hash;
+        }
+    };
+
+    /// Loads the cache file if it exists
+    shortcut_cache(const std::string& in_file_path, std::size_t in_max_bytes)
+    : file_path(in_file_path)
+    , max_bytes(in_max_bytes)
+    {
+        std::ifstream input(file_path, std::ios::binary);
+        if (input)
+        {
+            read(input);
+        }
+    }
+
+    /// Hash of the coordinates of the line, the engine type and all options that change its shortcuts
+    template<typename SimplificationT, typename CoordinateT>
+    static std::uint64_t hash_line(const basic_poly_line<CoordinateT>& line, const simplification_options& options)
+    {
+        std::uint64_t hash = FNV_OFFSET;
+        const auto* engine_name = typeid(SimplificationT).name();
+        hash = hash_bytes(hash, engine_name, std::strlen(engine_name));
+        hash = hash_value(hash, options.window.max_vertices);
+        hash = hash_value(hash, options.window.max_length);
+        hash = hash_value(hash, options.max_deviation);
+        hash = hash_value(hash, options.target_edges);
+        hash = hash_value(hash, options.goal_directed);
+        hash = hash_value(hash, options.use_funnel_sweep);
+        hash = hash_value(hash, options.chunk_size);
+        hash = hash_value(hash, options.chunk_overlap);
+        hash = hash_value(hash, options.work_budget);
+        hash = hash_value(hash, options.fallback_window);
+        for (const auto& c : line.coordinates)
+        {
+            hash = hash_value(hash, c.x);
+            hash = hash_value(hash, c.y);
+        }
+        return hash;
+    }
+
+    /// Hash of the locations of the points, independent of their order
+    template<typename CoordinateT>
+    static std::uint64_t hash_points(const std::vector<basic_point<CoordinateT>>& points)
+    {
+        std::vector<CoordinateT> locations;
+        locations.reserve(points.size());
+        for (const auto& p : points)
+        {
+            locations.push_back(p.location);
+        }
+        std::sort(locations.begin(), locations.end(),
+                  [](const CoordinateT& lhs, const CoordinateT& rhs)
+                  {
+                      return lhs.x < rhs.x || (lhs.x == rhs.x && lhs.y < rhs.y);
+                  });
+
+        std::uint64_t hash = FNV_OFFSET;
+        for (const auto& c : locations)
+        {
+            hash = hash_value(hash, c.x);
+            hash = hash_value(hash, c.y);
+        }
+        return hash;
+    }
+
+    /// Returns true and sets the shortcuts and whether the line exceeded the work budget if k is cached
+    bool find(const key& k, std::vector<shortcut>& shortcuts, bool& fell_back)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto iter = index.find(k);
+        if (iter == index.end())
+        {
+            ++num_misses;
+            return false;
+        }
+
+        ++num_hits;
+        entries.splice(entries.begin(), entries, iter->second);
+        shortcuts.clear();
+        for (const auto& edge : iter->second->edges)
+        {
+            shortcuts.emplace_back(edge.first, edge.second);
+        }
+        fell_back = iter->second->fell_back;
+        return true;
+    }
+
+    void insert(const key& k, const std::vector<shortcut>& shortcuts, bool fell_back)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (index.find(k) != index.end())
+        {
+            return;
+        }
+
+        entry e {k, {}, fell_back};
+        e.edges.reserve(shortcuts.size());
+        for (const auto& s : shortcuts)
+        {
+            e.edges.emplace_back(s.first, s.last);
+        }
+        insert_entry(std::move(e));
+    }
+
+    /// Writes the cache file, the most recently used lines first
+    void save() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::ofstream output(file_path, std::ios::binary);
+        output.write(magic(), MAGIC_SIZE);
+        write_value<std::uint64_t>(output, entries.size());
+        for (const auto& e : entries)
+        {
+            write_value(output, e.k.line_hash);
+            write_value(output, e.k.points_hash);
+            write_value<std::uint8_t>(output, e.fell_back);
+            write_value<std::uint64_t>(output, e.edges.size());
+            for (const auto& edge : e.edges)
+            {
+                write_value<std::uint32_t>(output, edge.first);
+                write_value<std::uint32_t>(output, edge.second);
+            }
+        }
+
+        if (!output)
+        {
+            throw std::runtime_error("Could not write the shortcut cache " + file_path + ".");
+        }
+    }
+
+    unsigned hits() const
+    {
+        return num_hits;
+    }
+
+    unsigned misses() const
+    {
+        return num_misses;
+    }
+
+    /// Number of cached lines
+    std::size_t size() const
+    {
+        return entries.size();
+    }
+
+    /// Approximate size of the cache file
+    std::size_t bytes() const
+    {
+        return num_bytes;
+    }
+
+private:
+    struct entry
+    {
+        key k;
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        bool fell_back;
+    };
+
+    struct key_hash
+    {
+        std::size_t operator()(const key& k) const
+        {
+            return static_cast<std::size_t>(k.line_hash ^ (k.points_hash * FNV_PRIME));
+        }
+    };
+
+    static constexpr std::size_t MAGIC_SIZE = 8;
+    static constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+    static constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+    static const char* magic()
+    {
+        return "DBCACHE1";
+    }
+
+    static std::uint64_t hash_bytes(std::uint64_t hash, const void* data, std::size_t size)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t k = 0; k < size; ++k)
+        {
+            hash = (hash ^ bytes[k]) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    template<typename ValueT>
+    static std::uint64_t hash_value(std::uint64_t hash, ValueT value)
+    {
+        return hash_bytes(hash, &value, sizeof(value));
+    }
+
+    static std::size_t entry_bytes(const entry& e)
+    {
+        return 2 * sizeof(std::uint64_t) + 1 + sizeof(std::uint64_t) + e.edges.size() * 2 * sizeof(std::uint32_t);
+    }
+
+    /// Inserts e as most recently used and evicts the least recently used entries over the limit
+    void insert_entry(entry&& e)
+    {
+        num_bytes += entry_bytes(e);
+        entries.push_front(std::move(e));
+        index[entries.front().k] = entries.begin();
+
+        while (num_bytes > max_bytes && !entries.empty())
+        {
+            num_bytes -= entry_bytes(entries.back());
+            index.erase(entries.back().k);
+            entries.pop_back();
+        }
+    }
+
+    void read(std::istream& input)
+    {
+        char file_magic[MAGIC_SIZE];
+        input.read(file_magic, MAGIC_SIZE);
+        if (!input || std::memcmp(file_magic, magic(), MAGIC_SIZE) != 0)
+        {
+            throw std::runtime_error("Not a shortcut cache: " + file_path);
+        }
+
+        // the file is ordered by recency, so the oldest entry is inserted first
+        std::vector<entry> read_entries(read_value<std::uint64_t>(input));
+        for (auto& e : read_entries)
+        {
+            e.k.line_hash = read_value<std::uint64_t>(input);
+            e.k.points_hash = read_value<std::uint64_t>(input);
+            e.fell_back = read_value<std::uint8_t>(input) != 0;
+            e.edges.resize(read_value<std::uint64_t>(input));
+            for (auto& edge : e.edges)
+            {
+                edge.first = read_value<std::uint32_t>(input);
+                edge.second = read_value<std::uint32_t>(input);
+            }
+        }
+        for (auto iter = read_entries.rbegin(); iter != read_entries.rend(); ++iter)
+        {
+            insert_entry(std::move(*iter));
+        }
+    }
+
+    template<typename ValueT>
+    static void write_value(std::ostream& output, ValueT value)
+    {
+        output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template<typename ValueT>
+    ValueT read_value(std::istream& input) const
+    {
+        ValueT value;
+        input.read(reinterpret_cast<char*>(&value), sizeof(value));
+        if (!input)
+        {
+            throw std::runtime_error("The shortcut cache " + file_path + " is truncated.");
+        }
+        return value;
+    }
+
+    std::string file_path;
+    std::size_t max_bytes;
+    std::size_t num_bytes = 0;
+    std::list<entry> entries;
+    std::unordered_map<key, std::list<entry>::iterator, key_hash> index;
+    unsigned num_hits = 0;
+    unsigned num_misses = 0;
+    mutable std::mutex mutex;
+};
+
+#endif
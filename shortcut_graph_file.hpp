@@ -0,0 +1,298 @@
+#ifndef SHORTCUT_GRAPH_FILE_HPP
+#define SHORTCUT_GRAPH_FILE_HPP
+
+#include "poly_line.hpp"
+#include "simplification_state.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// The shortcut graph of a single line inside of a mapped file.
+///
+/// Offers the interface of static_graph, so graph_util works on it without copying.
+template<typename CoordinateT>
+class basic_shortcut_graph_view
+{
+public:
+    struct edge
+    {
+        unsigned last;
+    };
+
+    basic_shortcut_graph_view(unsigned id, unsigned num_nodes, const CoordinateT* coordinates,
+                              const std::uint32_t* original_indices, const std::uint64_t* edge_begin,
+                              const std::uint32_t* targets)
+    : id(id)
+    , num_nodes(num_nodes)
+    , coordinates(coordinates)
+    , original_indices(original_indices)
+    , edge_begin(edge_begin)
+    , targets(targets)
+    {
+    }
+
+    std::size_t begin_outgoing(unsigned node_id) const
+    {
+        return edge_begin[node_id];
+    }
+
+    std::size_t end_outgoing(unsigned node_id) const
+    {
+        return edge_begin[node_id + 1];
+    }
+
+    unsigned number_of_nodes() const
+    {
+        return num_nodes;
+    }
+
+    unsigned outgoing_degree(unsigned node_id) const
+    {
+        return end_outgoing(node_id) - begin_outgoing(node_id);
+    }
+
+    edge get_edge(std::size_t edge_id) const
+    {
+        return edge {targets[edge_id]};
+    }
+
+    /// Coordinate of a vertex of the reduced line
+    const CoordinateT& coordinate(unsigned node_id) const
+    {
+        return coordinates[node_id];
+    }
+
+    /// Index of a vertex of the reduced line in the input line
+    unsigned original_index(unsigned node_id) const
+    {
+        return original_indices[node_id];
+    }
+
+    unsigned id;
+
+private:
+    unsigned num_nodes;
+    const CoordinateT* coordinates;
+    const std::uint32_t* original_indices;
+    const std::uint64_t* edge_begin;
+    const std::uint32_t* targets;
+};
+
+/// Shortcut graphs of all lines of a run, stored in CSR form and memory mapped for selection.
+///
+/// The file consists of a header followed by 8 byte aligned arrays:
+/// line ids, the first vertex of every line, the coordinates and original indices of all
+/// vertices, the first shortcut of every vertex (plus a sentinel) and the target of every
+/// shortcut, which is an index into the reduced line.
+/// Nothing is parsed on load, the views point directly into the mapping.
+template<typename CoordinateT>
+class basic_shortcut_graph_file
+{
+public:
+    using value_type = typename coordinate_traits<CoordinateT>::value_type;
+    using view_type = basic_shortcut_graph_view<CoordinateT>;
+
+    /// Writes the reduced lines and shortcuts of a recorded simplification
+    static void write(std::ostream& output, const basic_simplification_state<CoordinateT>& state)
+    {
+        std::uint64_t num_vertices = 0;
+        std::uint64_t num_edges = 0;
+        for (const auto& s : state.line_states)
+        {
+            num_vertices += s.reduced_line.coordinates.size();
+            num_edges += s.shortcuts.size();
+        }
+
+        header h;
+        std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.value_size = sizeof(value_type);
+        h.padding = 0;
+        h.num_lines = state.line_states.size();
+        h.num_vertices = num_vertices;
+        h.num_edges = num_edges;
+        output.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+        std::uint64_t written = sizeof(h);
+        auto write_array = [&output, &written](const void* data, std::size_t bytes)
+        {
+            output.write(static_cast<const char*>(data), bytes);
+            written += bytes;
+            static const char zeros[ALIGNMENT] = {};
+            output.write(zeros, padding(written));
+            written += padding(written);
+        };
+
+        std::vector<std::uint32_t> line_ids;
+        std::vector<std::uint64_t> line_begin {0};
+        std::vector<value_type> coordinates;
+        std::vector<std::uint32_t> original_indices;
+        std::vector<std::uint64_t> edge_begin {0};
+        std::vector<std::uint32_t> targets;
+        for (const auto& s : state.line_states)
+        {
+            line_ids.push_back(s.reduced_line.id);
+            line_begin.push_back(line_begin.back() + s.reduced_line.coordinates.size());
+            for (const auto& c : s.reduced_line.coordinates)
+            {
+                coordinates.push_back(c.x);
+                coordinates.push_back(c.y);
+            }
+            original_indices.insert(original_indices.end(), s.reduced_indices.begin(), s.reduced_indices.end());
+
+            // the shortcuts are sorted by their first vertex
+            auto k = 0u;
+            for (auto node = 0u; node < s.reduced_line.coordinates.size(); ++node)
+            {
+                while (k < s.shortcuts.size() && s.shortcuts[k].first == node)
+                {
+                    targets.push_back(s.shortcuts[k++].last);
+                }
+                edge_begin.push_back(targets.size());
+            }
+        }
+
+        write_array(line_ids.data(), line_ids.size() * sizeof(std::uint32_t));
+        write_array(line_begin.data(), line_begin.size() * sizeof(std::uint64_t));
+        write_array(coordinates.data(), coordinates.size() * sizeof(value_type));
+        write_array(original_indices.data(), original_indices.size() * sizeof(std::uint32_t));
+        write_array(edge_begin.data(), edge_begin.size() * sizeof(std::uint64_t));
+        write_array(targets.data(), targets.size() * sizeof(std::uint32_t));
+
+        if (!output)
+        {
+            throw std::runtime_error("Could not write the shortcut graphs.");
+        }
+    }
+
+    /// Maps the file read only
+    basic_shortcut_graph_file(const std::string& file_path)
+    {
+        int fd = ::open(file_path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not open " + file_path + ".");
+        }
+
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(header))
+        {
+            ::close(fd);
+            throw std::runtime_error(file_path + " is not a shortcut graph file.");
+        }
+        mapped_size = info.st_size;
+        mapping = ::mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw std::runtime_error("Could not map " + file_path + ".");
+        }
+
+        try
+        {
+            locate_arrays(file_path);
+        }
+        catch (...)
+        {
+            ::munmap(mapping, mapped_size);
+            throw;
+        }
+    }
+
+    ~basic_shortcut_graph_file()
+    {
+        ::munmap(mapping, mapped_size);
+    }
+
+    basic_shortcut_graph_file(const basic_shortcut_graph_file&) = delete;
+    basic_shortcut_graph_file& operator=(const basic_shortcut_graph_file&) = delete;
+
+    std::size_t size() const
+    {
+        return num_lines;
+    }
+
+    view_type line(std::size_t idx) const
+    {
+        auto first = line_begin[idx];
+        return view_type(line_ids[idx], line_begin[idx + 1] - first, coordinates + first, original_indices + first,
+                         edge_begin + first, targets);
+    }
+
+private:
+    struct header
+    {
+        char magic[8];
+        std::uint32_t value_size;
+        std::uint32_t padding;
+        std::uint64_t num_lines;
+        std::uint64_t num_vertices;
+        std::uint64_t num_edges;
+    };
+
+    static constexpr std::size_t ALIGNMENT = 8;
+    static constexpr char MAGIC[8] = {'D', 'B', 'G', 'R', 'A', 'P', 'H', '1'};
+
+    static std::size_t padding(std::uint64_t offset)
+    {
+        return (ALIGNMENT - offset % ALIGNMENT) % ALIGNMENT;
+    }
+
+    void locate_arrays(const std::string& file_path)
+    {
+        const auto* h = static_cast<const header*>(mapping);
+        if (std::memcmp(h->magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw std::runtime_error(file_path + " is not a shortcut graph file.");
+        }
+        if (h->value_size != sizeof(value_type))
+        {
+            throw std::runtime_error(file_path + " uses a different coordinate type.");
+        }
+        num_lines = h->num_lines;
+
+        std::uint64_t offset = sizeof(header);
+        auto next_array = [&](std::uint64_t bytes)
+        {
+            if (offset + bytes > mapped_size)
+            {
+                throw std::runtime_error(file_path + " is truncated.");
+            }
+            const auto* array = static_cast<const char*>(mapping) + offset;
+            offset += bytes + padding(offset + bytes);
+            return array;
+        };
+
+        line_ids = reinterpret_cast<const std::uint32_t*>(next_array(h->num_lines * sizeof(std::uint32_t)));
+        line_begin = reinterpret_cast<const std::uint64_t*>(next_array((h->num_lines + 1) * sizeof(std::uint64_t)));
+        coordinates = reinterpret_cast<const CoordinateT*>(next_array(h->num_vertices * 2 * sizeof(value_type)));
+        original_indices = reinterpret_cast<const std::uint32_t*>(next_array(h->num_vertices * sizeof(std::uint32_t)));
+        edge_begin = reinterpret_cast<const std::uint64_t*>(next_array((h->num_vertices + 1) * sizeof(std::uint64_t)));
+        targets = reinterpret_cast<const std::uint32_t*>(next_array(h->num_edges * sizeof(std::uint32_t)));
+    }
+
+    void* mapping = nullptr;
+    std::size_t mapped_size = 0;
+    std::size_t num_lines = 0;
+    const std::uint32_t* line_ids = nullptr;
+    const std::uint64_t* line_begin = nullptr;
+    const CoordinateT* coordinates = nullptr;
+    const std::uint32_t* original_indices = nullptr;
+    const std::uint64_t* edge_begin = nullptr;
+    const std::uint32_t* targets = nullptr;
+};
+
+template<typename CoordinateT>
+constexpr char basic_shortcut_graph_file<CoordinateT>::MAGIC[8];
+
+using shortcut_graph_file = basic_shortcut_graph_file<coordinate>;
+
+#endif
@@ -0,0 +1,141 @@
+#ifndef SHORTCUT_VALIDATOR_HPP
+#define SHORTCUT_VALIDATOR_HPP
+
+#include "poly_line.hpp"
+#include "geometry.hpp"
+#include "point_grid.hpp"
+#include "segment_grid.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/// Checks single shortcuts of a line against its constraints.
+///
+/// The shortcut (i, j) is valid if every constraint point and every vertex of the line outside
+/// of [i, j] has winding number 0 with respect to the polygon formed by the subpath and the
+/// shortcut and is not on it. The constraints inside the bounding box of the subpath are found
+/// with a point grid and their winding numbers only count the edges of a segment grid along a
+/// ray to the border of the box, so the checks are local.
+template<typename CoordinateT>
+class basic_shortcut_validator
+{
+public:
+    using line_type = basic_poly_line<CoordinateT>;
+
+    basic_shortcut_validator(const line_type& in_line, const std::vector<CoordinateT>& point_locations)
+    : line(in_line)
+    , num_points(point_locations.size())
+    , locations(make_locations(in_line, point_locations))
+    , grid(locations)
+    , edges(in_line.coordinates)
+    {
+    }
+
+    bool operator()(unsigned i, unsigned j) const
+    {
+        auto min = line.coordinates[i];
+        auto max = line.coordinates[i];
+        for (auto k = i + 1; k <= j; ++k)
+        {
+            min.x = std::min(min.x, line.coordinates[k].x);
+            min.y = std::min(min.y, line.coordinates[k].y);
+            max.x = std::max(max.x, line.coordinates[k].x);
+            max.y = std::max(max.y, line.coordinates[k].y);
+        }
+
+        bool valid = true;
+        grid.query(min, max, [&](unsigned idx)
+        {
+            if (!valid)
+            {
+                return;
+            }
+
+            // vertices of the subpath itself
+            if (idx >= num_points && idx - num_points >= i && idx - num_points <= j)
+            {
+                return;
+            }
+
+            const auto& location = locations[idx];
+            if (location == line.coordinates[i] || location == line.coordinates[j])
+            {
+                return;
+            }
+
+            valid = is_outside(location, i, j, static_cast<double>(max.x));
+        });
+
+        return valid;
+    }
+
+private:
+    /// The constraints are the points followed by the vertices of the line
+    static std::vector<CoordinateT> make_locations(const line_type& line, const std::vector<CoordinateT>& point_locations)
+    {
+        std::vector<CoordinateT> all_locations;
+        all_locations.reserve(point_locations.size() + line.coordinates.size());
+        all_locations.insert(all_locations.end(), point_locations.begin(), point_locations.end());
+        all_locations.insert(all_locations.end(), line.coordinates.begin(), line.coordinates.end());
+        return all_locations;
+    }
+
+    /// Returns true if p is not on the polygon i, ..., j, i and its winding number is 0.
+    /// A point that the polygon winds around twice is inside, although an even-odd test
+    /// would see it outside. max_x is the right border of the polygon's bounding box.
+    bool is_outside(const CoordinateT& p, unsigned i, unsigned j, double max_x) const
+    {
+        int winding = 0;
+        bool on_polygon = false;
+        auto add_edge = [&p, &winding, &on_polygon](const CoordinateT& a, const CoordinateT& b)
+        {
+            auto o = geometry::orientation(a, b, p);
+            if (o == 0 && std::min(a.x, b.x) <= p.x && p.x <= std::max(a.x, b.x)
+                       && std::min(a.y, b.y) <= p.y && p.y <= std::max(a.y, b.y))
+            {
+                on_polygon = true;
+            }
+
+            // signed crossings of the half-line to the right of p
+            if (a.y <= p.y && b.y > p.y && o > 0)
+            {
+                ++winding;
+            }
+            else if (a.y > p.y && b.y <= p.y && o < 0)
+            {
+                --winding;
+            }
+        };
+
+        // the edges of the subpath that can cross the half-line inside of the bounding box,
+        // unless a short subpath has fewer edges than the grid along the half-line
+        if (edges.ray_size(p, max_x, j - i) < j - i)
+        {
+            edges.query_ray(p, max_x, [&](unsigned k)
+            {
+                if (k >= i && k < j)
+                {
+                    add_edge(line.coordinates[k], line.coordinates[k + 1]);
+                }
+            });
+        }
+        else
+        {
+            for (auto k = i; k < j; ++k)
+            {
+                add_edge(line.coordinates[k], line.coordinates[k + 1]);
+            }
+        }
+        add_edge(line.coordinates[j], line.coordinates[i]);
+
+        return !on_polygon && winding == 0;
+    }
+
+    const line_type& line;
+    std::size_t num_points;
+    std::vector<CoordinateT> locations;
+    basic_point_grid<CoordinateT> grid;
+    basic_segment_grid<CoordinateT> edges;
+};
+
+#endif
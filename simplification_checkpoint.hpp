@@ -0,0 +1,242 @@
+#ifndef SIMPLIFICATION_CHECKPOINT_HPP
+#define SIMPLIFICATION_CHECKPOINT_HPP
+
+#include "shortcut.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/// Append-only file of the shortcuts of completed lines, so an interrupted run can resume.
+///
+/// Every record holds a line id, a key of the line's input and its shortcuts, followed by
+/// a commit marker. Workers reserve the space of a record with an atomic offset and write it
+/// with pwrite, so they never wait for each other. The marker is written after the record,
+/// so a record of a killed process is only used if it is complete. On resume all records
+/// up to the first incomplete one are loaded and the rest of the file is cut off.
+class simplification_checkpoint
+{
+public:
+    /// Continues the file if resume is set, otherwise starts a new one
+    simplification_checkpoint(const std::string& in_file_path, bool resume)
+    : file_path(in_file_path)
+    {
+        fd = ::open(file_path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Could not open the checkpoint " + file_path + ".");
+        }
+
+        try
+        {
+            std::uint64_t valid_end = 0;
+            if (resume)
+            {
+                valid_end = load();
+            }
+            if (valid_end == 0)
+            {
+                write_at(magic(), MAGIC_SIZE, 0);
+                valid_end = MAGIC_SIZE;
+            }
+            if (::ftruncate(fd, valid_end) != 0)
+            {
+                throw std::runtime_error("Could not truncate the checkpoint " + file_path + ".");
+            }
+            end_offset = valid_end;
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    ~simplification_checkpoint()
+    {
+        ::fsync(fd);
+        ::close(fd);
+    }
+
+    simplification_checkpoint(const simplification_checkpoint&) = delete;
+    simplification_checkpoint& operator=(const simplification_checkpoint&) = delete;
+
+    /// Returns true and sets the shortcuts if the line was completed with the same key
+    bool find(unsigned line_id, std::uint64_t key, std::vector<shortcut>& shortcuts, bool& fell_back) const
+    {
+        auto iter = completed.find(line_id);
+        if (iter == completed.end() || iter->second.key != key)
+        {
+            return false;
+        }
+
+        shortcuts.clear();
+        for (const auto& edge : iter->second.edges)
+        {
+            shortcuts.emplace_back(edge.first, edge.second);
+        }
+        fell_back = iter->second.fell_back;
+        return true;
+    }
+
+    /// Appends the record of a completed line, safe to call from several threads
+    void append(unsigned line_id, std::uint64_t key, const std::vector<shortcut>& shortcuts, bool fell_back)
+    {
+        std::vector<char> bytes(HEADER_SIZE + shortcuts.size() * 2 * sizeof(std::uint32_t));
+        auto* data = bytes.data();
+        put<std::uint32_t>(data, line_id);
+        put<std::uint32_t>(data, fell_back);
+        put<std::uint64_t>(data, key);
+        put<std::uint64_t>(data, shortcuts.size());
+        for (const auto& s : shortcuts)
+        {
+            put<std::uint32_t>(data, s.first);
+            put<std::uint32_t>(data, s.last);
+        }
+        auto marker = commit_marker(bytes.data(), bytes.size());
+
+        auto offset = end_offset.fetch_add(bytes.size() + sizeof(marker));
+        write_at(bytes.data(), bytes.size(), offset);
+        write_at(&marker, sizeof(marker), offset + bytes.size());
+    }
+
+    /// Number of lines loaded on resume
+    std::size_t size() const
+    {
+        return completed.size();
+    }
+
+private:
+    struct record
+    {
+        std::uint64_t key;
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        bool fell_back;
+    };
+
+    static constexpr std::size_t MAGIC_SIZE = 8;
+    static constexpr std::size_t HEADER_SIZE = 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+
+    static const char* magic()
+    {
+        return "DBCHECK1";
+    }
+
+    template<typename ValueT>
+    static void put(char*& data, ValueT value)
+    {
+        std::memcpy(data, &value, sizeof(value));
+        data += sizeof(value);
+    }
+
+    template<typename ValueT>
+    static ValueT get(const char*& data)
+    {
+        ValueT value;
+        std::memcpy(&value, data, sizeof(value));
+        data += sizeof(value);
+        return value;
+    }
+
+    /// FNV-1a hash of the record, never 0 so a hole in the file is no valid marker
+    static std::uint64_t commit_marker(const char* data, std::size_t size)
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t k = 0; k < size; ++k)
+        {
+            hash = (hash ^ static_cast<unsigned char>(data[k])) * 1099511628211ull;
+        }
+        return hash | 1;
+    }
+
+    void write_at(const void* data, std::size_t size, std::uint64_t offset) const
+    {
+        const auto* bytes = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            auto written = ::pwrite(fd, bytes, size, offset);
+            if (written <= 0)
+            {
+                throw std::runtime_error("Could not write the checkpoint " + file_path + ".");
+            }
+            bytes += written;
+            size -= written;
+            offset += written;
+        }
+    }
+
+    /// Loads all complete records and returns the end of the last one, 0 if the file is no checkpoint
+    std::uint64_t load()
+    {
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < MAGIC_SIZE)
+        {
+            return 0;
+        }
+
+        std::vector<char> contents(info.st_size);
+        std::size_t read = 0;
+        while (read < contents.size())
+        {
+            auto n = ::pread(fd, contents.data() + read, contents.size() - read, read);
+            if (n <= 0)
+            {
+                throw std::runtime_error("Could not read the checkpoint " + file_path + ".");
+            }
+            read += n;
+        }
+        if (std::memcmp(contents.data(), magic(), MAGIC_SIZE) != 0)
+        {
+            throw std::runtime_error(file_path + " is not a checkpoint.");
+        }
+
+        std::uint64_t offset = MAGIC_SIZE;
+        while (offset + HEADER_SIZE <= contents.size())
+        {
+            const char* data = contents.data() + offset;
+            auto line_id = get<std::uint32_t>(data);
+            auto fell_back = get<std::uint32_t>(data) != 0;
+            auto key = get<std::uint64_t>(data);
+            auto num_shortcuts = get<std::uint64_t>(data);
+            auto record_size = HEADER_SIZE + num_shortcuts * 2 * sizeof(std::uint32_t);
+            if (num_shortcuts > contents.size() || offset + record_size + sizeof(std::uint64_t) > contents.size())
+            {
+                break;
+            }
+
+            const char* marker_data = contents.data() + offset + record_size;
+            if (get<std::uint64_t>(marker_data) != commit_marker(contents.data() + offset, record_size))
+            {
+                break;
+            }
+
+            record r {key, {}, fell_back};
+            r.edges.reserve(num_shortcuts);
+            for (auto k = 0u; k < num_shortcuts; ++k)
+            {
+                auto first = get<std::uint32_t>(data);
+                auto last = get<std::uint32_t>(data);
+                r.edges.emplace_back(first, last);
+            }
+            completed[line_id] = std::move(r);
+            offset += record_size + sizeof(std::uint64_t);
+        }
+
+        return offset;
+    }
+
+    std::string file_path;
+    int fd = -1;
+    std::atomic<std::uint64_t> end_offset {0};
+    std::unordered_map<unsigned, record> completed;
+};
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SIMPLIFICATION_OPTIONS_HPP
+#define SIMPLIFICATION_OPTIONS_HPP
+
+#include "simplification_window.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+
+/// Runtime parameters of the simplification engines.
+///
+/// Every engine takes them as last constructor argument and ignores
+/// the parameters it does not use.
+struct simplification_options
+{
+    simplification_options() = default;
+
+    simplification_options(const simplification_window& window)
+    : window(window)
+    {
+    }
+
+    simplification_window window;
+    /// Maximal distance of a removed vertex to its shortcut, 0 disables the bound
+    double max_deviation = 0;
+    /// Number of edges douglas_peucker splits every line (or piece) into, unless it needs more.
+    /// 0 only uses max_deviation
+    unsigned target_edges = 0;
+
+    /// Only compute the fans of the vertices a breadth first search visits before it reaches the end of a subpath.
+    /// The engine then returns a reduced graph: the edges of the line and one shortest path per subpath, without
+    /// the alternative shortcuts. The number of edges stays minimal, but everything that selects among the
+    /// shortcuts by their error (edge allocation, levels of detail, written shortcut graphs) needs all of them.
+    bool goal_directed = false;
+    /// Find the shortcuts with basic_funnel_sweep instead of the tangent splitter, distributor and acceptor
+    bool use_funnel_sweep = false;
+
+    /// Number of vertices per chunk of chunked_simplification
+    unsigned chunk_size = 4096;
+    /// Number of vertices shared by consecutive chunks
+    unsigned chunk_overlap = 256;
+    /// Number of threads an engine may use for a single line
+    unsigned num_threads = 1;
+
+    /// Maximal number of candidate vertices an engine may process for a single line, 0 disables the budget
+    std::size_t work_budget = 0;
+    /// Window of the simplification that replaces one exceeding the budget
+    unsigned fallback_window = 16;
+};
+
+/// Thrown by an engine that exceeds simplification_options::work_budget
+struct work_budget_exceeded : public std::runtime_error
+{
+    work_budget_exceeded()
+    : std::runtime_error("The work budget of the line is exceeded.")
+    {
+    }
+};
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef SIMPLIFICATION_SERVER_HPP
+#define SIMPLIFICATION_SERVER_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "point_grid.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/// Keeps a map in memory and answers requests to simplify some of its lines.
+///
+/// The points and the vertices of all lines are indexed by a point grid once. The input of a
+/// request consists of its lines and every point and vertex of another line inside of their
+/// bounding boxes, which are all points that can constrain them. Every line is simplified as
+/// in a run on the whole map.
+///
+/// serve() reads one request per line: an id without whitespace followed by the arguments
+/// that are passed to the handler. Every response starts with the line
+/// "ID ok|error BYTES MSEC", followed by BYTES bytes of the handler's result or the error
+/// message. MSEC is the time from reading the request to writing its response. The requests
+/// are processed concurrently and answered as soon as they are done.
+template<typename CoordinateT>
+class basic_simplification_server
+{
+public:
+    using line_type = basic_poly_line<CoordinateT>;
+    using point_type = basic_point<CoordinateT>;
+
+    /// Lines and points of a request
+    struct request_input
+    {
+        std::vector<line_type> lines;
+        std::vector<point_type> points;
+    };
+
+    /// Returns the result of a request, called from several threads at once
+    using handler_type = std::function<std::string(const std::string& arguments)>;
+
+    basic_simplification_server(std::vector<line_type>&& in_lines, std::vector<point_type>&& in_points)
+        : lines(std::move(in_lines))
+        , points(std::move(in_points))
+    {
+        for (const auto& p : points)
+        {
+            locations.push_back(p.location);
+        }
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            for (const auto& c : lines[i].coordinates)
+            {
+                locations.push_back(c);
+                vertex_lines.push_back(i);
+            }
+            line_ids.emplace_back(lines[i].id, i);
+        }
+        std::sort(line_ids.begin(), line_ids.end());
+        grid.reset(new basic_point_grid<CoordinateT>(locations));
+    }
+
+    basic_simplification_server(const basic_simplification_server&) = delete;
+    basic_simplification_server& operator=(const basic_simplification_server&) = delete;
+
+    /// Number of lines of the map
+    std::size_t size() const
+    {
+        return lines.size();
+    }
+
+    /// Input of the lines with the given ids in map order, all lines if there are no ids
+    request_input input(const std::vector<unsigned>& ids) const
+    {
+        request_input result;
+        if (ids.empty())
+        {
+            result.lines = lines;
+            result.points = points;
+            return result;
+        }
+
+        std::vector<unsigned> line_indices;
+        for (auto id : ids)
+        {
+            auto range = std::equal_range(line_ids.begin(), line_ids.end(), std::make_pair(id, 0u),
+                                          [](const std::pair<unsigned, unsigned>& lhs, const std::pair<unsigned, unsigned>& rhs)
+                                          {
+                                              return lhs.first < rhs.first;
+                                          });
+            if (range.first == range.second)
+            {
+                throw std::runtime_error("There is no line " + std::to_string(id) + ".");
+            }
+            for (auto iter = range.first; iter != range.second; ++iter)
+            {
+                line_indices.push_back(iter->second);
+            }
+        }
+        std::sort(line_indices.begin(), line_indices.end());
+        line_indices.erase(std::unique(line_indices.begin(), line_indices.end()), line_indices.end());
+
+        std::vector<char> is_requested(lines.size(), false);
+        std::vector<unsigned> candidates;
+        for (auto i : line_indices)
+        {
+            is_requested[i] = true;
+            result.lines.push_back(lines[i]);
+            if (lines[i].coordinates.empty())
+            {
+                continue;
+            }
+
+            auto min = lines[i].coordinates.front();
+            auto max = min;
+            for (const auto& c : lines[i].coordinates)
+            {
+                min.x = std::min(min.x, c.x);
+                min.y = std::min(min.y, c.y);
+                max.x = std::max(max.x, c.x);
+                max.y = std::max(max.y, c.y);
+            }
+            grid->query(min, max, [&candidates](unsigned idx) { candidates.push_back(idx); });
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        // the simplification adds the vertices of the requested lines itself
+        for (auto idx : candidates)
+        {
+            if (idx < points.size())
+            {
+                result.points.push_back(points[idx]);
+            }
+            else if (!is_requested[vertex_lines[idx - points.size()]])
+            {
+                result.points.push_back(point_type {lines[vertex_lines[idx - points.size()]].id, idx, locations[idx]});
+            }
+        }
+
+        return result;
+    }
+
+    /// Answers the requests read from input on num_workers threads until the input ends
+    void serve(std::istream& input, std::ostream& output, unsigned num_workers, const handler_type& handler) const
+    {
+        std::queue<pending_request> pending;
+        bool is_done = false;
+        std::mutex queue_mutex;
+        std::condition_variable queue_changed;
+        std::mutex output_mutex;
+
+        auto worker = [&]()
+        {
+            while (true)
+            {
+                pending_request request;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    queue_changed.wait(lock, [&]() { return is_done || !pending.empty(); });
+                    if (pending.empty())
+                    {
+                        return;
+                    }
+                    request = std::move(pending.front());
+                    pending.pop();
+                }
+
+                std::string status = "ok";
+                std::string result;
+                try
+                {
+                    result = handler(request.arguments);
+                }
+                catch (const std::exception& e)
+                {
+                    status = "error";
+                    result = e.what();
+                }
+
+                std::lock_guard<std::mutex> lock(output_mutex);
+                auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now() - request.received).count() / 1000.0;
+                output << request.id << " " << status << " " << result.size() << " " << latency << "\n";
+                output.write(result.data(), result.size());
+                output.flush();
+                std::cerr << "Request " << request.id << ": " << status << " in " << latency << " msec." << std::endl;
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (auto t = 0u; t < std::max(num_workers, 1u); ++t)
+        {
+            workers.emplace_back(worker);
+        }
+
+        std::string request_line;
+        while (std::getline(input, request_line))
+        {
+            std::istringstream request_stream(request_line);
+            pending_request request;
+            if (!(request_stream >> request.id))
+            {
+                continue;
+            }
+            request.received = std::chrono::steady_clock::now();
+            std::getline(request_stream >> std::ws, request.arguments);
+
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            pending.push(std::move(request));
+            queue_changed.notify_one();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            is_done = true;
+        }
+        queue_changed.notify_all();
+        for (auto& w : workers)
+        {
+            w.join();
+        }
+    }
+
+private:
+    struct pending_request
+    {
+        std::string id;
+        std::string arguments;
+        std::chrono::steady_clock::time_point received;
+    };
+
+    std::vector<line_type> lines;
+    std::vector<point_type> points;
+    /// locations of the points followed by the vertices of all lines
+    std::vector<CoordinateT> locations;
+    /// line of every vertex in locations
+    std::vector<unsigned> vertex_lines;
+    /// sorted pairs of line id and line index
+    std::vector<std::pair<unsigned, unsigned>> line_ids;
+    /// refers to locations
+    std::unique_ptr<basic_point_grid<CoordinateT>> grid;
+};
+
+using simplification_server = basic_simplification_server<coordinate>;
+
+#endif
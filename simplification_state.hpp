@@ -0,0 +1,279 @@
+#ifndef SIMPLIFICATION_STATE_HPP
+#define SIMPLIFICATION_STATE_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "shortcut.hpp"
+#include "simplification_options.hpp"
+#include "quantizer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Everything map_simplification needs to reuse the shortcuts of unchanged lines in a later run.
+///
+/// The shortcuts are only valid for the same engine, options, quantization and vertex reduction,
+/// so they are stored too and compared with is_compatible(). A state of a different coordinate type is rejected by read().
+template<typename CoordinateT>
+struct basic_simplification_state
+{
+    using line_type = basic_poly_line<CoordinateT>;
+    using point_type = basic_point<CoordinateT>;
+    using value_type = typename coordinate_traits<CoordinateT>::value_type;
+
+    /// A line after vertex reduction and its shortcuts, indexed like the reduced line
+    struct line_state
+    {
+        line_type reduced_line;
+        std::vector<unsigned> reduced_indices;
+        std::vector<shortcut> shortcuts;
+    };
+
+    /// The input of the run
+    std::vector<line_type> lines;
+    std::vector<point_type> points;
+    std::vector<CoordinateT> pinned_coordinates;
+    /// One entry per line of the run
+    std::vector<line_state> line_states;
+
+    /// Engine that computed the shortcuts, see shortcut_cache::hash_line()
+    std::string engine;
+    simplification_options options;
+    quantization_parameters quantization;
+    /// True if the vertices inside straight runs were removed, see basic_vertex_reduction
+    bool removes_collinear = true;
+
+    /// Returns true if a run with the given engine, options, quantization and vertex reduction computes
+    /// the same shortcuts. The number of threads does not change the shortcuts.
+    bool is_compatible(const std::string& other_engine, const simplification_options& other_options,
+                       const quantization_parameters& other_quantization, bool other_removes_collinear) const
+    {
+        return engine == other_engine
+            && options.window.max_vertices == other_options.window.max_vertices
+            && options.window.max_length == other_options.window.max_length
+            && options.max_deviation == other_options.max_deviation
+            && options.target_edges == other_options.target_edges
+            && options.goal_directed == other_options.goal_directed
+            && options.use_funnel_sweep == other_options.use_funnel_sweep
+            && options.chunk_size == other_options.chunk_size
+            && options.chunk_overlap == other_options.chunk_overlap
+            && options.work_budget == other_options.work_budget
+            && options.fallback_window == other_options.fallback_window
+            && quantization == other_quantization
+            && removes_collinear == other_removes_collinear;
+    }
+
+    void write(std::ostream& output) const
+    {
+        output.write(MAGIC, sizeof(MAGIC));
+        write_value<std::uint32_t>(output, sizeof(value_type));
+        write_value<std::uint8_t>(output, std::is_floating_point<value_type>::value);
+
+        write_value<std::uint64_t>(output, engine.size());
+        output.write(engine.data(), engine.size());
+        write_value<std::uint32_t>(output, options.window.max_vertices);
+        write_value<double>(output, options.window.max_length);
+        write_value<double>(output, options.max_deviation);
+        write_value<std::uint32_t>(output, options.target_edges);
+        write_value<std::uint8_t>(output, options.goal_directed);
+        write_value<std::uint8_t>(output, options.use_funnel_sweep);
+        write_value<std::uint32_t>(output, options.chunk_size);
+        write_value<std::uint32_t>(output, options.chunk_overlap);
+        write_value<std::uint32_t>(output, options.num_threads);
+        write_value<std::uint64_t>(output, options.work_budget);
+        write_value<std::uint32_t>(output, options.fallback_window);
+        write_value<double>(output, quantization.origin.x);
+        write_value<double>(output, quantization.origin.y);
+        write_value<double>(output, quantization.resolution);
+        write_value<std::uint8_t>(output, removes_collinear);
+
+        write_value<std::uint64_t>(output, lines.size());
+        for (const auto& l : lines)
+        {
+            write_line(output, l);
+        }
+
+        write_value<std::uint64_t>(output, points.size());
+        for (const auto& p : points)
+        {
+            write_value<std::uint32_t>(output, p.line_id);
+            write_value<std::uint32_t>(output, p.id);
+            write_coordinate(output, p.location);
+        }
+
+        write_value<std::uint64_t>(output, pinned_coordinates.size());
+        for (const auto& c : pinned_coordinates)
+        {
+            write_coordinate(output, c);
+        }
+
+        write_value<std::uint64_t>(output, line_states.size());
+        for (const auto& s : line_states)
+        {
+            write_line(output, s.reduced_line);
+            write_value<std::uint64_t>(output, s.reduced_indices.size());
+            for (auto idx : s.reduced_indices)
+            {
+                write_value<std::uint32_t>(output, idx);
+            }
+            write_value<std::uint64_t>(output, s.shortcuts.size());
+            for (const auto& c : s.shortcuts)
+            {
+                write_value<std::uint32_t>(output, c.first);
+                write_value<std::uint32_t>(output, c.last);
+            }
+        }
+
+        if (!output)
+        {
+            throw std::runtime_error("Could not write the simplification state.");
+        }
+    }
+
+    static basic_simplification_state read(std::istream& input)
+    {
+        char magic[sizeof(MAGIC)];
+        input.read(magic, sizeof(magic));
+        if (!input || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw std::runtime_error("Not a simplification state.");
+        }
+        // 64bit quantized and double coordinates have the same size
+        if (read_value<std::uint32_t>(input) != sizeof(value_type)
+            || read_value<std::uint8_t>(input) != std::is_floating_point<value_type>::value)
+        {
+            throw std::runtime_error("The simplification state uses a different coordinate type.");
+        }
+
+        basic_simplification_state state;
+
+        state.engine.resize(read_value<std::uint64_t>(input));
+        input.read(&state.engine[0], state.engine.size());
+        if (!input)
+        {
+            throw std::runtime_error("The simplification state is truncated.");
+        }
+        state.options.window.max_vertices = read_value<std::uint32_t>(input);
+        state.options.window.max_length = read_value<double>(input);
+        state.options.max_deviation = read_value<double>(input);
+        state.options.target_edges = read_value<std::uint32_t>(input);
+        state.options.goal_directed = read_value<std::uint8_t>(input) != 0;
+        state.options.use_funnel_sweep = read_value<std::uint8_t>(input) != 0;
+        state.options.chunk_size = read_value<std::uint32_t>(input);
+        state.options.chunk_overlap = read_value<std::uint32_t>(input);
+        state.options.num_threads = read_value<std::uint32_t>(input);
+        state.options.work_budget = read_value<std::uint64_t>(input);
+        state.options.fallback_window = read_value<std::uint32_t>(input);
+        state.quantization.origin.x = read_value<double>(input);
+        state.quantization.origin.y = read_value<double>(input);
+        state.quantization.resolution = read_value<double>(input);
+        state.removes_collinear = read_value<std::uint8_t>(input) != 0;
+
+        state.lines.resize(read_value<std::uint64_t>(input));
+        for (auto& l : state.lines)
+        {
+            l = read_line(input);
+        }
+
+        state.points.resize(read_value<std::uint64_t>(input));
+        for (auto& p : state.points)
+        {
+            p.line_id = read_value<std::uint32_t>(input);
+            p.id = read_value<std::uint32_t>(input);
+            p.location = read_coordinate(input);
+        }
+
+        state.pinned_coordinates.resize(read_value<std::uint64_t>(input));
+        for (auto& c : state.pinned_coordinates)
+        {
+            c = read_coordinate(input);
+        }
+
+        state.line_states.resize(read_value<std::uint64_t>(input));
+        for (auto& s : state.line_states)
+        {
+            s.reduced_line = read_line(input);
+            s.reduced_indices.resize(read_value<std::uint64_t>(input));
+            for (auto& idx : s.reduced_indices)
+            {
+                idx = read_value<std::uint32_t>(input);
+            }
+            s.shortcuts.resize(read_value<std::uint64_t>(input));
+            for (auto& c : s.shortcuts)
+            {
+                c.first = read_value<std::uint32_t>(input);
+                c.last = read_value<std::uint32_t>(input);
+            }
+        }
+
+        return state;
+    }
+
+private:
+    static constexpr char MAGIC[8] = {'D', 'B', 'S', 'T', 'A', 'T', 'E', '2'};
+
+    template<typename ValueT>
+    static void write_value(std::ostream& output, ValueT value)
+    {
+        output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template<typename ValueT>
+    static ValueT read_value(std::istream& input)
+    {
+        ValueT value;
+        input.read(reinterpret_cast<char*>(&value), sizeof(value));
+        if (!input)
+        {
+            throw std::runtime_error("The simplification state is truncated.");
+        }
+        return value;
+    }
+
+    static void write_coordinate(std::ostream& output, const CoordinateT& c)
+    {
+        write_value<value_type>(output, c.x);
+        write_value<value_type>(output, c.y);
+    }
+
+    static CoordinateT read_coordinate(std::istream& input)
+    {
+        auto x = read_value<value_type>(input);
+        auto y = read_value<value_type>(input);
+        return CoordinateT {x, y};
+    }
+
+    static void write_line(std::ostream& output, const line_type& l)
+    {
+        write_value<std::uint32_t>(output, l.id);
+        write_value<std::uint64_t>(output, l.coordinates.size());
+        for (const auto& c : l.coordinates)
+        {
+            write_coordinate(output, c);
+        }
+    }
+
+    static line_type read_line(std::istream& input)
+    {
+        line_type l;
+        l.id = read_value<std::uint32_t>(input);
+        l.coordinates.resize(read_value<std::uint64_t>(input));
+        for (auto& c : l.coordinates)
+        {
+            c = read_coordinate(input);
+        }
+        return l;
+    }
+};
+
+template<typename CoordinateT>
+constexpr char basic_simplification_state<CoordinateT>::MAGIC[8];
+
+using simplification_state = basic_simplification_state<coordinate>;
+
+#endif
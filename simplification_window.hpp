@@ -0,0 +1,61 @@
+#ifndef SIMPLIFICATION_WINDOW_HPP
+#define SIMPLIFICATION_WINDOW_HPP
+
+#include "poly_line.hpp"
+
+#include <algorithm>
+
+/// Limits the shortcuts starting at a vertex i to end within the next
+/// max_vertices vertices and within max_length of vertex i.
+/// The edge (i, i+1) is always inside the window. 0 disables a limit.
+///
+/// With a window of k vertices the per line work is O(n k log k) instead
+/// of O(n^2 log n), but the result might use more edges than necessary.
+struct simplification_window
+{
+    simplification_window() = default;
+
+    simplification_window(unsigned max_vertices, double max_length)
+    : max_vertices(max_vertices)
+    , max_length(max_length)
+    {
+    }
+
+    unsigned max_vertices = 0;
+    double max_length = 0;
+
+    bool is_bounded() const
+    {
+        return max_vertices > 0 || max_length > 0;
+    }
+
+    /// Returns the end of the window of vertex i (exclusive)
+    template<typename CoordinateT>
+    unsigned end(const basic_poly_line<CoordinateT>& line, unsigned i) const
+    {
+        unsigned window_end = line.coordinates.size();
+        if (max_vertices > 0)
+        {
+            window_end = std::min(window_end, i + max_vertices + 1);
+        }
+
+        if (max_length > 0)
+        {
+            const auto& origin = line.coordinates[i];
+            for (auto j = i + 2; j < window_end; ++j)
+            {
+                double dx = static_cast<double>(line.coordinates[j].x - origin.x);
+                double dy = static_cast<double>(line.coordinates[j].y - origin.y);
+                if (dx * dx + dy * dy > max_length * max_length)
+                {
+                    window_end = j;
+                    break;
+                }
+            }
+        }
+
+        return std::max(window_end, std::min<unsigned>(i + 2, line.coordinates.size()));
+    }
+};
+
+#endif
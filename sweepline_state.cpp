@@ -16,8 +16,8 @@ std::ostream& operator<<(std::ostream& rhs, const sweepline_state::edge& lhs)
     return rhs;
 }
 
-bool sweepline_state::edge_comparator(const sweepline_state::edge& lhs,
-                                      const sweepline_state::edge& rhs) const
+template<typename CoordinateT>
+bool basic_sweepline_state<CoordinateT>::edge_comparator(const edge& lhs, const edge& rhs) const
 {
     const auto& lhs_start = coordinates[lhs.first];
     const auto& lhs_end = coordinates[lhs.second];
@@ -37,17 +37,19 @@ bool sweepline_state::edge_comparator(const sweepline_state::edge& lhs,
     return result;
 }
 
-void sweepline_state::move_sweepline(const coordinate& position)
+template<typename CoordinateT>
+void basic_sweepline_state<CoordinateT>::move_sweepline(const CoordinateT& position)
 {
     sweepline_end = position;
 }
 
-void sweepline_state::insert_edge(const sweepline_state::edge& to_insert)
+template<typename CoordinateT>
+void basic_sweepline_state<CoordinateT>::insert_edge(const edge& to_insert)
 {
     BOOST_ASSERT(to_insert.first < to_insert.second);
 
     auto iter = std::lower_bound(intersecting_edges.begin(), intersecting_edges.end(),
-                                 to_insert, std::bind(&sweepline_state::edge_comparator, this,
+                                 to_insert, std::bind(&basic_sweepline_state::edge_comparator, this,
                                                       std::placeholders::_1, std::placeholders::_2));
 
     if (iter == intersecting_edges.end())
@@ -64,12 +66,13 @@ void sweepline_state::insert_edge(const sweepline_state::edge& to_insert)
     }
 }
 
-void sweepline_state::remove_edge(const sweepline_state::edge& to_remove)
+template<typename CoordinateT>
+void basic_sweepline_state<CoordinateT>::remove_edge(const edge& to_remove)
 {
     BOOST_ASSERT(to_remove.first < to_remove.second);
 
     auto iter = std::lower_bound(intersecting_edges.begin(), intersecting_edges.end(),
-                                 to_remove, std::bind(&sweepline_state::edge_comparator, this,
+                                 to_remove, std::bind(&basic_sweepline_state::edge_comparator, this,
                                                       std::placeholders::_1, std::placeholders::_2));
 
 
@@ -84,14 +87,16 @@ void sweepline_state::remove_edge(const sweepline_state::edge& to_remove)
     intersecting_edges.erase(iter);
 }
 
-sweepline_state::edge_iterator sweepline_state::get_first_intersecting(const coordinate& coord) const
+template<typename CoordinateT>
+typename basic_sweepline_state<CoordinateT>::edge_iterator
+basic_sweepline_state<CoordinateT>::get_first_intersecting(const CoordinateT& coord) const
 {
     BOOST_ASSERT_MSG(geometry::segment_intersection(sweepline_start, sweepline_end,
                                                     sweepline_start, coord).colinear,
                      "Sweepline must be moved forward for intersection search.");
 
     auto iter = std::lower_bound(intersecting_edges.begin(), intersecting_edges.end(), coord,
-                                 [this](const edge& lhs, const coordinate& rhs)
+                                 [this](const edge& lhs, const CoordinateT& rhs)
                                  {
                                     auto params = geometry::segment_intersection(sweepline_start, rhs, coordinates[lhs.first], coordinates[lhs.second]);
 
@@ -99,3 +104,8 @@ sweepline_state::edge_iterator sweepline_state::get_first_intersecting(const coo
                                  });
     return iter;
 }
+
+template class basic_sweepline_state<coordinate>;
+template class basic_sweepline_state<local_coordinate>;
+template class basic_sweepline_state<quantized_coordinate>;
+template class basic_sweepline_state<compact_quantized_coordinate>;
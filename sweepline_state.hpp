@@ -6,10 +6,11 @@
 #include <deque>
 #include <vector>
 
-class sweepline_state
+template<typename CoordinateT>
+class basic_sweepline_state
 {
 public:
-    sweepline_state(const std::vector<coordinate>& coordinates, unsigned start_vertex)
+    basic_sweepline_state(const std::vector<CoordinateT>& coordinates, unsigned start_vertex)
         : coordinates(coordinates)
         , sweepline_start(coordinates[start_vertex])
     {
@@ -21,19 +22,21 @@ public:
 
     edge_list intersecting_edges;
 
-    void move_sweepline(const coordinate& position);
+    void move_sweepline(const CoordinateT& position);
     void insert_edge(const edge& edge);
     void remove_edge(const edge& edge);
-    edge_iterator get_first_intersecting(const coordinate& coord) const;
+    edge_iterator get_first_intersecting(const CoordinateT& coord) const;
 
 private:
-    bool edge_comparator(const sweepline_state::edge& lhs, const sweepline_state::edge& rhs) const;
+    bool edge_comparator(const edge& lhs, const edge& rhs) const;
 
-    const std::vector<coordinate>& coordinates;
-    coordinate sweepline_start;
-    coordinate sweepline_end;
+    const std::vector<CoordinateT>& coordinates;
+    CoordinateT sweepline_start;
+    CoordinateT sweepline_end;
 };
 
+using sweepline_state = basic_sweepline_state<coordinate>;
+
 namespace std
 {
 template<typename FirstT, typename SecondT>
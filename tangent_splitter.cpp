@@ -2,6 +2,7 @@
 
 #include "poly_line.hpp"
 #include "geometry.hpp"
+#include "geometry_kernels.hpp"
 
 #include <algorithm>
 #include <boost/assert.hpp>
@@ -9,26 +10,62 @@
 /// Returns all maximal and minimal tangents that bound a facette.
 /// Each tangent stores the idx of the edge that splits the half-line starting
 /// at i, or NO_EGDE_ID if the tangent is not split.
-std::vector<shortcut> tangent_splitter::operator()(unsigned i) const
+/// The line is treated as if it would end before the vertex end.
+template<typename CoordinateT>
+std::vector<shortcut> basic_tangent_splitter<CoordinateT>::operator()(unsigned i, unsigned end) const
 {
-    auto number_of_tangents = line.coordinates.size() - i;
+    BOOST_ASSERT(end <= line.coordinates.size());
+    auto number_of_tangents = end - i;
+    if (number_of_tangents <= 2)
+    {
+        return {};
+    }
+
+    const auto* x = line_coordinates.x.data();
+    const auto* y = line_coordinates.y.data();
+
+    // position of the vertex before and after the end of every shortcut i -> i+idx,
+    // indexed by idx - 2. The last vertex has no vertex after it.
+    std::vector<signed char> signs_before(number_of_tangents - 2);
+    std::vector<signed char> signs_after(number_of_tangents - 2);
+    geometry_kernels::orientation_signs(line.coordinates[i], x + i + 2, y + i + 2, x + i + 1, y + i + 1,
+                                        number_of_tangents - 2, signs_before.data());
+    geometry_kernels::orientation_signs(line.coordinates[i], x + i + 2, y + i + 2, x + i + 3, y + i + 3,
+                                        number_of_tangents - 3, signs_after.data());
 
     std::vector<shortcut> tangents(number_of_tangents);
     for (auto idx = 2u; idx < number_of_tangents; idx++)
     {
-        tangents[idx] = shortcut {i, i+idx, NO_EDGE_ID, classify_shortcut(i, i+idx)};
+        tangents[idx] = shortcut {i, i+idx, NO_EDGE_ID,
+                                  classify_shortcut(signs_before[idx - 2], signs_after[idx - 2], idx < number_of_tangents - 1)};
 
         if (tangents[idx].classification == shortcut::type::MAXIMAL_TANGENT
          || tangents[idx].classification == shortcut::type::MINIMAL_TANGENT)
         {
+            // the edges prev_idx-1 -> prev_idx with prev_idx in [block_begin, block_end)
+            // were already tested against i -> i+idx
+            unsigned char block_intersects[SPLIT_EDGE_BLOCK_SIZE];
+            unsigned block_begin = 0;
+            unsigned block_end = 0;
+            auto intersects_edge = [&](unsigned prev_idx)
+            {
+                if (prev_idx < block_begin || prev_idx >= block_end)
+                {
+                    block_end = prev_idx + 1;
+                    block_begin = block_end >= SPLIT_EDGE_BLOCK_SIZE + 2 ? block_end - SPLIT_EDGE_BLOCK_SIZE : 2;
+                    geometry_kernels::segments_intersect_mask(line.coordinates[i], line.coordinates[i + idx],
+                                                              x + i + block_begin - 1, y + i + block_begin - 1,
+                                                              x + i + block_begin, y + i + block_begin,
+                                                              block_end - block_begin, block_intersects);
+                }
+                return block_intersects[prev_idx - block_begin] != 0;
+            };
+
             auto prev_idx = idx - 1;
             bool intersects = false;
             while (!intersects && prev_idx > 1)
             {
-                intersects = geometry::segments_intersect(line.coordinates[i + prev_idx - 1],
-                                                          line.coordinates[i + prev_idx],
-                                                          line.coordinates[i],
-                                                          line.coordinates[i + idx]);
+                intersects = intersects_edge(prev_idx);
 
                 if (!intersects && tangents[prev_idx].classification == tangents[idx].classification)
                 {
@@ -55,43 +92,62 @@ std::vector<shortcut> tangent_splitter::operator()(unsigned i) const
     return tangents;
 }
 
-shortcut::type
-tangent_splitter::classify_shortcut(const unsigned first, const unsigned last) const
+/// Scans the candidates backwards, usually the last one is already a tangent.
+template<typename CoordinateT>
+unsigned basic_tangent_splitter<CoordinateT>::last_tangent(unsigned i, unsigned end) const
 {
-    // shortcut is a single edge
-    BOOST_ASSERT(first < last);
-    if (last - first <= 1)
+    BOOST_ASSERT(end <= line.coordinates.size());
+    const auto& origin = line.coordinates[i];
+    auto sign = [&origin](const CoordinateT& second, const CoordinateT& third) -> signed char
     {
-        return shortcut::type::NO_TANGENT;
-    }
-
-    // in the trivial case last == line.coordinates.size()-1
-    // -> we only need to check the before element
-    BOOST_ASSERT(last > 0);
-    const auto& before_last = line.coordinates[last - 1];
-    auto pos_before = geometry::position_to_line(line.coordinates[first], line.coordinates[last], before_last);
+        auto o = geometry::orientation(origin, second, third);
+        return o > 0 ? 1 : (o < 0 ? -1 : 0);
+    };
 
-    // non-trivial case -> check both before and after
-    if (last != line.coordinates.size() - 1)
+    for (auto j = end; j-- > i + 2;)
     {
-        BOOST_ASSERT(last < line.coordinates.size()-1);
-        const auto& after_last = line.coordinates[last + 1];
-        auto pos_after = geometry::position_to_line(line.coordinates[first], line.coordinates[last], after_last);
-
-        if (pos_before != pos_after)
+        bool has_after = j + 1 < end;
+        auto sign_before = sign(line.coordinates[j], line.coordinates[j - 1]);
+        auto sign_after = has_after ? sign(line.coordinates[j], line.coordinates[j + 1]) : 0;
+        auto classification = classify_shortcut(sign_before, sign_after, has_after);
+        if (classification == shortcut::type::MAXIMAL_TANGENT
+         || classification == shortcut::type::MINIMAL_TANGENT)
         {
-            return shortcut::type::NO_TANGENT;
+            return j;
         }
     }
 
-    switch (pos_before)
+    return i + 1;
+}
+
+/// Classifies the shortcut by the position of the vertices before and after its end
+/// relative to the shortcut. In the trivial case the end is the last vertex of the line
+/// and only the vertex before it is checked.
+template<typename CoordinateT>
+shortcut::type
+basic_tangent_splitter<CoordinateT>::classify_shortcut(signed char sign_before, signed char sign_after, bool has_after)
+{
+    if (has_after && sign_before != sign_after)
+    {
+        return shortcut::type::NO_TANGENT;
+    }
+
+    if (sign_before > 0)
+    {
+        return shortcut::type::MINIMAL_TANGENT;
+    }
+    else if (sign_before < 0)
     {
-        case geometry::point_position::LEFT_OF_LINE:
-            return shortcut::type::MINIMAL_TANGENT;
-        case geometry::point_position::RIGHT_OF_LINE:
-            return shortcut::type::MAXIMAL_TANGENT;
-        default:
-            return shortcut::type::DEGENERATED_TANGENT;
+        return shortcut::type::MAXIMAL_TANGENT;
     }
+
+    return shortcut::type::DEGENERATED_TANGENT;
 }
 
+template<typename CoordinateT>
+constexpr unsigned basic_tangent_splitter<CoordinateT>::SPLIT_EDGE_BLOCK_SIZE;
+
+template class basic_tangent_splitter<coordinate>;
+template class basic_tangent_splitter<local_coordinate>;
+template class basic_tangent_splitter<quantized_coordinate>;
+template class basic_tangent_splitter<compact_quantized_coordinate>;
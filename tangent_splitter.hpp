@@ -2,29 +2,48 @@
 #define TANGENT_SPLITTER_HPP
 
 #include "shortcut.hpp"
+#include "poly_line.hpp"
+#include "geometry_kernels.hpp"
 
 #include <vector>
 
-class poly_line;
-
 /**
  * A tangent splitter is bound to a line object.
  *
  * It finds all the tangents for a given vertices.
  *
  */
-class tangent_splitter
+template<typename CoordinateT>
+class basic_tangent_splitter
 {
 public:
-    tangent_splitter(const poly_line& original_line)
+    basic_tangent_splitter(const basic_poly_line<CoordinateT>& original_line)
         : line(original_line)
+        , line_coordinates(original_line.coordinates.begin(), original_line.coordinates.end())
+    {
+    }
+
+    std::vector<shortcut> operator()(unsigned i) const
     {
+        return (*this)(i, line.coordinates.size());
     }
 
-    std::vector<shortcut> operator()(unsigned i) const;
+    /// Only considers shortcuts from i to vertices before end
+    std::vector<shortcut> operator()(unsigned i, unsigned end) const;
+
+    /// Returns the last vertex of the last tangent of i before end, or i+1 if there is none.
+    /// This is all the shortcut acceptor needs if there are no points to distribute.
+    unsigned last_tangent(unsigned i, unsigned end) const;
 
 private:
-    shortcut::type classify_shortcut(const unsigned first, const unsigned last) const;
-    const poly_line& line;
+    /// Number of edges that are tested at once while searching the split edge
+    static constexpr unsigned SPLIT_EDGE_BLOCK_SIZE = 8;
+
+    static shortcut::type classify_shortcut(signed char sign_before, signed char sign_after, bool has_after);
+    const basic_poly_line<CoordinateT>& line;
+    geometry_kernels::coordinate_array<CoordinateT> line_coordinates;
 };
+
+using tangent_splitter = basic_tangent_splitter<coordinate>;
+
 #endif
@@ -0,0 +1,109 @@
+#include "../chunked_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_SUITE(chunked_simplification_tests)
+
+namespace
+{
+poly_line zig_zag_line(unsigned size)
+{
+    poly_line line {0, {}};
+    for (auto i = 0u; i < size; ++i)
+    {
+        line.coordinates.push_back(coordinate {static_cast<double>(i), (i % 3 == 0) ? 1.0 : (i % 3 == 1 ? 0.0 : 0.5)});
+    }
+    return line;
+}
+
+std::vector<point> points_below(const poly_line& line)
+{
+    std::vector<point> points;
+    for (auto i = 1u; i < line.coordinates.size(); i += 4)
+    {
+        points.push_back({point::NO_LINE_ID, i, coordinate {i - 0.5, 0.6}});
+    }
+    return points;
+}
+
+template<typename SimplificationT>
+std::vector<std::pair<unsigned, unsigned>> get_edges(const poly_line& line, const std::vector<point>& points,
+                                                     const simplification_options& options)
+{
+    auto points_copy = points;
+    SimplificationT simplification(line, std::move(points_copy), options);
+    std::vector<std::pair<unsigned, unsigned>> edges;
+    for (const auto& s : simplification())
+    {
+        edges.emplace_back(s.first, s.last);
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+}
+
+BOOST_AUTO_TEST_CASE(single_chunk_test)
+{
+    auto line = zig_zag_line(30);
+    auto points = points_below(line);
+
+    simplification_options options;
+    options.chunk_size = line.coordinates.size();
+    options.chunk_overlap = 4;
+
+    auto full = get_edges<deberg<bb_point_filter>>(line, points, options);
+    auto chunked = get_edges<chunked_simplification<deberg<bb_point_filter>>>(line, points, options);
+    BOOST_CHECK(full == chunked);
+}
+
+BOOST_AUTO_TEST_CASE(overlapping_chunks_test)
+{
+    auto line = zig_zag_line(50);
+    auto points = points_below(line);
+
+    auto full = get_edges<deberg<bb_point_filter>>(line, points, simplification_options());
+
+    simplification_options options;
+    options.chunk_size = 8;
+    options.chunk_overlap = 3;
+    auto chunked = get_edges<chunked_simplification<deberg<bb_point_filter>>>(line, points, options);
+
+    // every shortcut of a chunk is a valid shortcut of the whole line
+    for (const auto& e : chunked)
+    {
+        BOOST_CHECK(std::binary_search(full.begin(), full.end(), e));
+        BOOST_CHECK_LT(e.second - e.first, options.chunk_size);
+    }
+
+    // the original edges are always kept so the chunks are connected
+    for (auto i = 0u; i + 1 < line.coordinates.size(); ++i)
+    {
+        BOOST_CHECK(std::binary_search(chunked.begin(), chunked.end(), std::make_pair(i, i + 1)));
+    }
+
+    // no duplicates from the overlaps
+    BOOST_CHECK(std::adjacent_find(chunked.begin(), chunked.end()) == chunked.end());
+
+    options.num_threads = 4;
+    auto parallel = get_edges<chunked_simplification<deberg<bb_point_filter>>>(line, points, options);
+    BOOST_CHECK(chunked == parallel);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_chunk_size_test)
+{
+    auto line = zig_zag_line(10);
+
+    simplification_options options;
+    options.chunk_size = 5;
+    options.chunk_overlap = 4;
+    BOOST_CHECK_THROW(chunked_simplification<deberg<bb_point_filter>>(line, std::vector<point>(), options),
+                      std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
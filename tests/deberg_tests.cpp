@@ -1,10 +1,13 @@
 #include "../deberg.hpp"
 #include "../bb_point_filter.hpp"
+#include "../static_graph.hpp"
+#include "../graph_util.hpp"
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/test_case_template.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 BOOST_AUTO_TEST_SUITE(deberg_tests)
 
@@ -118,4 +121,158 @@ BOOST_AUTO_TEST_CASE(self_intersection_test)
 
 }
 
+BOOST_AUTO_TEST_CASE(window_test)
+{
+    poly_line line {0, {
+        coordinate {0, 0},
+        coordinate {1, 1},
+        coordinate {2, 0.5},
+        coordinate {3, 2},
+        coordinate {4, 1},
+        coordinate {5, 3},
+        coordinate {6, 0},
+        coordinate {7, 1},
+    }};
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2.5, 1.0}},
+        {point::NO_LINE_ID, 1, coordinate {5.5, 0.5}},
+    };
+
+    auto run = [&](const simplification_window& window)
+    {
+        auto points_copy = points;
+        deberg<bb_point_filter> simplification(line, std::move(points_copy), simplification_options(window));
+        auto shortcuts = simplification();
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        for (const auto& s : shortcuts)
+        {
+            edges.emplace_back(s.first, s.last);
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    };
+
+    auto unbounded = run(simplification_window());
+    BOOST_CHECK(run(simplification_window(line.coordinates.size(), 0)) == unbounded);
+
+    for (auto k = 1u; k < line.coordinates.size(); ++k)
+    {
+        auto windowed = run(simplification_window(k, 0));
+        for (const auto& e : windowed)
+        {
+            BOOST_CHECK_LE(e.second - e.first, k);
+        }
+        // the trivial edges are always valid
+        for (auto i = 0u; i + 1 < line.coordinates.size(); ++i)
+        {
+            BOOST_CHECK(std::find(windowed.begin(), windowed.end(), std::make_pair(i, i + 1)) != windowed.end());
+        }
+        BOOST_CHECK(std::includes(unbounded.begin(), unbounded.end(), windowed.begin(), windowed.end()));
+    }
+
+    auto length_bounded = run(simplification_window(0, 2.5));
+    for (const auto& e : length_bounded)
+    {
+        auto delta = line.coordinates[e.second] - line.coordinates[e.first];
+        BOOST_CHECK(e.second == e.first + 1 || delta.x * delta.x + delta.y * delta.y <= 2.5 * 2.5);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unconstrained_fast_path_test)
+{
+    // x-monotone so the line is a single subpath without any points
+    poly_line line {0, {}};
+    unsigned state = 7;
+    for (auto i = 0u; i < 50; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        line.coordinates.push_back(coordinate {static_cast<double>(i), static_cast<double>((state >> 16) % 7)});
+    }
+
+    for (auto k : {0u, 5u})
+    {
+        simplification_window window(k, 0);
+
+        // the full sweep without points
+        basic_tangent_splitter<coordinate> splitter(line);
+        basic_point_distributor<coordinate> distributor(line, std::vector<point>());
+        basic_shortcut_acceptor<coordinate> acceptor(line);
+        std::vector<std::pair<unsigned, unsigned>> expected;
+        for (auto i = 0u; i + 1 < line.coordinates.size(); ++i)
+        {
+            auto end = window.end(line, i);
+            auto tangents = splitter(i, end);
+            auto assignments = distributor(i, tangents, end);
+            for (const auto& s : acceptor(i, tangents, assignments, end))
+            {
+                expected.emplace_back(s.first, s.last);
+            }
+        }
+        std::sort(expected.begin(), expected.end());
+
+        deberg<bb_point_filter> simplification(line, std::vector<point>(), simplification_options(window));
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        for (const auto& s : simplification())
+        {
+            edges.emplace_back(s.first, s.last);
+        }
+        std::sort(edges.begin(), edges.end());
+
+        BOOST_CHECK(edges == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(goal_directed_test)
+{
+    poly_line line {0, {}};
+    std::vector<point> points;
+    unsigned state = 11;
+    for (auto i = 0u; i < 60; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        auto x = 10.0 * std::sin(i * 0.2) + i;
+        auto y = static_cast<double>((state >> 16) % 13);
+        line.coordinates.push_back(coordinate {x, y});
+        if (i % 3 == 0)
+        {
+            points.push_back({point::NO_LINE_ID, i, coordinate {x + 0.5, y + 0.25}});
+        }
+    }
+
+    auto shortest_path_length = [&](std::vector<shortcut>&& shortcuts)
+    {
+        std::sort(shortcuts.begin(), shortcuts.end(),
+                  [](const shortcut& lhs, const shortcut& rhs)
+                  {
+                      return lhs.first < rhs.first || (lhs.first == rhs.first && lhs.last < rhs.last);
+                  });
+        static_graph<shortcut> graph(line.coordinates.size(), std::move(shortcuts));
+        auto path_info = graph_util::shortest_dag_path(graph, 0, line.coordinates.size() - 1);
+        return path_info.distance[line.coordinates.size() - 1];
+    };
+
+    for (auto with_points : {false, true})
+    {
+        auto points_copy = with_points ? points : std::vector<point>();
+        deberg<bb_point_filter> full(line, std::move(points_copy));
+        auto full_shortcuts = full();
+
+        points_copy = with_points ? points : std::vector<point>();
+        simplification_options options;
+        options.goal_directed = true;
+        deberg<bb_point_filter> goal_directed(line, std::move(points_copy), options);
+        auto goal_directed_shortcuts = goal_directed();
+
+        // a subset of the valid shortcuts with the same shortest path
+        for (const auto& s : goal_directed_shortcuts)
+        {
+            BOOST_CHECK(std::find_if(full_shortcuts.begin(), full_shortcuts.end(),
+                                     [&s](const shortcut& f) { return f.first == s.first && f.last == s.last; })
+                        != full_shortcuts.end());
+        }
+        BOOST_CHECK_LE(goal_directed_shortcuts.size(), full_shortcuts.size());
+        BOOST_CHECK_EQUAL(shortest_path_length(std::move(goal_directed_shortcuts)), shortest_path_length(std::move(full_shortcuts)));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,157 @@
+#include "../deviation_cone.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+BOOST_AUTO_TEST_SUITE(deviation_cone_tests)
+
+namespace
+{
+double segment_distance(const coordinate& p, const coordinate& a, const coordinate& b)
+{
+    auto dx = b.x - a.x;
+    auto dy = b.y - a.y;
+    auto length = dx * dx + dy * dy;
+    auto t = length > 0 ? std::max(0.0, std::min(1.0, ((p.x - a.x) * dx + (p.y - a.y) * dy) / length)) : 0.0;
+    return std::hypot(p.x - (a.x + t * dx), p.y - (a.y + t * dy));
+}
+
+double max_deviation(const poly_line& line, unsigned i, unsigned j)
+{
+    double deviation = 0;
+    for (auto k = i + 1; k < j; ++k)
+    {
+        deviation = std::max(deviation, segment_distance(line.coordinates[k], line.coordinates[i], line.coordinates[j]));
+    }
+    return deviation;
+}
+
+// x-monotone line with some noise
+poly_line noisy_line(unsigned size)
+{
+    poly_line line {0, {}};
+    unsigned state = 1;
+    for (auto i = 0u; i < size; ++i)
+    {
+        state = state * 1103515245u + 12345u;
+        auto noise = static_cast<double>((state >> 16) % 1000) / 1000.0;
+        line.coordinates.push_back(coordinate {i + 0.5 * noise, std::sin(i * 0.3) + noise});
+    }
+    return line;
+}
+}
+
+BOOST_AUTO_TEST_CASE(brute_force_test)
+{
+    auto line = noisy_line(60);
+
+    for (auto epsilon : {0.05, 0.3, 1.0, 5.0})
+    {
+        basic_deviation_cone<coordinate> cone(line, epsilon);
+        for (auto i = 0u; i + 1 < line.coordinates.size(); ++i)
+        {
+            BOOST_CHECK(cone.admissible(i, i + 1));
+            BOOST_CHECK_GT(cone.end(i), i + 1);
+
+            for (auto j = i + 1; j < line.coordinates.size(); ++j)
+            {
+                BOOST_CHECK_EQUAL(cone.admissible(i, j), max_deviation(line, i, j) <= epsilon);
+                if (j >= cone.end(i))
+                {
+                    BOOST_CHECK(!cone.admissible(i, j));
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(turning_back_test)
+{
+    // steep teeth, so vertices before j are often farther from i than j
+    poly_line line {0, {}};
+    for (auto i = 0u; i < 30; ++i)
+    {
+        line.coordinates.push_back(coordinate {0.1 * i, (i % 2 == 0 ? 0.0 : 4.0) + 0.3 * (i % 3)});
+    }
+
+    for (auto epsilon : {0.5, 2.0, 3.0})
+    {
+        // the fans are asked for in any order and from the back
+        basic_deviation_cone<coordinate> cone(line, epsilon);
+        for (auto i = line.coordinates.size() - 1; i-- > 0;)
+        {
+            for (auto j = line.coordinates.size(); j-- > i + 1;)
+            {
+                BOOST_CHECK_EQUAL(cone.admissible(i, j), max_deviation(line, i, j) <= epsilon);
+                BOOST_CHECK_EQUAL(cone.admissible(0, 2), max_deviation(line, 0, 2) <= epsilon);
+            }
+            BOOST_CHECK_LE(cone.end(i, i + 3), i + 3);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(unbounded_test)
+{
+    auto line = noisy_line(10);
+    basic_deviation_cone<coordinate> cone(line, 0);
+    BOOST_CHECK(!cone.is_bounded());
+    BOOST_CHECK_EQUAL(cone.end(0), line.coordinates.size());
+    BOOST_CHECK(cone.admissible(0, 9));
+}
+
+BOOST_AUTO_TEST_CASE(deberg_test)
+{
+    //
+    //      2
+    //     / \       a
+    //  0-1   3----------4
+    //
+    poly_line line {0, {
+        coordinate {0, 0},
+        coordinate {1, 0.2},
+        coordinate {2, 1},
+        coordinate {3, 0.2},
+        coordinate {10, 0},
+    }};
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {7, 0.5}},
+    };
+
+    auto run = [&](double epsilon)
+    {
+        auto points_copy = points;
+        simplification_options options;
+        options.max_deviation = epsilon;
+        deberg<bb_point_filter> simplification(line, std::move(points_copy), options);
+        std::vector<std::pair<unsigned, unsigned>> edges;
+        for (const auto& s : simplification())
+        {
+            edges.emplace_back(s.first, s.last);
+        }
+        std::sort(edges.begin(), edges.end());
+        return edges;
+    };
+
+    auto unbounded = run(0);
+    BOOST_CHECK(std::binary_search(unbounded.begin(), unbounded.end(), std::make_pair(0u, 4u)));
+
+    // a large bound does not remove anything
+    BOOST_CHECK(run(100) == unbounded);
+
+    auto bounded = run(0.5);
+    for (const auto& e : bounded)
+    {
+        BOOST_CHECK(std::binary_search(unbounded.begin(), unbounded.end(), e));
+        BOOST_CHECK_LE(max_deviation(line, e.first, e.second), 0.5);
+    }
+    BOOST_CHECK(!std::binary_search(bounded.begin(), bounded.end(), std::make_pair(0u, 4u)));
+    BOOST_CHECK(std::binary_search(bounded.begin(), bounded.end(), std::make_pair(0u, 1u)));
+    BOOST_CHECK(std::binary_search(bounded.begin(), bounded.end(), std::make_pair(3u, 4u)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
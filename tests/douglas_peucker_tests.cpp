@@ -0,0 +1,185 @@
+#include "../douglas_peucker.hpp"
+#include "../deberg.hpp"
+#include "../map_simplification.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+
+#include <algorithm>
+
+BOOST_AUTO_TEST_SUITE(douglas_peucker_tests)
+
+namespace
+{
+std::vector<std::pair<unsigned, unsigned>> get_edges(const poly_line& line, std::vector<point> points, double max_deviation,
+                                                     unsigned target_edges = 0)
+{
+    simplification_options options;
+    options.max_deviation = max_deviation;
+    options.target_edges = target_edges;
+    douglas_peucker<bb_point_filter> simplification(line, std::move(points), options);
+    std::vector<std::pair<unsigned, unsigned>> edges;
+    for (const auto& s : simplification())
+    {
+        edges.emplace_back(s.first, s.last);
+    }
+    return edges;
+}
+}
+
+BOOST_AUTO_TEST_CASE(unconstrained_test)
+{
+    poly_line line {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, -1}, coordinate {3, 1}, coordinate {4, 0}}};
+
+    std::vector<std::pair<unsigned, unsigned>> expected {{0, 4}};
+    BOOST_CHECK(get_edges(line, {}, 0) == expected);
+
+    // the tolerance re-inserts the farthest vertices
+    for (const auto& e : get_edges(line, {}, 0.5))
+    {
+        BOOST_CHECK_EQUAL(e.second - e.first, 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(repair_test)
+{
+    /*
+            1
+           / \      3
+          /a  \    / \
+         0     \  /   4
+                2
+    */
+    poly_line line {0, {coordinate {0, 0}, coordinate {1, 2}, coordinate {2, -1}, coordinate {3, 1}, coordinate {4, 0}}};
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {1, 1}},
+    };
+
+    // a is inside of every polygon that removes vertex 1
+    auto edges = get_edges(line, points, 0);
+    std::vector<std::pair<unsigned, unsigned>> expected {{0, 1}, {1, 4}};
+    BOOST_CHECK(edges == expected);
+
+    // a point on the shortcut blocks it as well
+    points[0].location = coordinate {2, 0};
+    edges = get_edges(line, points, 0);
+    BOOST_CHECK(std::find(edges.begin(), edges.end(), std::make_pair(0u, 4u)) == edges.end());
+}
+
+BOOST_AUTO_TEST_CASE(winding_test)
+{
+    // the line spirals twice around a, so an even-odd test sees a outside of the polygon of 0 -> 8
+    poly_line line {0, {coordinate {10, 0}, coordinate {0, 10}, coordinate {-10, 0}, coordinate {0, -10},
+                        coordinate {9, 0.2}, coordinate {0, 9}, coordinate {-9, 0}, coordinate {0, -9},
+                        coordinate {8, 0.5}}};
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {0, 0}}, // a
+    };
+
+    auto edges = get_edges(line, points, 0);
+    BOOST_CHECK(std::find(edges.begin(), edges.end(), std::make_pair(0u, 8u)) == edges.end());
+    BOOST_CHECK(edges.size() > 1);
+
+    // without a every shortcut is valid
+    std::vector<std::pair<unsigned, unsigned>> expected {{0, 8}};
+    BOOST_CHECK(get_edges(line, {}, 0) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(target_edges_test)
+{
+    poly_line line {0, {}};
+    for (auto i = 0u; i < 20; ++i)
+    {
+        line.coordinates.push_back(coordinate {static_cast<double>(i), (i % 3) * 0.5 + (i % 7) * 0.25});
+    }
+
+    for (auto target = 1u; target < line.coordinates.size(); ++target)
+    {
+        auto edges = get_edges(line, {}, 0, target);
+        BOOST_CHECK_EQUAL(edges.size(), target);
+
+        // a single path from the first to the last vertex
+        BOOST_REQUIRE(!edges.empty());
+        BOOST_CHECK_EQUAL(edges.front().first, 0);
+        BOOST_CHECK_EQUAL(edges.back().second, line.coordinates.size() - 1);
+        for (auto k = 1u; k < edges.size(); ++k)
+        {
+            BOOST_CHECK_EQUAL(edges[k - 1].second, edges[k].first);
+        }
+    }
+
+    // the first split is at the farthest vertex of 0 -> 19
+    auto edges = get_edges(line, {}, 0, 2);
+    BOOST_CHECK_EQUAL(edges[0].second, 5);
+
+    // a target beyond the number of vertices keeps the line
+    BOOST_CHECK_EQUAL(get_edges(line, {}, 0, 100).size(), line.coordinates.size() - 1);
+}
+
+BOOST_AUTO_TEST_CASE(target_edges_repair_test)
+{
+    // same as repair_test, the topology needs two edges although one is asked for
+    poly_line line {0, {coordinate {0, 0}, coordinate {1, 2}, coordinate {2, -1}, coordinate {3, 1}, coordinate {4, 0}}};
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {1, 1}},
+    };
+
+    std::vector<std::pair<unsigned, unsigned>> expected {{0, 1}, {1, 4}};
+    BOOST_CHECK(get_edges(line, points, 0, 1) == expected);
+
+    // the split of 1 -> 4 re-inserts its farthest vertex 2
+    expected = {{0, 1}, {1, 2}, {2, 4}};
+    BOOST_CHECK(get_edges(line, points, 0, 3) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(map_simplification_test)
+{
+    std::vector<coordinate> cs = {
+        coordinate {0, 0},      // 0
+        coordinate {0, 1},      // 1
+        coordinate {1, 1},      // 2
+        coordinate {1, 2},      // 3
+        coordinate {1.5, 2},    // 4
+        coordinate {2, 3},      // 5
+        coordinate {2.5, 3},    // 6
+        coordinate {3, 2},      // 7
+        coordinate {4, 2},      // 8
+        coordinate {4, 0},      // 9
+        coordinate {2, 0},      // 10
+        coordinate {3.5, 1.75}, // 11
+    };
+
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2.25, 2.75}},
+        {point::NO_LINE_ID, 1, coordinate {2.1, 0.05}},
+        {point::NO_LINE_ID, 2, coordinate {0.9, 1.1}},
+        {point::NO_LINE_ID, 3, coordinate {1.1, 1.1}},
+    };
+
+    std::vector<poly_line> lines = {
+        {0, {cs[10], cs[0], cs[1], cs[2], cs[3]}},
+        {1, {cs[3], cs[10]}},
+        {2, {cs[3], cs[4], cs[5], cs[6], cs[7], cs[8], cs[9]}},
+        {3, {cs[10], cs[11], cs[9]}},
+        {4, {cs[10], cs[9]}},
+    };
+
+    auto lines_copy = lines;
+    auto points_copy = points;
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> optimal(std::move(lines_copy), std::move(points_copy));
+    optimal(100);
+
+    map_simplification<douglas_peucker<bb_point_filter>, bb_point_filter> simplification(std::move(lines), std::move(points));
+    auto simplified = simplification(100);
+
+    BOOST_REQUIRE_EQUAL(simplified.size(), 5);
+    BOOST_CHECK_GE(simplification.used_edges(), optimal.used_edges());
+
+    // the point a stays below line 2 and the point b above line 4
+    const auto& indices = simplification.original_indices();
+    BOOST_CHECK(std::find(indices[2].begin(), indices[2].end(), 5) != indices[2].end() ||
+                std::find(indices[2].begin(), indices[2].end(), 6) != indices[2].end());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+#include "../edge_allocation.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+BOOST_AUTO_TEST_SUITE(edge_allocation_tests)
+
+namespace
+{
+std::vector<shortcut> all_shortcuts(const poly_line& line)
+{
+    std::vector<shortcut> shortcuts;
+    for (auto i = 0u; i < line.coordinates.size(); ++i)
+    {
+        for (auto j = i + 1; j < line.coordinates.size(); ++j)
+        {
+            shortcuts.emplace_back(i, j);
+        }
+    }
+    return shortcuts;
+}
+
+/// Largest distance of a removed vertex to the shortcut, computed over all removed vertices
+double brute_force_error(const poly_line& line, const shortcut& s)
+{
+    const auto& first = line.coordinates[s.first];
+    const auto& last = line.coordinates[s.last];
+    double dx = last.x - first.x;
+    double dy = last.y - first.y;
+    double length = dx * dx + dy * dy;
+
+    double error = 0;
+    for (auto k = s.first + 1; k < s.last; ++k)
+    {
+        double px = line.coordinates[k].x - first.x;
+        double py = line.coordinates[k].y - first.y;
+        double t = length > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / length)) : 0.0;
+        error = std::max(error, std::hypot(px - t * dx, py - t * dy));
+    }
+    return error;
+}
+}
+
+BOOST_AUTO_TEST_CASE(threshold_test)
+{
+    // a flat line with a small and a large bump
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}}},
+        {1, {coordinate {0, 10}, coordinate {1, 13}, coordinate {2, 10}}},
+    };
+    std::vector<std::vector<shortcut>> shortcuts = {all_shortcuts(lines[0]), all_shortcuts(lines[1])};
+    edge_allocation allocation(lines, shortcuts);
+
+    BOOST_CHECK_EQUAL(allocation.edges(std::numeric_limits<double>::infinity()), 2);
+    BOOST_CHECK_EQUAL(allocation.edges(0), 4);
+
+    // the large bump is kept first
+    BOOST_CHECK_EQUAL(allocation.threshold(4), 0);
+    BOOST_CHECK_EQUAL(allocation.threshold(3), 1);
+    BOOST_CHECK_EQUAL(allocation.threshold(2), 3);
+    BOOST_CHECK_EQUAL(allocation.filter(1, 1).size(), 2);
+    BOOST_CHECK_EQUAL(allocation.filter(0, 1).size(), 3);
+
+    // below the minimum there is no threshold
+    BOOST_CHECK_EQUAL(allocation.threshold(1), std::numeric_limits<double>::infinity());
+}
+
+BOOST_AUTO_TEST_CASE(hull_error_test)
+{
+    // a zig-zag with collinear and repeated vertices and a convex arc, where the hull keeps every vertex
+    poly_line zig_zag {0, {}};
+    for (auto k = 0; k < 40; ++k)
+    {
+        zig_zag.coordinates.push_back(coordinate {static_cast<double>(k), static_cast<double>((k * 7) % 5 - (k % 3 == 0 ? 4 : 0))});
+    }
+    zig_zag.coordinates[10] = zig_zag.coordinates[9];
+    poly_line arc {1, {}};
+    for (auto k = 0; k < 20; ++k)
+    {
+        arc.coordinates.push_back(coordinate {static_cast<double>(k), static_cast<double>(k * k)});
+    }
+
+    std::vector<poly_line> lines = {zig_zag, arc};
+    std::vector<std::vector<shortcut>> shortcuts = {all_shortcuts(lines[0]), all_shortcuts(lines[1])};
+    edge_allocation allocation(lines, shortcuts);
+
+    for (auto i = 0u; i < lines.size(); ++i)
+    {
+        for (const auto& s : shortcuts[i])
+        {
+            auto error = brute_force_error(lines[i], s);
+            auto count = std::count_if(shortcuts[i].begin(), shortcuts[i].end(),
+                                       [&](const shortcut& other) { return brute_force_error(lines[i], other) <= error; });
+            BOOST_CHECK_EQUAL(allocation.filter(i, error).size(), count);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
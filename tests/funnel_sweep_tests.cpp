@@ -0,0 +1,102 @@
+#include "../funnel_sweep.hpp"
+#include "../tangent_splitter.hpp"
+#include "../point_distributor.hpp"
+#include "../shortcut_acceptor.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+
+#include <algorithm>
+
+BOOST_AUTO_TEST_SUITE(funnel_sweep_tests)
+
+BOOST_AUTO_TEST_CASE(simple_test)
+{
+    /*
+             b
+           1   3
+          / \a/ \
+         0   2   4
+    */
+    poly_line line {0, {
+        coordinate {0, 0},
+        coordinate {1, 2},
+        coordinate {2, 0},
+        coordinate {3, 2},
+        coordinate {4, 0},
+    }};
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2, 1}},   // a
+        {point::NO_LINE_ID, 1, coordinate {2, 2.5}}, // b
+    };
+
+    funnel_sweep funnel(line, points);
+
+    auto to_last = [](const std::vector<shortcut>& shortcuts)
+    {
+        std::vector<unsigned> last;
+        for (const auto& s : shortcuts)
+        {
+            last.push_back(s.last);
+        }
+        return last;
+    };
+
+    // a is above the line, so every shortcut from 1 would have to pass below it
+    std::vector<unsigned> expected_1 {2};
+    auto last_1 = to_last(funnel(1));
+    BOOST_CHECK_EQUAL_COLLECTIONS(last_1.begin(), last_1.end(), expected_1.begin(), expected_1.end());
+
+    // 0 -> 4 passes below a, 0 -> 3 would pass above it
+    std::vector<unsigned> expected_0 {1, 2, 4};
+    auto last_0 = to_last(funnel(0));
+    BOOST_CHECK_EQUAL_COLLECTIONS(last_0.begin(), last_0.end(), expected_0.begin(), expected_0.end());
+}
+
+BOOST_AUTO_TEST_CASE(matches_sweep_test)
+{
+    unsigned state = 3;
+    auto random = [&state](unsigned range)
+    {
+        state = state * 1103515245u + 12345u;
+        return static_cast<double>((state >> 8) % (range * 1024)) / 1024.0;
+    };
+
+    for (auto run = 0u; run < 20; ++run)
+    {
+        poly_line line {0, {}};
+        double x = 0;
+        for (auto i = 0u; i < 30; ++i)
+        {
+            x += 0.1 + random(2);
+            line.coordinates.push_back(coordinate {x, random(10)});
+        }
+        std::vector<point> points;
+        for (auto k = 0u; k < 15; ++k)
+        {
+            points.push_back({point::NO_LINE_ID, k, coordinate {random(static_cast<unsigned>(x)), random(10)}});
+        }
+
+        funnel_sweep funnel(line, points);
+        tangent_splitter splitter(line);
+        point_distributor distributor(line, points);
+        shortcut_acceptor acceptor(line);
+
+        for (auto i = 0u; i + 1 < line.coordinates.size(); ++i)
+        {
+            auto tangents = splitter(i);
+            auto expected = acceptor(i, tangents, distributor(i, tangents));
+            auto shortcuts = funnel(i);
+
+            std::vector<unsigned> expected_last;
+            std::vector<unsigned> last;
+            for (const auto& s : expected) expected_last.push_back(s.last);
+            for (const auto& s : shortcuts) last.push_back(s.last);
+            std::sort(expected_last.begin(), expected_last.end());
+
+            BOOST_CHECK_EQUAL_COLLECTIONS(last.begin(), last.end(), expected_last.begin(), expected_last.end());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
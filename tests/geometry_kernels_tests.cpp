@@ -0,0 +1,205 @@
+#include "../geometry_kernels.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+namespace
+{
+/// Random coordinates on a coarse grid, so that collinear and touching configurations are frequent
+template<typename CoordinateT = coordinate>
+geometry_kernels::coordinate_array<CoordinateT> random_coordinates(std::mt19937& generator, unsigned n)
+{
+    std::uniform_int_distribution<int> distribution(-4, 4);
+    geometry_kernels::coordinate_array<CoordinateT> coordinates;
+    for (auto k = 0u; k < n; ++k)
+    {
+        coordinates.x.push_back(distribution(generator) * 0.5f);
+        coordinates.y.push_back(distribution(generator) * 0.5f);
+    }
+    return coordinates;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(geometry_kernels_tests)
+
+BOOST_AUTO_TEST_CASE(orientation_signs_test)
+{
+    std::mt19937 generator(42);
+    const unsigned n = 1003;
+    auto second = random_coordinates(generator, n);
+    auto third = random_coordinates(generator, n);
+    const coordinate origin {0.5, -1.0};
+
+    std::vector<signed char> scalar(n), avx2(n), dispatched(n);
+    geometry_kernels::detail::orientation_signs_scalar(origin.x, origin.y, second.x.data(), second.y.data(),
+                                                       third.x.data(), third.y.data(), n, scalar.data());
+    geometry_kernels::detail::orientation_signs_avx2(origin.x, origin.y, second.x.data(), second.y.data(),
+                                                     third.x.data(), third.y.data(), n, avx2.data());
+    geometry_kernels::orientation_signs(origin, second.x.data(), second.y.data(),
+                                        third.x.data(), third.y.data(), n, dispatched.data());
+
+    for (auto k = 0u; k < n; ++k)
+    {
+        auto position = geometry::position_to_line(origin, coordinate {second.x[k], second.y[k]}, coordinate {third.x[k], third.y[k]});
+        signed char expected = position == geometry::point_position::LEFT_OF_LINE ? 1 :
+                               (position == geometry::point_position::RIGHT_OF_LINE ? -1 : 0);
+        BOOST_CHECK_EQUAL(scalar[k], expected);
+        BOOST_CHECK_EQUAL(avx2[k], expected);
+        BOOST_CHECK_EQUAL(dispatched[k], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bounding_box_mask_test)
+{
+    std::mt19937 generator(23);
+    const unsigned n = 515;
+    auto points = random_coordinates(generator, n);
+    const coordinate min {-1.0, -0.5};
+    const coordinate max {1.5, 1.0};
+
+    std::vector<unsigned char> scalar(n), avx2(n), dispatched(n);
+    geometry_kernels::detail::bounding_box_mask_scalar(min.x, min.y, max.x, max.y, points.x.data(), points.y.data(), n, scalar.data());
+    geometry_kernels::detail::bounding_box_mask_avx2(min.x, min.y, max.x, max.y, points.x.data(), points.y.data(), n, avx2.data());
+    geometry_kernels::bounding_box_mask(min, max, points.x.data(), points.y.data(), n, dispatched.data());
+
+    for (auto k = 0u; k < n; ++k)
+    {
+        unsigned char expected = points.x[k] > min.x && points.y[k] > min.y && points.x[k] < max.x && points.y[k] < max.y;
+        BOOST_CHECK_EQUAL(scalar[k], expected);
+        BOOST_CHECK_EQUAL(avx2[k], expected);
+        BOOST_CHECK_EQUAL(dispatched[k], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(segments_intersect_mask_test)
+{
+    std::mt19937 generator(7);
+    const unsigned n = 2001;
+    auto begin = random_coordinates(generator, n);
+    auto end = random_coordinates(generator, n);
+    const coordinate first {-1.5, -1.0};
+    const coordinate second {1.0, 1.5};
+
+    std::vector<unsigned char> scalar(n), avx2(n), dispatched(n);
+    geometry_kernels::detail::segments_intersect_mask_scalar(first.x, first.y, second.x, second.y,
+                                                             begin.x.data(), begin.y.data(), end.x.data(), end.y.data(),
+                                                             n, scalar.data());
+    geometry_kernels::detail::segments_intersect_mask_avx2(first.x, first.y, second.x, second.y,
+                                                           begin.x.data(), begin.y.data(), end.x.data(), end.y.data(),
+                                                           n, avx2.data());
+    geometry_kernels::segments_intersect_mask(first, second, begin.x.data(), begin.y.data(), end.x.data(), end.y.data(),
+                                              n, dispatched.data());
+
+    for (auto k = 0u; k < n; ++k)
+    {
+        unsigned char expected = geometry::segments_intersect(coordinate {begin.x[k], begin.y[k]}, coordinate {end.x[k], end.y[k]},
+                                                              first, second);
+        BOOST_CHECK_EQUAL(scalar[k], expected);
+        BOOST_CHECK_EQUAL(avx2[k], expected);
+        BOOST_CHECK_EQUAL(dispatched[k], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(local_orientation_signs_test)
+{
+    std::mt19937 generator(43);
+    const unsigned n = 1003;
+    auto second = random_coordinates<local_coordinate>(generator, n);
+    auto third = random_coordinates<local_coordinate>(generator, n);
+    const local_coordinate origin {0.5f, -1.0f};
+
+    std::vector<signed char> scalar(n), avx2(n), dispatched(n);
+    geometry_kernels::detail::orientation_signs_scalar(origin.x, origin.y, second.x.data(), second.y.data(),
+                                                       third.x.data(), third.y.data(), n, scalar.data());
+    geometry_kernels::detail::orientation_signs_avx2(origin.x, origin.y, second.x.data(), second.y.data(),
+                                                     third.x.data(), third.y.data(), n, avx2.data());
+    geometry_kernels::orientation_signs(origin, second.x.data(), second.y.data(),
+                                        third.x.data(), third.y.data(), n, dispatched.data());
+
+    for (auto k = 0u; k < n; ++k)
+    {
+        auto o = geometry::orientation(origin, local_coordinate {second.x[k], second.y[k]}, local_coordinate {third.x[k], third.y[k]});
+        signed char expected = o > 0 ? 1 : (o < 0 ? -1 : 0);
+        BOOST_CHECK_EQUAL(scalar[k], expected);
+        BOOST_CHECK_EQUAL(avx2[k], expected);
+        BOOST_CHECK_EQUAL(dispatched[k], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(local_bounding_box_mask_test)
+{
+    std::mt19937 generator(24);
+    const unsigned n = 517;
+    auto points = random_coordinates<local_coordinate>(generator, n);
+    const local_coordinate min {-1.0f, -0.5f};
+    const local_coordinate max {1.5f, 1.0f};
+
+    std::vector<unsigned char> scalar(n), avx2(n), dispatched(n);
+    geometry_kernels::detail::bounding_box_mask_scalar(min.x, min.y, max.x, max.y, points.x.data(), points.y.data(), n, scalar.data());
+    geometry_kernels::detail::bounding_box_mask_avx2(min.x, min.y, max.x, max.y, points.x.data(), points.y.data(), n, avx2.data());
+    geometry_kernels::bounding_box_mask(min, max, points.x.data(), points.y.data(), n, dispatched.data());
+
+    for (auto k = 0u; k < n; ++k)
+    {
+        unsigned char expected = points.x[k] > min.x && points.y[k] > min.y && points.x[k] < max.x && points.y[k] < max.y;
+        BOOST_CHECK_EQUAL(scalar[k], expected);
+        BOOST_CHECK_EQUAL(avx2[k], expected);
+        BOOST_CHECK_EQUAL(dispatched[k], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(local_segments_intersect_mask_test)
+{
+    std::mt19937 generator(8);
+    const unsigned n = 2001;
+    auto begin = random_coordinates<local_coordinate>(generator, n);
+    auto end = random_coordinates<local_coordinate>(generator, n);
+    const local_coordinate first {-1.5f, -1.0f};
+    const local_coordinate second {1.0f, 1.5f};
+
+    std::vector<unsigned char> scalar(n), avx2(n), dispatched(n);
+    geometry_kernels::detail::segments_intersect_mask_scalar(first.x, first.y, second.x, second.y,
+                                                             begin.x.data(), begin.y.data(), end.x.data(), end.y.data(),
+                                                             n, scalar.data());
+    geometry_kernels::detail::segments_intersect_mask_avx2(first.x, first.y, second.x, second.y,
+                                                           begin.x.data(), begin.y.data(), end.x.data(), end.y.data(),
+                                                           n, avx2.data());
+    geometry_kernels::segments_intersect_mask(first, second, begin.x.data(), begin.y.data(), end.x.data(), end.y.data(),
+                                              n, dispatched.data());
+
+    for (auto k = 0u; k < n; ++k)
+    {
+        unsigned char expected = geometry::segments_intersect(local_coordinate {begin.x[k], begin.y[k]}, local_coordinate {end.x[k], end.y[k]},
+                                                              first, second);
+        BOOST_CHECK_EQUAL(scalar[k], expected);
+        BOOST_CHECK_EQUAL(avx2[k], expected);
+        BOOST_CHECK_EQUAL(dispatched[k], expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(generic_kernels_test)
+{
+    std::vector<quantized_coordinate> line {{0, 0}, {4, 2}, {2, 4}, {-2, 2}, {6, 6}};
+    geometry_kernels::coordinate_array<quantized_coordinate> coordinates(line.begin(), line.end());
+    BOOST_CHECK_EQUAL(coordinates.size(), line.size());
+
+    std::vector<signed char> signs(line.size() - 2);
+    geometry_kernels::orientation_signs(line[0], coordinates.x.data() + 1, coordinates.y.data() + 1,
+                                        coordinates.x.data() + 2, coordinates.y.data() + 2, signs.size(), signs.data());
+    BOOST_CHECK_EQUAL(signs[0], 1);
+    BOOST_CHECK_EQUAL(signs[1], 1);
+    BOOST_CHECK_EQUAL(signs[2], -1);
+
+    std::vector<unsigned char> inside(line.size());
+    geometry_kernels::bounding_box_mask(quantized_coordinate {-1, -1}, quantized_coordinate {4, 4},
+                                        coordinates.x.data(), coordinates.y.data(), line.size(), inside.data());
+    BOOST_CHECK_EQUAL(inside[0], 1);
+    BOOST_CHECK_EQUAL(inside[1], 0);
+    BOOST_CHECK_EQUAL(inside[2], 0);
+    BOOST_CHECK_EQUAL(inside[3], 0);
+    BOOST_CHECK_EQUAL(inside[4], 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
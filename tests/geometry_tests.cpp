@@ -121,6 +121,24 @@ BOOST_AUTO_TEST_CASE(position_to_line_test)
     BOOST_CHECK_EQUAL(geometry::position_to_line(coordinate {0, 0}, coordinate {-1, -1}, coordinate {-2, -2}), geometry::point_position::ON_LINE);
 }
 
+BOOST_AUTO_TEST_CASE(exact_position_to_line_test)
+{
+    // the cross product is -1, which is lost when evaluated in double precision
+    const auto max_offset = quantized_coordinate::value_type {(1ll << 62) - 1};
+    quantized_coordinate origin {0, 0};
+    quantized_coordinate line_point {max_offset, max_offset - 1};
+    quantized_coordinate query {max_offset - 1, max_offset - 2};
+    BOOST_CHECK(geometry::position_to_line(origin, line_point, query) == geometry::point_position::RIGHT_OF_LINE);
+    BOOST_CHECK(geometry::position_to_line(origin, query, line_point) == geometry::point_position::LEFT_OF_LINE);
+
+    const auto compact_max_offset = compact_quantized_coordinate::value_type {(1 << 30) - 1};
+    compact_quantized_coordinate compact_origin {0, 0};
+    compact_quantized_coordinate compact_line_point {compact_max_offset, compact_max_offset - 1};
+    compact_quantized_coordinate compact_query {compact_max_offset - 1, compact_max_offset - 2};
+    BOOST_CHECK(geometry::position_to_line(compact_origin, compact_line_point, compact_query) == geometry::point_position::RIGHT_OF_LINE);
+    BOOST_CHECK(geometry::position_to_line(compact_origin, compact_query, compact_line_point) == geometry::point_position::LEFT_OF_LINE);
+}
+
 BOOST_AUTO_TEST_CASE(normalized_angle)
 {
     const float epsilon = 0.001f;
@@ -0,0 +1,143 @@
+#include "../local_frame_simplification.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+
+BOOST_AUTO_TEST_SUITE(local_frame_simplification_tests)
+
+namespace
+{
+/// Returns all shortcuts, like an engine whose rounding accepted too many
+struct all_shortcuts_engine
+{
+    using coordinate_type = local_coordinate;
+
+    all_shortcuts_engine(const basic_poly_line<local_coordinate>& line, std::vector<basic_point<local_coordinate>>&&)
+    : size(line.coordinates.size())
+    {
+    }
+
+    std::vector<shortcut> operator()() const
+    {
+        std::vector<shortcut> shortcuts;
+        for (auto i = 0u; i < size; ++i)
+        {
+            for (auto j = i + 1; j < size; ++j)
+            {
+                shortcuts.emplace_back(i, j);
+            }
+        }
+        return shortcuts;
+    }
+
+    unsigned size;
+};
+}
+
+BOOST_AUTO_TEST_CASE(same_shortcuts_test)
+{
+    // far away from the origin, without the local frame float would round
+    // all of these coordinates to the same values
+    const coordinate offset {-7984749.0, 5368675.0};
+    poly_line line { 0,
+        {
+            offset + coordinate {0, 0},
+            offset + coordinate {0.25, -0.25},
+            offset + coordinate {0, -0.5},
+            offset + coordinate {0.5, -0.25},
+            offset + coordinate {0, 0}
+        }
+    };
+
+    auto points = std::vector<point> {};
+    deberg<bb_point_filter> simplification(line, std::move(points));
+    auto shortcuts = simplification();
+
+    using local_filter = basic_bb_point_filter<local_coordinate>;
+    local_frame_simplification<deberg<local_filter>> local_simplification(line, {});
+    auto local_shortcuts = local_simplification();
+
+    BOOST_CHECK_EQUAL(shortcuts.size(), local_shortcuts.size());
+    for (auto i = 0u; i < std::min(shortcuts.size(), local_shortcuts.size()); ++i)
+    {
+        BOOST_CHECK_EQUAL(shortcuts[i].first, local_shortcuts[i].first);
+        BOOST_CHECK_EQUAL(shortcuts[i].last, local_shortcuts[i].last);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(map_simplification_test)
+{
+    std::vector<coordinate> cs = {
+        coordinate {0, 0},      // 0
+        coordinate {0, 1},      // 1
+        coordinate {1, 1},      // 2
+        coordinate {1, 2},      // 3
+        coordinate {1.5, 2},    // 4
+        coordinate {2, 3},      // 5
+        coordinate {2.5, 3},    // 6
+        coordinate {3, 2},      // 7
+        coordinate {4, 2},      // 8
+        coordinate {4, 0},      // 9
+        coordinate {2, 0},      // 10
+        coordinate {3.5, 1.75}, // 11
+    };
+
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2.25, 2.75}}, // a
+        {point::NO_LINE_ID, 1, coordinate {2.1, 0.05}},  // b
+        {point::NO_LINE_ID, 2, coordinate {0.9, 1.1}},   // c
+        {point::NO_LINE_ID, 3, coordinate {1.1, 1.1}},   // d
+    };
+
+    std::vector<poly_line> lines = {
+        {0, {cs[10], cs[0], cs[1], cs[2], cs[3]}},
+        {1, {cs[3], cs[10]}},
+        {2, {cs[3], cs[4], cs[5], cs[6], cs[7], cs[8], cs[9]}},
+        {3, {cs[10], cs[11], cs[9]}},
+        {4, {cs[10], cs[9]}},
+    };
+
+    auto lines_copy = lines;
+    auto points_copy = points;
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines_copy), std::move(points_copy));
+    auto simplified_lines = simplification(11);
+
+    using local_filter = basic_bb_point_filter<local_coordinate>;
+    map_simplification<local_frame_simplification<deberg<local_filter>>, bb_point_filter> local_simplification(std::move(lines), std::move(points));
+    auto local_simplified_lines = local_simplification(11);
+
+    BOOST_CHECK_EQUAL(simplified_lines.size(), local_simplified_lines.size());
+    for (auto i = 0u; i < simplified_lines.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(simplified_lines[i].coordinates.size(), local_simplified_lines[i].coordinates.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(validation_test)
+{
+    /*
+          1
+         / \
+        / a \
+       0-----2-----3
+    */
+    poly_line line {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 0}}};
+    std::vector<point> points = {{point::NO_LINE_ID, 0, coordinate {1, 0.5}}};
+
+    local_frame_simplification<all_shortcuts_engine> local_simplification(line, std::move(points));
+    auto shortcuts = local_simplification();
+
+    // the shortcuts around a are dropped in double precision, the edges are kept
+    std::vector<std::pair<unsigned, unsigned>> edges;
+    for (const auto& s : shortcuts)
+    {
+        edges.emplace_back(s.first, s.last);
+    }
+    std::vector<std::pair<unsigned, unsigned>> expected = {{0, 1}, {1, 2}, {1, 3}, {2, 3}};
+    BOOST_CHECK(edges == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
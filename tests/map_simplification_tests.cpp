@@ -6,6 +6,7 @@
 #include <boost/test/test_case_template.hpp>
 
 #include <algorithm>
+#include <cmath>
 
 BOOST_AUTO_TEST_SUITE(map_simplification_tests)
 
@@ -69,4 +70,417 @@ BOOST_AUTO_TEST_CASE(example_test)
     auto simplified_lines = simplification(11);
 }
 
+BOOST_AUTO_TEST_CASE(pinned_vertices_test)
+{
+    //    1     3
+    //   / \   / \_
+    //  0   \ /   4
+    //       2
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, -1}, coordinate {3, 1}, coordinate {4, 0}}},
+    };
+
+    {
+        auto lines_copy = lines;
+        map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines_copy), std::vector<point>());
+        auto simplified_lines = simplification(10);
+        BOOST_CHECK_EQUAL(simplified_lines[0].coordinates.size(), 2);
+    }
+
+    {
+        auto lines_copy = lines;
+        map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines_copy), std::vector<point>());
+        simplification.pin_vertices({coordinate {2, -1}});
+        auto simplified_lines = simplification(10);
+        std::vector<unsigned> expected_indices {0, 2, 4};
+        const auto& indices = simplification.original_indices()[0];
+        BOOST_CHECK_EQUAL_COLLECTIONS(indices.begin(), indices.end(), expected_indices.begin(), expected_indices.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(pin_shared_vertices_test)
+{
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        {1, {coordinate {2, 0}, coordinate {2, -1}}},
+        {2, {coordinate {0, -2}, coordinate {1, -3}, coordinate {2, -2}, coordinate {3, -3}, coordinate {4, -2}}},
+    };
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {1, 0.5}},
+        {point::NO_LINE_ID, 1, coordinate {2, -2.5}},
+    };
+
+    auto run = [&](unsigned num_threads)
+    {
+        auto lines_copy = lines;
+        auto points_copy = points;
+        map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines_copy), std::move(points_copy));
+        simplification.set_num_threads(num_threads);
+        simplification.pin_shared_vertices();
+        simplification(100);
+        return simplification.original_indices();
+    };
+
+    auto sequential = run(1);
+    auto parallel = run(4);
+    BOOST_REQUIRE_EQUAL(sequential.size(), 3);
+    BOOST_CHECK(sequential == parallel);
+
+    // the junction with line 1 is kept
+    BOOST_CHECK(std::find(sequential[0].begin(), sequential[0].end(), 2) != sequential[0].end());
+    BOOST_CHECK_EQUAL(sequential[1].size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(work_budget_test)
+{
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}}},
+        {1, {}},
+    };
+    for (auto i = 0u; i < 40; ++i)
+    {
+        lines[1].coordinates.push_back(coordinate {static_cast<double>(i), 5.0 + (i % 2)});
+    }
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {20.5, 5.9}},
+    };
+
+    auto run = [&](const simplification_options& options, std::vector<unsigned>& fallback_lines)
+    {
+        auto lines_copy = lines;
+        auto points_copy = points;
+        map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines_copy), std::move(points_copy));
+        simplification.set_options(options);
+        simplification(100);
+        fallback_lines = simplification.fallback_lines();
+        return simplification.original_indices();
+    };
+
+    std::vector<unsigned> fallback_lines;
+    auto exact = run(simplification_options(), fallback_lines);
+    BOOST_CHECK(fallback_lines.empty());
+
+    simplification_options budget_options;
+    budget_options.work_budget = 100;
+    budget_options.fallback_window = 4;
+    auto budget = run(budget_options, fallback_lines);
+    BOOST_REQUIRE_EQUAL(fallback_lines.size(), 1);
+    BOOST_CHECK_EQUAL(fallback_lines[0], 1);
+
+    // the short line stays exact, the long one uses the fallback window
+    BOOST_CHECK(budget[0] == exact[0]);
+    std::vector<unsigned> ignored;
+    auto windowed = run(simplification_options(simplification_window(4, 0)), ignored);
+    BOOST_CHECK(budget[1] == windowed[1]);
+    BOOST_CHECK_GT(budget[1].size(), exact[1].size());
+}
+
+BOOST_AUTO_TEST_CASE(incremental_test)
+{
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        {1, {coordinate {10, 0}, coordinate {11, 1}, coordinate {12, 0}, coordinate {13, 1}, coordinate {14, 0}}},
+        {2, {coordinate {20, 0}, coordinate {21, 1}, coordinate {22, 0}, coordinate {23, 1}, coordinate {24, 0}}},
+    };
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2, 0.5}},
+        {point::NO_LINE_ID, 1, coordinate {12, 5}},
+    };
+
+    using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+    simplification_type::state_type state;
+    unsigned reused = 0;
+    auto run = [&](bool incremental)
+    {
+        auto lines_copy = lines;
+        auto points_copy = points;
+        simplification_type simplification(std::move(lines_copy), std::move(points_copy));
+        if (incremental)
+        {
+            simplification.set_previous_state(std::move(state));
+        }
+        simplification.record_state();
+        simplification(100);
+        reused = simplification.reused_lines();
+        state = simplification.state();
+        return simplification.original_indices();
+    };
+
+    auto moved = points;
+    moved[1].location = coordinate {12, 0.5};
+    std::swap(points, moved);
+    auto full = run(false);
+    BOOST_CHECK_EQUAL(reused, 0);
+
+    // the moved point is now inside of the bounding box of the second line
+    std::swap(points, moved);
+    run(false);
+    std::swap(points, moved);
+    auto incremental = run(true);
+    BOOST_CHECK_EQUAL(reused, 2);
+    BOOST_CHECK(incremental == full);
+
+    // a changed line is simplified again, all others are reused
+    lines[2].coordinates[2] = coordinate {22, -1};
+    incremental = run(true);
+    BOOST_CHECK_EQUAL(reused, 2);
+    full = run(false);
+    BOOST_CHECK(incremental == full);
+}
+
+BOOST_AUTO_TEST_CASE(incremental_options_test)
+{
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0},
+             coordinate {5, 1}, coordinate {6, 0}}},
+        {1, {coordinate {10, 0}, coordinate {11, 1}, coordinate {12, 0}, coordinate {13, 1}, coordinate {14, 0}}},
+    };
+    std::vector<point> points = {{point::NO_LINE_ID, 0, coordinate {2, 0.5}}};
+
+    using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+    simplification_type::state_type state;
+    unsigned reused = 0;
+    auto run = [&](const simplification_options& options, bool incremental, const quantization_parameters& quantization)
+    {
+        auto lines_copy = lines;
+        auto points_copy = points;
+        simplification_type simplification(std::move(lines_copy), std::move(points_copy));
+        simplification.set_options(options);
+        simplification.set_quantization(quantization);
+        if (incremental)
+        {
+            simplification.set_previous_state(std::move(state));
+        }
+        simplification.record_state();
+        simplification(0);
+        reused = simplification.reused_lines();
+        state = simplification.state();
+        return simplification.original_indices();
+    };
+
+    simplification_options unbounded;
+    simplification_options windowed(simplification_window(2, 0));
+    auto full = run(unbounded, false, quantization_parameters());
+    auto windowed_full = run(windowed, false, quantization_parameters());
+    BOOST_CHECK(windowed_full != full);
+
+    // the shortcuts of the window are not reused without it
+    auto incremental = run(unbounded, true, quantization_parameters());
+    BOOST_CHECK_EQUAL(reused, 0);
+    BOOST_CHECK(incremental == full);
+
+    // the number of threads does not change the shortcuts
+    auto threads = unbounded;
+    threads.num_threads = 4;
+    incremental = run(threads, true, quantization_parameters());
+    BOOST_CHECK_EQUAL(reused, 2);
+    BOOST_CHECK(incremental == full);
+
+    auto deviation = unbounded;
+    deviation.max_deviation = 0.5;
+    run(deviation, true, quantization_parameters());
+    BOOST_CHECK_EQUAL(reused, 0);
+
+    run(unbounded, false, quantization_parameters {coordinate {0, 0}, 1});
+    run(unbounded, true, quantization_parameters {coordinate {0, 0}, 2});
+    BOOST_CHECK_EQUAL(reused, 0);
+    run(unbounded, true, quantization_parameters {coordinate {0, 0}, 2});
+    BOOST_CHECK_EQUAL(reused, 2);
+}
+
+BOOST_AUTO_TEST_CASE(duplicate_test)
+{
+    poly_line border {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}};
+    poly_line reversed {1, std::vector<coordinate>(border.coordinates.rbegin(), border.coordinates.rend())};
+    poly_line copy {2, border.coordinates};
+    std::vector<poly_line> lines = {border, reversed, copy};
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2, 0.5}},
+    };
+
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines), std::move(points));
+    auto simplified = simplification(100);
+    BOOST_CHECK_EQUAL(simplification.duplicate_lines(), 2);
+
+    BOOST_REQUIRE_EQUAL(simplified.size(), 3);
+    BOOST_CHECK_EQUAL(simplified[1].id, 1);
+    BOOST_CHECK_EQUAL(simplified[2].id, 2);
+    BOOST_CHECK(simplified[2].coordinates == simplified[0].coordinates);
+    BOOST_CHECK(std::equal(simplified[1].coordinates.begin(), simplified[1].coordinates.end(),
+                           simplified[0].coordinates.rbegin()));
+    BOOST_CHECK_EQUAL(simplification.used_edges(), 3 * (simplified[0].coordinates.size() - 1));
+
+    const auto& indices = simplification.original_indices();
+    for (auto k = 0u; k < indices[1].size(); ++k)
+    {
+        BOOST_CHECK(reversed.coordinates[indices[1][k]] == simplified[1].coordinates[k]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(stream_test)
+{
+    auto make_lines = []
+    {
+        poly_line border {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}};
+        poly_line reversed {1, std::vector<coordinate>(border.coordinates.rbegin(), border.coordinates.rend())};
+        poly_line other {2, {coordinate {0, 5}, coordinate {1, 6}, coordinate {2, 5}}};
+        return std::vector<poly_line> {border, other, reversed};
+    };
+    auto make_points = []
+    {
+        return std::vector<point> {{point::NO_LINE_ID, 0, coordinate {2, 0.5}}};
+    };
+    using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+
+    simplification_type simplification(make_lines(), make_points());
+    auto expected = simplification(100);
+    auto id_less = [](const poly_line& lhs, const poly_line& rhs) { return lhs.id < rhs.id; };
+
+    for (auto keep_order : {true, false})
+    {
+        simplification_type streamed(make_lines(), make_points());
+        streamed.set_num_threads(4);
+        std::vector<poly_line> simplified;
+        streamed.stream(100,
+                        [&simplified](const poly_line& line, const std::vector<unsigned>&) { simplified.push_back(line); },
+                        keep_order);
+        BOOST_CHECK_EQUAL(streamed.used_edges(), simplification.used_edges());
+
+        BOOST_REQUIRE_EQUAL(simplified.size(), expected.size());
+        auto expected_order = expected;
+        if (!keep_order)
+        {
+            std::sort(simplified.begin(), simplified.end(), id_less);
+            std::sort(expected_order.begin(), expected_order.end(), id_less);
+        }
+        for (auto i = 0u; i < expected.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(simplified[i].id, expected_order[i].id);
+            BOOST_CHECK(simplified[i].coordinates == expected_order[i].coordinates);
+        }
+        BOOST_CHECK(streamed.original_indices() == simplification.original_indices());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(detail_levels_test)
+{
+    // a flat line with a small and a large bump
+    auto make_lines = []
+    {
+        return std::vector<poly_line> {
+            {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}}},
+            {1, {coordinate {0, 10}, coordinate {1, 13}, coordinate {2, 10}}},
+        };
+    };
+    using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+
+    std::vector<detail_level> levels(4);
+    levels[0].max_deviation = 0;
+    levels[1].max_deviation = 2;
+    levels[2].max_edges = 3;
+
+    simplification_type simplification(make_lines(), std::vector<point>());
+    auto simplified = simplification(levels);
+    BOOST_REQUIRE_EQUAL(simplified.size(), 4);
+
+    auto num_edges = [](const std::vector<poly_line>& level_lines)
+    {
+        std::size_t edges = 0;
+        for (const auto& line : level_lines)
+        {
+            edges += line.coordinates.size() - 1;
+        }
+        return edges;
+    };
+    BOOST_CHECK_EQUAL(num_edges(simplified[0]), 4);
+    BOOST_CHECK_EQUAL(num_edges(simplified[1]), 3);
+    BOOST_CHECK_EQUAL(num_edges(simplified[3]), 2);
+    BOOST_CHECK_EQUAL(simplification.used_edges(), 2);
+
+    // a level with an edge budget matches a separate run that allocates the same budget
+    simplification_type separate(make_lines(), std::vector<point>());
+    separate.allocate_max_edges();
+    auto expected = separate(3);
+    BOOST_REQUIRE_EQUAL(expected.size(), simplified[2].size());
+    for (auto i = 0u; i < expected.size(); ++i)
+    {
+        BOOST_CHECK(expected[i].coordinates == simplified[2][i].coordinates);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(allocation_collinear_test)
+{
+    //
+    //     1--2--3
+    //    /       \
+    //   0         4
+    //
+    // With two edges 0 -> 2 -> 4 has the smallest error 1/sqrt(5),
+    // without the collinear vertex 2 it would be 2/sqrt(10).
+    auto make_lines = []
+    {
+        return std::vector<poly_line> {
+            {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 1}, coordinate {3, 1}, coordinate {4, 0}}},
+        };
+    };
+    using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+    const std::vector<unsigned> expected_indices {0, 2, 4};
+
+    simplification_type allocated(make_lines(), std::vector<point>());
+    allocated.allocate_max_edges();
+    allocated(2);
+    BOOST_CHECK_EQUAL(allocated.removed_vertices(), 0);
+    BOOST_CHECK_CLOSE(allocated.max_deviation(), 1 / std::sqrt(5.0), 1e-6);
+    BOOST_CHECK(allocated.original_indices()[0] == expected_indices);
+
+    std::vector<detail_level> levels(2);
+    levels[0].max_deviation = 0.5;
+    levels[1].max_edges = 2;
+    simplification_type leveled(make_lines(), std::vector<point>());
+    auto simplified = leveled(levels);
+    BOOST_REQUIRE_EQUAL(simplified.size(), 2);
+    BOOST_CHECK_EQUAL(simplified[0][0].coordinates.size(), 3);
+    BOOST_CHECK_EQUAL(simplified[1][0].coordinates.size(), 3);
+    BOOST_CHECK_CLOSE(leveled.max_deviation(), 1 / std::sqrt(5.0), 1e-6);
+
+    // a state recorded with the collinear vertex removed is not reused
+    simplification_type recorded(make_lines(), std::vector<point>());
+    recorded.record_state();
+    recorded(0);
+    simplification_type incremental(make_lines(), std::vector<point>());
+    incremental.set_previous_state(simplification_type::state_type(recorded.state()));
+    incremental.allocate_max_edges();
+    incremental(2);
+    BOOST_CHECK_EQUAL(incremental.reused_lines(), 0);
+    BOOST_CHECK(incremental.original_indices()[0] == expected_indices);
+}
+
+BOOST_AUTO_TEST_CASE(goal_directed_test)
+{
+    auto make_lines = []
+    {
+        return std::vector<poly_line> {
+            {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        };
+    };
+    using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+    simplification_options options;
+    options.goal_directed = true;
+
+    simplification_type simplification(make_lines(), std::vector<point>());
+    simplification.set_options(options);
+    simplification(0);
+    BOOST_CHECK_EQUAL(simplification.used_edges(), 1);
+
+    // the goal directed graph only holds one shortest path
+    simplification_type allocated(make_lines(), std::vector<point>());
+    allocated.set_options(options);
+    allocated.allocate_max_edges();
+    BOOST_CHECK_THROW(allocated(2), std::runtime_error);
+
+    simplification_type leveled(make_lines(), std::vector<point>());
+    leveled.set_options(options);
+    BOOST_CHECK_THROW(leveled(std::vector<detail_level>(1)), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
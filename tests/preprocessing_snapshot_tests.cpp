@@ -0,0 +1,155 @@
+#include "../preprocessing_snapshot.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+BOOST_AUTO_TEST_SUITE(preprocessing_snapshot_tests)
+
+namespace
+{
+const char* SNAPSHOT_FILE_PATH = "preprocessing_snapshot_tests.bin";
+
+using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+
+std::vector<poly_line> test_lines()
+{
+    // the second line is a reversed duplicate of the first, the third has a collinear vertex
+    return {
+        {3, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        {4, {coordinate {4, 0}, coordinate {3, 1}, coordinate {2, 0}, coordinate {1, 1}, coordinate {0, 0}}},
+        {5, {coordinate {10, 0}, coordinate {11, 1}, coordinate {12, 2}, coordinate {13, 0}, coordinate {14, 1},
+             coordinate {15, 0}}},
+    };
+}
+
+std::vector<point> test_points()
+{
+    return {
+        {point::NO_LINE_ID, 0, coordinate {2, 0.5}},
+        {point::NO_LINE_ID, 1, coordinate {12.5, 5}},
+        {point::NO_LINE_ID, 2, coordinate {50, 50}},
+    };
+}
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_test)
+{
+    std::vector<coordinate> pinned = {coordinate {13, 0}};
+    simplification_type simplification(test_lines(), test_points());
+    simplification.pin_vertices(pinned);
+    auto content = simplification.prepare();
+    {
+        std::ofstream output(SNAPSHOT_FILE_PATH, std::ios::binary);
+        preprocessing_snapshot::write(output, content);
+    }
+
+    preprocessing_snapshot snapshot(SNAPSHOT_FILE_PATH);
+    BOOST_REQUIRE_EQUAL(snapshot.size(), 3);
+    BOOST_CHECK_EQUAL(snapshot.num_points(), 3);
+    BOOST_CHECK(snapshot.pinned_coordinates() == pinned);
+
+    auto lines = snapshot.lines();
+    auto expected_lines = test_lines();
+    for (auto i = 0u; i < lines.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(lines[i].id, expected_lines[i].id);
+        BOOST_CHECK(lines[i].coordinates == expected_lines[i].coordinates);
+    }
+    auto points = snapshot.points();
+    BOOST_REQUIRE_EQUAL(points.size(), 3);
+    BOOST_CHECK_EQUAL(points[1].id, 1);
+    BOOST_CHECK_EQUAL(points[1].line_id, point::NO_LINE_ID);
+    BOOST_CHECK(points[1].location == (coordinate {12.5, 5}));
+
+    for (auto i = 0u; i < content.line_states.size(); ++i)
+    {
+        const auto& state = content.line_states[i];
+        BOOST_CHECK((std::vector<unsigned>(snapshot.candidates(i).begin(), snapshot.candidates(i).end()) == state.candidates));
+        BOOST_CHECK((std::vector<unsigned>(snapshot.reduced_indices(i).begin(), snapshot.reduced_indices(i).end())
+                     == state.reduced_indices));
+        BOOST_CHECK((std::vector<unsigned>(snapshot.piece_ends(i).begin(), snapshot.piece_ends(i).end()) == state.piece_ends));
+    }
+
+    // the duplicate is not preprocessed, the collinear vertex is removed and the pinned vertex splits the line
+    BOOST_CHECK_EQUAL(snapshot.reduced_indices(1).size(), 0);
+    BOOST_CHECK((std::vector<unsigned>(snapshot.reduced_indices(2).begin(), snapshot.reduced_indices(2).end())
+                 == std::vector<unsigned> {0, 2, 3, 4, 5}));
+    BOOST_CHECK((std::vector<unsigned>(snapshot.piece_ends(2).begin(), snapshot.piece_ends(2).end())
+                 == std::vector<unsigned> {2, 4}));
+
+    std::remove(SNAPSHOT_FILE_PATH);
+}
+
+BOOST_AUTO_TEST_CASE(simplification_test)
+{
+    std::vector<coordinate> pinned = {coordinate {13, 0}};
+    {
+        simplification_type preparation(test_lines(), test_points());
+        preparation.pin_vertices(pinned);
+        std::ofstream output(SNAPSHOT_FILE_PATH, std::ios::binary);
+        preprocessing_snapshot::write(output, preparation.prepare());
+    }
+    preprocessing_snapshot snapshot(SNAPSHOT_FILE_PATH);
+
+    for (auto max_edges : {0u, 6u, 100u})
+    {
+        simplification_type expected_simplification(test_lines(), test_points());
+        expected_simplification.pin_vertices(pinned);
+        auto expected = expected_simplification(max_edges);
+
+        simplification_type simplification(snapshot.lines(), snapshot.points());
+        simplification.pin_vertices(snapshot.pinned_coordinates());
+        simplification.use_snapshot(snapshot);
+        auto simplified = simplification(max_edges);
+
+        BOOST_REQUIRE_EQUAL(simplified.size(), expected.size());
+        BOOST_CHECK_EQUAL(simplification.used_edges(), expected_simplification.used_edges());
+        for (auto i = 0u; i < simplified.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(simplified[i].id, expected[i].id);
+            BOOST_CHECK(simplified[i].coordinates == expected[i].coordinates);
+            BOOST_CHECK(simplification.original_indices()[i] == expected_simplification.original_indices()[i]);
+        }
+    }
+
+    // the snapshot removes the collinear vertex of the third line, which a deviation bound keeps
+    simplification_options options;
+    options.max_deviation = 0.5;
+    simplification_type expected_simplification(test_lines(), test_points());
+    expected_simplification.pin_vertices(pinned);
+    expected_simplification.set_options(options);
+    auto expected = expected_simplification(0);
+
+    simplification_type simplification(snapshot.lines(), snapshot.points());
+    simplification.pin_vertices(snapshot.pinned_coordinates());
+    simplification.set_options(options);
+    simplification.use_snapshot(snapshot);
+    auto simplified = simplification(0);
+    BOOST_CHECK_EQUAL(simplification.removed_vertices(), expected_simplification.removed_vertices());
+    BOOST_CHECK(simplification.original_indices() == expected_simplification.original_indices());
+
+    // the pinned vertices are part of the preprocessing
+    simplification_type unpinned(snapshot.lines(), snapshot.points());
+    BOOST_CHECK_THROW(unpinned.use_snapshot(snapshot), std::runtime_error);
+
+    std::remove(SNAPSHOT_FILE_PATH);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_file_test)
+{
+    {
+        std::ofstream output(SNAPSHOT_FILE_PATH, std::ios::binary);
+        output << "not a preprocessing snapshot, but long enough for a header";
+    }
+    BOOST_CHECK_THROW(preprocessing_snapshot snapshot(SNAPSHOT_FILE_PATH), std::runtime_error);
+    std::remove(SNAPSHOT_FILE_PATH);
+
+    BOOST_CHECK_THROW(preprocessing_snapshot snapshot(SNAPSHOT_FILE_PATH), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+#include "../quantizer.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+
+BOOST_AUTO_TEST_SUITE(quantizer_tests)
+
+BOOST_AUTO_TEST_CASE(roundtrip_test)
+{
+    quantizer grid(coordinate {-100, 50}, 0.25);
+
+    auto q = grid.quantize(coordinate {-99, 50.5});
+    BOOST_CHECK_EQUAL(q.x, 4);
+    BOOST_CHECK_EQUAL(q.y, 2);
+
+    // snaps to the closest grid point
+    q = grid.quantize(coordinate {-99.1, 50.4});
+    BOOST_CHECK_EQUAL(q.x, 4);
+    BOOST_CHECK_EQUAL(q.y, 2);
+
+    auto c = grid.dequantize(q);
+    BOOST_CHECK_EQUAL(c.x, -99);
+    BOOST_CHECK_EQUAL(c.y, 50.5);
+}
+
+BOOST_AUTO_TEST_CASE(fits_test)
+{
+    coordinate min {0, 0};
+    coordinate max {1e6, 1e6};
+
+    BOOST_CHECK(compact_quantizer::fits(min, max, 0.01));
+    BOOST_CHECK(!compact_quantizer::fits(min, max, 0.0001));
+    BOOST_CHECK(quantizer::fits(min, max, 0.0001));
+}
+
+BOOST_AUTO_TEST_CASE(bounds_test)
+{
+    std::vector<poly_line> lines {
+        {0, {coordinate {0, 1}, coordinate {2, -1}}},
+        {1, {coordinate {-3, 0}, coordinate {1, 1}}},
+    };
+    std::vector<point> points {
+        {point::NO_LINE_ID, 0, coordinate {0, 5}},
+    };
+
+    auto bounds = compute_bounds(lines, points);
+    BOOST_CHECK_EQUAL(bounds.first.x, -3);
+    BOOST_CHECK_EQUAL(bounds.first.y, -1);
+    BOOST_CHECK_EQUAL(bounds.second.x, 2);
+    BOOST_CHECK_EQUAL(bounds.second.y, 5);
+}
+
+BOOST_AUTO_TEST_CASE(quantized_simplification_test)
+{
+    // same example as in map_simplification_tests
+    std::vector<coordinate> cs = {
+        coordinate {0, 0},      // 0
+        coordinate {0, 1},      // 1
+        coordinate {1, 1},      // 2
+        coordinate {1, 2},      // 3
+        coordinate {1.5, 2},    // 4
+        coordinate {2, 3},      // 5
+        coordinate {2.5, 3},    // 6
+        coordinate {3, 2},      // 7
+        coordinate {4, 2},      // 8
+        coordinate {4, 0},      // 9
+        coordinate {2, 0},      // 10
+        coordinate {3.5, 1.75}, // 11
+    };
+
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2.25, 2.75}}, // a
+        {point::NO_LINE_ID, 1, coordinate {2.1, 0.05}},  // b
+        {point::NO_LINE_ID, 2, coordinate {0.9, 1.1}},   // c
+        {point::NO_LINE_ID, 3, coordinate {1.1, 1.1}},   // d
+    };
+
+    std::vector<poly_line> lines = {
+        {0, {cs[10], cs[0], cs[1], cs[2], cs[3]}},
+        {1, {cs[3], cs[10]}},
+        {2, {cs[3], cs[4], cs[5], cs[6], cs[7], cs[8], cs[9]}},
+        {3, {cs[10], cs[11], cs[9]}},
+        {4, {cs[10], cs[9]}},
+    };
+
+    auto bounds = compute_bounds(lines, points);
+    compact_quantizer grid(bounds.first, 0.05);
+    using quantized_filter = basic_bb_point_filter<compact_quantized_coordinate>;
+    map_simplification<deberg<quantized_filter>, quantized_filter> quantized_simplification(grid.quantize(lines), grid.quantize(points));
+    auto quantized_lines = quantized_simplification(11);
+
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines), std::move(points));
+    auto simplified_lines = simplification(11);
+
+    BOOST_CHECK_EQUAL(quantized_lines.size(), simplified_lines.size());
+    for (auto i = 0u; i < simplified_lines.size(); ++i)
+    {
+        auto dequantized_line = grid.dequantize(quantized_lines[i]);
+        BOOST_CHECK_EQUAL(dequantized_line.id, simplified_lines[i].id);
+        BOOST_CHECK_EQUAL(dequantized_line.coordinates.size(), simplified_lines[i].coordinates.size());
+        for (auto j = 0u; j < std::min(dequantized_line.coordinates.size(), simplified_lines[i].coordinates.size()); ++j)
+        {
+            BOOST_CHECK_LE(glm::distance(dequantized_line.coordinates[j], simplified_lines[i].coordinates[j]), 1e-9);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,8 @@
 #include "../line_reader.hpp"
 #include "../point_reader.hpp"
 #include "../gml_check.hpp"
+#include "../wkb_reader.hpp"
+#include "../wkb_writer.hpp"
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/test_case_template.hpp>
@@ -63,4 +65,81 @@ BOOST_AUTO_TEST_CASE(point_reader_test)
     BOOST_CHECK_LE(std::abs(result[0].location.y - 5375174.29896494), 0.001);
 }
 
+BOOST_AUTO_TEST_CASE(wkb_reader_test)
+{
+    std::vector<poly_line> lines {
+        {13, {coordinate {-7984749.593824852, 5368675.690126911}, coordinate {-7984392.035620423, 5367570.791302501}}},
+        {2, {}},
+    };
+    std::stringstream test_stream;
+    wkb_writer writer(test_stream);
+    writer.write(lines);
+
+    wkb_reader reader(test_stream);
+    auto result = reader.read_lines();
+    BOOST_REQUIRE_EQUAL(result.size(), 2);
+    BOOST_CHECK_EQUAL(result[0].id, 13);
+    BOOST_CHECK(result[0].coordinates == lines[0].coordinates);
+    BOOST_CHECK_EQUAL(result[1].id, 2);
+    BOOST_CHECK(result[1].coordinates.empty());
+}
+
+namespace
+{
+template<typename ValueT>
+void append_value(std::string& bytes, ValueT value, bool big_endian)
+{
+    std::string value_bytes(reinterpret_cast<const char*>(&value), sizeof(value));
+    if (big_endian)
+    {
+        std::reverse(value_bytes.begin(), value_bytes.end());
+    }
+    bytes += value_bytes;
+}
+}
+
+BOOST_AUTO_TEST_CASE(wkb_point_reader_test)
+{
+    // a big endian EWKB point with SRID 4326, as written by PostGIS
+    std::string geometry(1, '\0');
+    append_value<std::uint32_t>(geometry, 0x20000001, true);
+    append_value<std::uint32_t>(geometry, 4326, true);
+    append_value<double>(geometry, -7975939.10140652, true);
+    append_value<double>(geometry, 5375174.29896494, true);
+
+    std::string record;
+    append_value<std::uint32_t>(record, 3, false);
+    append_value<std::uint32_t>(record, geometry.size(), false);
+    record += geometry;
+
+    std::stringstream test_stream(record);
+    wkb_reader reader(test_stream);
+    auto result = reader.read_points();
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_CHECK_EQUAL(result[0].id, 3);
+    BOOST_CHECK_EQUAL(result[0].line_id, point::NO_LINE_ID);
+    BOOST_CHECK_EQUAL(result[0].location.x, -7975939.10140652);
+    BOOST_CHECK_EQUAL(result[0].location.y, 5375174.29896494);
+
+    // a point is no line
+    std::stringstream line_stream(record);
+    BOOST_CHECK_THROW(wkb_reader(line_stream).read_lines(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(wkb_reader_invalid)
+{
+    std::vector<poly_line> lines {{1, {coordinate {0, 0}, coordinate {1, 1}}}};
+    std::stringstream output;
+    wkb_writer writer(output);
+    writer.write(lines);
+
+    auto truncated = output.str();
+    truncated.resize(truncated.size() - 3);
+    std::stringstream truncated_stream(truncated);
+    BOOST_CHECK_THROW(wkb_reader(truncated_stream).read_lines(), std::runtime_error);
+
+    std::stringstream short_header("\x01\x00");
+    BOOST_CHECK_THROW(wkb_reader(short_header).read_lines(), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
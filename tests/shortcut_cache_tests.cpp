@@ -0,0 +1,112 @@
+#include "../shortcut_cache.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+
+BOOST_AUTO_TEST_SUITE(shortcut_cache_tests)
+
+namespace
+{
+const char* CACHE_FILE_PATH = "shortcut_cache_tests.bin";
+}
+
+BOOST_AUTO_TEST_CASE(hash_test)
+{
+    poly_line line {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}}};
+    poly_line moved {1, {coordinate {0, 0}, coordinate {1, 2}, coordinate {2, 0}}};
+    simplification_options options;
+    simplification_options windowed(simplification_window(2, 0));
+
+    // the id of the line does not matter, its coordinates and the options do
+    auto hash = shortcut_cache::hash_line<deberg<bb_point_filter>>(line, options);
+    line.id = 5;
+    BOOST_CHECK_EQUAL(hash, shortcut_cache::hash_line<deberg<bb_point_filter>>(line, options));
+    BOOST_CHECK_NE(hash, shortcut_cache::hash_line<deberg<bb_point_filter>>(moved, options));
+    BOOST_CHECK_NE(hash, shortcut_cache::hash_line<deberg<bb_point_filter>>(line, windowed));
+
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {1, 0.5}},
+        {2, 1, coordinate {1.5, 0.2}},
+    };
+    std::vector<point> reversed = {points[1], points[0]};
+    BOOST_CHECK_EQUAL(shortcut_cache::hash_points(points), shortcut_cache::hash_points(reversed));
+    points.pop_back();
+    BOOST_CHECK_NE(shortcut_cache::hash_points(points), shortcut_cache::hash_points(reversed));
+}
+
+BOOST_AUTO_TEST_CASE(eviction_test)
+{
+    std::remove(CACHE_FILE_PATH);
+    // room for two entries with a single shortcut
+    shortcut_cache cache(CACHE_FILE_PATH, 2 * (25 + 8));
+
+    std::vector<shortcut> shortcuts;
+    bool fell_back = false;
+    BOOST_CHECK(!cache.find({1, 1}, shortcuts, fell_back));
+    cache.insert({1, 1}, {shortcut {0, 1}}, false);
+    cache.insert({2, 2}, {shortcut {0, 2}}, true);
+    BOOST_CHECK(cache.find({1, 1}, shortcuts, fell_back));
+    BOOST_CHECK_EQUAL(cache.hits(), 1);
+    BOOST_CHECK_EQUAL(cache.misses(), 1);
+
+    // {2, 2} is the least recently used entry
+    cache.insert({3, 3}, {shortcut {0, 3}}, false);
+    BOOST_CHECK_EQUAL(cache.size(), 2);
+    BOOST_CHECK(!cache.find({2, 2}, shortcuts, fell_back));
+    BOOST_REQUIRE(cache.find({3, 3}, shortcuts, fell_back));
+    BOOST_REQUIRE_EQUAL(shortcuts.size(), 1);
+    BOOST_CHECK_EQUAL(shortcuts[0].last, 3);
+    BOOST_CHECK(!fell_back);
+
+    cache.save();
+    shortcut_cache loaded(CACHE_FILE_PATH, 1 << 20);
+    BOOST_CHECK_EQUAL(loaded.size(), 2);
+    BOOST_CHECK(loaded.find({1, 1}, shortcuts, fell_back));
+    BOOST_CHECK(loaded.find({3, 3}, shortcuts, fell_back));
+    std::remove(CACHE_FILE_PATH);
+}
+
+BOOST_AUTO_TEST_CASE(map_simplification_test)
+{
+    std::remove(CACHE_FILE_PATH);
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        {1, {coordinate {10, 0}, coordinate {11, 1}, coordinate {12, 0}, coordinate {13, 1}, coordinate {14, 0}}},
+    };
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2, 0.5}},
+    };
+
+    auto run = [&](shortcut_cache* cache)
+    {
+        auto lines_copy = lines;
+        auto points_copy = points;
+        map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines_copy), std::move(points_copy));
+        if (cache != nullptr)
+        {
+            simplification.use_cache(*cache);
+        }
+        simplification(100);
+        return simplification.original_indices();
+    };
+
+    auto uncached = run(nullptr);
+    {
+        shortcut_cache cache(CACHE_FILE_PATH, 1 << 20);
+        BOOST_CHECK(run(&cache) == uncached);
+        BOOST_CHECK_EQUAL(cache.misses(), 2);
+        cache.save();
+    }
+
+    shortcut_cache cache(CACHE_FILE_PATH, 1 << 20);
+    BOOST_CHECK(run(&cache) == uncached);
+    BOOST_CHECK_EQUAL(cache.hits(), 2);
+    BOOST_CHECK_EQUAL(cache.misses(), 0);
+    std::remove(CACHE_FILE_PATH);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
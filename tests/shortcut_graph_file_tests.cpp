@@ -0,0 +1,67 @@
+#include "../shortcut_graph_file.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+#include "../graph_util.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+BOOST_AUTO_TEST_SUITE(shortcut_graph_file_tests)
+
+namespace
+{
+const char* GRAPH_FILE_PATH = "shortcut_graph_file_tests.bin";
+}
+
+BOOST_AUTO_TEST_CASE(selection_test)
+{
+    std::vector<poly_line> lines = {
+        {3, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        {5, {coordinate {10, 0}, coordinate {11, 1}, coordinate {12, 0}, coordinate {13, 1}, coordinate {14, 0}}},
+    };
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2, 0.5}},
+    };
+
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines), std::move(points));
+    simplification.record_state();
+    auto simplified = simplification(100);
+    {
+        std::ofstream output(GRAPH_FILE_PATH, std::ios::binary);
+        shortcut_graph_file::write(output, simplification.state());
+    }
+
+    shortcut_graph_file graphs(GRAPH_FILE_PATH);
+    BOOST_REQUIRE_EQUAL(graphs.size(), simplified.size());
+    for (auto i = 0u; i < graphs.size(); ++i)
+    {
+        auto graph = graphs.line(i);
+        BOOST_CHECK_EQUAL(graph.id, simplified[i].id);
+        auto path = graph_util::shortest_dag_path_nodes(graph, 0, graph.number_of_nodes() - 1);
+        BOOST_REQUIRE_EQUAL(path.size(), simplified[i].coordinates.size());
+        for (auto k = 0u; k < path.size(); ++k)
+        {
+            BOOST_CHECK(graph.coordinate(path[k]) == simplified[i].coordinates[k]);
+            BOOST_CHECK_EQUAL(graph.original_index(path[k]), simplification.original_indices()[i][k]);
+        }
+    }
+
+    std::remove(GRAPH_FILE_PATH);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_file_test)
+{
+    {
+        std::ofstream output(GRAPH_FILE_PATH, std::ios::binary);
+        output << "not a shortcut graph file, but long enough for a header";
+    }
+    BOOST_CHECK_THROW(shortcut_graph_file graphs(GRAPH_FILE_PATH), std::runtime_error);
+    std::remove(GRAPH_FILE_PATH);
+
+    BOOST_CHECK_THROW(shortcut_graph_file graphs(GRAPH_FILE_PATH), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
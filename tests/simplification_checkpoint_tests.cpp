@@ -0,0 +1,122 @@
+#include "../simplification_checkpoint.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+BOOST_AUTO_TEST_SUITE(simplification_checkpoint_tests)
+
+namespace
+{
+const char* CHECKPOINT_FILE_PATH = "simplification_checkpoint_tests.bin";
+}
+
+BOOST_AUTO_TEST_CASE(resume_test)
+{
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, false);
+        checkpoint.append(1, 11, {shortcut {0, 1}, shortcut {1, 2}}, false);
+        checkpoint.append(2, 22, {shortcut {0, 2}}, true);
+    }
+
+    std::vector<shortcut> shortcuts;
+    bool fell_back = false;
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, true);
+        BOOST_CHECK_EQUAL(checkpoint.size(), 2);
+        BOOST_REQUIRE(checkpoint.find(1, 11, shortcuts, fell_back));
+        BOOST_CHECK_EQUAL(shortcuts.size(), 2);
+        BOOST_CHECK(!fell_back);
+        BOOST_REQUIRE(checkpoint.find(2, 22, shortcuts, fell_back));
+        BOOST_CHECK_EQUAL(shortcuts[0].last, 2);
+        BOOST_CHECK(fell_back);
+
+        // the key of the input changed
+        BOOST_CHECK(!checkpoint.find(1, 12, shortcuts, fell_back));
+        BOOST_CHECK(!checkpoint.find(3, 11, shortcuts, fell_back));
+    }
+
+    // a record without its commit marker is dropped
+    {
+        std::ifstream input(CHECKPOINT_FILE_PATH, std::ios::binary);
+        std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+        std::ofstream output(CHECKPOINT_FILE_PATH, std::ios::binary | std::ios::trunc);
+        output.write(contents.data(), contents.size() - 3);
+    }
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, true);
+        BOOST_CHECK_EQUAL(checkpoint.size(), 1);
+        BOOST_CHECK(checkpoint.find(1, 11, shortcuts, fell_back));
+        checkpoint.append(3, 33, {shortcut {0, 1}}, false);
+    }
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, true);
+        BOOST_CHECK_EQUAL(checkpoint.size(), 2);
+        BOOST_CHECK(checkpoint.find(3, 33, shortcuts, fell_back));
+    }
+
+    // without resume the file starts over
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, false);
+        BOOST_CHECK_EQUAL(checkpoint.size(), 0);
+    }
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, true);
+        BOOST_CHECK_EQUAL(checkpoint.size(), 0);
+    }
+    std::remove(CHECKPOINT_FILE_PATH);
+}
+
+BOOST_AUTO_TEST_CASE(map_simplification_test)
+{
+    std::remove(CHECKPOINT_FILE_PATH);
+    std::vector<poly_line> lines = {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        {1, {coordinate {10, 0}, coordinate {11, 1}, coordinate {12, 0}, coordinate {13, 1}, coordinate {14, 0}}},
+    };
+    std::vector<point> points = {
+        {point::NO_LINE_ID, 0, coordinate {2, 0.5}},
+    };
+
+    auto run = [&](simplification_checkpoint* checkpoint)
+    {
+        auto lines_copy = lines;
+        auto points_copy = points;
+        map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines_copy), std::move(points_copy));
+        simplification.set_num_threads(2);
+        if (checkpoint != nullptr)
+        {
+            simplification.use_checkpoint(*checkpoint);
+        }
+        simplification(100);
+        return simplification.original_indices();
+    };
+
+    auto full = run(nullptr);
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, false);
+        BOOST_CHECK(run(&checkpoint) == full);
+    }
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, true);
+        BOOST_CHECK_EQUAL(checkpoint.size(), 2);
+        BOOST_CHECK(run(&checkpoint) == full);
+    }
+
+    // a moved point changes the key of the first line only
+    points[0].location = coordinate {2, 0.4};
+    full = run(nullptr);
+    {
+        simplification_checkpoint checkpoint(CHECKPOINT_FILE_PATH, true);
+        BOOST_CHECK(run(&checkpoint) == full);
+    }
+    std::remove(CHECKPOINT_FILE_PATH);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
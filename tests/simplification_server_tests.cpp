@@ -0,0 +1,113 @@
+#include "../simplification_server.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(simplification_server_tests)
+
+namespace
+{
+using simplification_type = map_simplification<deberg<bb_point_filter>, bb_point_filter>;
+
+std::vector<poly_line> test_lines()
+{
+    // the first two lines constrain each other, the third is far away
+    return {
+        {3, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {3, 1}, coordinate {4, 0}}},
+        {5, {coordinate {0, 1}, coordinate {2, 2}, coordinate {4, 1}}},
+        {7, {coordinate {10, 0}, coordinate {11, 1}, coordinate {12, 0}, coordinate {13, 1}, coordinate {14, 0}}},
+    };
+}
+
+std::vector<point> test_points()
+{
+    return {
+        {point::NO_LINE_ID, 0, coordinate {2, 0.5}},
+        {point::NO_LINE_ID, 1, coordinate {12, 0.5}},
+        {point::NO_LINE_ID, 2, coordinate {50, 50}},
+    };
+}
+}
+
+BOOST_AUTO_TEST_CASE(input_test)
+{
+    simplification_server server(test_lines(), test_points());
+    BOOST_CHECK_EQUAL(server.size(), 3);
+
+    auto input = server.input({5});
+    BOOST_REQUIRE_EQUAL(input.lines.size(), 1);
+    BOOST_CHECK_EQUAL(input.lines[0].id, 5);
+    // the vertices of the first line inside of the bounding box
+    BOOST_REQUIRE_EQUAL(input.points.size(), 2);
+    BOOST_CHECK_EQUAL(input.points[0].line_id, 3);
+    BOOST_CHECK(input.points[0].location == (coordinate {1, 1}));
+    BOOST_CHECK(input.points[1].location == (coordinate {3, 1}));
+
+    // repeated ids are simplified once, the lines keep the order of the map
+    auto all = server.input({7, 3, 7, 5});
+    BOOST_REQUIRE_EQUAL(all.lines.size(), 3);
+    BOOST_CHECK_EQUAL(all.lines[0].id, 3);
+    BOOST_CHECK_EQUAL(all.lines[2].id, 7);
+    BOOST_CHECK_EQUAL(all.points.size(), 2);
+
+    BOOST_CHECK_EQUAL(server.input({}).lines.size(), 3);
+    BOOST_CHECK_THROW(server.input({4}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(same_as_whole_map_test)
+{
+    simplification_type whole_map(test_lines(), test_points());
+    auto expected = whole_map(0);
+
+    simplification_server server(test_lines(), test_points());
+    for (auto i = 0u; i < expected.size(); ++i)
+    {
+        auto input = server.input({expected[i].id});
+        simplification_type simplification(std::move(input.lines), std::move(input.points));
+        auto simplified = simplification(0);
+        BOOST_REQUIRE_EQUAL(simplified.size(), 1);
+        BOOST_CHECK(simplified[0].coordinates == expected[i].coordinates);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(serve_test)
+{
+    simplification_server server(test_lines(), test_points());
+    std::istringstream requests("first 1 2 3\n\n  second\nthird fail\n");
+    std::ostringstream responses;
+    server.serve(requests, responses, 2, [](const std::string& arguments)
+        {
+            if (arguments == "fail")
+            {
+                throw std::runtime_error("failed");
+            }
+            return "<" + arguments + ">";
+        });
+
+    // the responses are written as the requests finish
+    std::map<std::string, std::pair<std::string, std::string>> frames;
+    std::istringstream response_stream(responses.str());
+    std::string id, status;
+    std::size_t size;
+    double latency;
+    while (response_stream >> id >> status >> size >> latency)
+    {
+        BOOST_CHECK(latency >= 0);
+        response_stream.ignore(1);
+        std::string result(size, '\0');
+        response_stream.read(&result[0], size);
+        frames[id] = std::make_pair(status, result);
+    }
+
+    BOOST_REQUIRE_EQUAL(frames.size(), 3);
+    BOOST_CHECK(frames["first"] == std::make_pair(std::string("ok"), std::string("<1 2 3>")));
+    BOOST_CHECK(frames["second"] == std::make_pair(std::string("ok"), std::string("<>")));
+    BOOST_CHECK(frames["third"] == std::make_pair(std::string("error"), std::string("failed")));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
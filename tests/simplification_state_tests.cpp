@@ -0,0 +1,84 @@
+#include "../simplification_state.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(simplification_state_tests)
+
+BOOST_AUTO_TEST_CASE(round_trip_test)
+{
+    simplification_state state;
+    state.lines = {{3, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}}}};
+    state.points = {{point::NO_LINE_ID, 7, coordinate {1, 0.5}}};
+    state.pinned_coordinates = {coordinate {2, 0}};
+    state.line_states = {{{3, {coordinate {0, 0}, coordinate {2, 0}}}, {0, 2}, {shortcut {0, 2}}}};
+    state.engine = "engine";
+    state.options.window = simplification_window(3, 2.5);
+    state.options.max_deviation = 1.5;
+    state.options.use_funnel_sweep = true;
+    state.options.work_budget = 100;
+    state.quantization = quantization_parameters {coordinate {1, 2}, 0.5};
+    state.removes_collinear = false;
+
+    std::stringstream buffer;
+    state.write(buffer);
+    auto read = simplification_state::read(buffer);
+
+    BOOST_REQUIRE_EQUAL(read.lines.size(), 1);
+    BOOST_CHECK_EQUAL(read.lines[0].id, 3);
+    BOOST_CHECK(read.lines[0].coordinates == state.lines[0].coordinates);
+    BOOST_REQUIRE_EQUAL(read.points.size(), 1);
+    BOOST_CHECK_EQUAL(read.points[0].id, 7);
+    BOOST_CHECK_EQUAL(read.points[0].line_id, point::NO_LINE_ID);
+    BOOST_CHECK(read.points[0].location == state.points[0].location);
+    BOOST_CHECK(read.pinned_coordinates == state.pinned_coordinates);
+    BOOST_REQUIRE_EQUAL(read.line_states.size(), 1);
+    BOOST_CHECK(read.line_states[0].reduced_line.coordinates == state.line_states[0].reduced_line.coordinates);
+    BOOST_CHECK(read.line_states[0].reduced_indices == state.line_states[0].reduced_indices);
+    BOOST_REQUIRE_EQUAL(read.line_states[0].shortcuts.size(), 1);
+    BOOST_CHECK_EQUAL(read.line_states[0].shortcuts[0].first, 0);
+    BOOST_CHECK_EQUAL(read.line_states[0].shortcuts[0].last, 2);
+    BOOST_CHECK(read.is_compatible("engine", state.options, state.quantization, false));
+    BOOST_CHECK_EQUAL(read.options.window.max_vertices, 3);
+    BOOST_CHECK_EQUAL(read.options.work_budget, 100);
+}
+
+BOOST_AUTO_TEST_CASE(compatible_test)
+{
+    simplification_state state;
+    state.engine = "engine";
+    state.options.window = simplification_window(3, 0);
+
+    auto options = state.options;
+    BOOST_CHECK(state.is_compatible("engine", options, quantization_parameters(), true));
+    BOOST_CHECK(!state.is_compatible("other", options, quantization_parameters(), true));
+    BOOST_CHECK(!state.is_compatible("engine", simplification_options(), quantization_parameters(), true));
+    BOOST_CHECK(!state.is_compatible("engine", options, quantization_parameters {coordinate {0, 0}, 1}, true));
+    BOOST_CHECK(!state.is_compatible("engine", options, quantization_parameters(), false));
+    options.num_threads = 8;
+    BOOST_CHECK(state.is_compatible("engine", options, quantization_parameters(), true));
+}
+
+BOOST_AUTO_TEST_CASE(invalid_input_test)
+{
+    std::stringstream garbage("not a state");
+    BOOST_CHECK_THROW(simplification_state::read(garbage), std::runtime_error);
+
+    simplification_state state;
+    state.lines = {{0, {coordinate {0, 0}, coordinate {1, 1}}}};
+    std::stringstream buffer;
+    state.write(buffer);
+    auto truncated = buffer.str();
+    truncated.resize(truncated.size() - 4);
+    std::stringstream truncated_buffer(truncated);
+    BOOST_CHECK_THROW(simplification_state::read(truncated_buffer), std::runtime_error);
+
+    // 64bit integers have the same size as doubles
+    basic_simplification_state<quantized_coordinate> quantized_state;
+    std::stringstream quantized_buffer;
+    quantized_state.write(quantized_buffer);
+    BOOST_CHECK_THROW(simplification_state::read(quantized_buffer), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+#include "../vertex_index_file.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+BOOST_AUTO_TEST_SUITE(vertex_index_file_tests)
+
+BOOST_AUTO_TEST_CASE(round_trip_test)
+{
+    std::vector<kept_vertices> lines = {
+        {3, {0, 2, 3}},
+        {1000000, {0, 200, 100000}},
+        {7, {}},
+    };
+
+    std::stringstream buffer;
+    vertex_index_writer writer(buffer);
+    writer.write(lines);
+
+    // 7 bits per byte: the id 1000000 and the delta 99800 take 3 bytes, 200 takes 2
+    BOOST_CHECK_EQUAL(buffer.str().size(), vertex_index_writer::MAGIC_SIZE + 5 + (3 + 1 + 1 + 2 + 3) + 2);
+
+    vertex_index_reader reader(buffer);
+    auto read = reader.read();
+    BOOST_REQUIRE_EQUAL(read.size(), lines.size());
+    for (auto i = 0u; i < lines.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(read[i].id, lines[i].id);
+        BOOST_CHECK(read[i].indices == lines[i].indices);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(expand_test)
+{
+    std::vector<poly_line> lines = {
+        {4, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}}},
+        {2, {coordinate {0, 5}, coordinate {1, 6}, coordinate {2, 5}, coordinate {3, 6}}},
+    };
+    std::vector<kept_vertices> kept = {{2, {0, 1, 3}}, {4, {0, 2}}};
+
+    auto simplified = vertex_index_reader::expand(lines, kept);
+    BOOST_REQUIRE_EQUAL(simplified.size(), 2);
+    BOOST_CHECK_EQUAL(simplified[0].id, 2);
+    BOOST_CHECK((simplified[0].coordinates == std::vector<coordinate> {coordinate {0, 5}, coordinate {1, 6}, coordinate {3, 6}}));
+    BOOST_CHECK_EQUAL(simplified[1].id, 4);
+    BOOST_CHECK((simplified[1].coordinates == std::vector<coordinate> {coordinate {0, 0}, coordinate {2, 0}}));
+
+    BOOST_CHECK_THROW(vertex_index_reader::expand(lines, {{4, {0, 3}}}), std::runtime_error);
+    BOOST_CHECK_THROW(vertex_index_reader::expand(lines, {{5, {0}}}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(duplicate_id_test)
+{
+    std::vector<poly_line> lines = {
+        {4, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}}},
+        {4, {coordinate {0, 5}, coordinate {1, 6}, coordinate {2, 5}, coordinate {3, 6}}},
+    };
+
+    // in input order every entry belongs to the line at its position
+    std::vector<kept_vertices> kept = {{4, {0, 2}}, {4, {0, 1, 3}}};
+    auto simplified = vertex_index_reader::expand(lines, kept);
+    BOOST_REQUIRE_EQUAL(simplified.size(), 2);
+    BOOST_CHECK((simplified[0].coordinates == std::vector<coordinate> {coordinate {0, 0}, coordinate {2, 0}}));
+    BOOST_CHECK((simplified[1].coordinates == std::vector<coordinate> {coordinate {0, 5}, coordinate {1, 6}, coordinate {3, 6}}));
+
+    // otherwise the id does not tell which line is meant
+    BOOST_CHECK_THROW(vertex_index_reader::expand(lines, {{4, {0, 1, 3}}}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_input_test)
+{
+    std::stringstream garbage("not an index file");
+    BOOST_CHECK_THROW(vertex_index_reader(garbage).read(), std::runtime_error);
+
+    std::stringstream buffer;
+    vertex_index_writer writer(buffer);
+    writer.write_line(1, {0, 300});
+    auto truncated = buffer.str();
+    truncated.resize(truncated.size() - 1);
+    std::stringstream truncated_buffer(truncated);
+    BOOST_CHECK_THROW(vertex_index_reader(truncated_buffer).read(), std::runtime_error);
+
+    // a corrupt count throws instead of allocating its size
+    std::stringstream corrupt;
+    corrupt.write(vertex_index_writer::magic(), vertex_index_writer::MAGIC_SIZE);
+    corrupt << '\x01' << "\xff\xff\xff\xff\xff\xff\xff\x7f" << '\x00';
+    BOOST_CHECK_THROW(vertex_index_reader(corrupt).read(), std::runtime_error);
+
+    std::stringstream unordered;
+    vertex_index_writer unordered_writer(unordered);
+    BOOST_CHECK_THROW(unordered_writer.write_line(1, {2, 1}), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,153 @@
+#include "../vertex_reduction.hpp"
+#include "../map_simplification.hpp"
+#include "../deberg.hpp"
+#include "../bb_point_filter.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(vertex_reduction_tests)
+
+BOOST_AUTO_TEST_CASE(duplicates_test)
+{
+    poly_line line {0, {
+        coordinate {0, 0},
+        coordinate {0, 0},
+        coordinate {1, 1},
+        coordinate {2, 0},
+        coordinate {2, 0},
+        coordinate {2, 0},
+        coordinate {3, 1},
+        coordinate {3, 1},
+    }};
+    std::vector<point> points;
+
+    vertex_reduction reduction(line, points);
+    auto reduced = reduction();
+
+    std::vector<coordinate> expected_coordinates {{0, 0}, {1, 1}, {2, 0}, {3, 1}};
+    std::vector<unsigned> expected_indices {0, 2, 3, 7};
+    BOOST_CHECK_EQUAL_COLLECTIONS(reduced.original_indices.begin(), reduced.original_indices.end(),
+                                  expected_indices.begin(), expected_indices.end());
+    BOOST_CHECK(reduced.line.coordinates == expected_coordinates);
+}
+
+BOOST_AUTO_TEST_CASE(degenerated_line_test)
+{
+    poly_line line {0, {coordinate {1, 1}, coordinate {1, 1}, coordinate {1, 1}}};
+    std::vector<point> points;
+
+    vertex_reduction reduction(line, points);
+    auto reduced = reduction();
+
+    std::vector<unsigned> expected_indices {0, 2};
+    BOOST_CHECK_EQUAL_COLLECTIONS(reduced.original_indices.begin(), reduced.original_indices.end(),
+                                  expected_indices.begin(), expected_indices.end());
+}
+
+BOOST_AUTO_TEST_CASE(collinear_test)
+{
+    //             4
+    //            /
+    // 0--1--2--3
+    poly_line line {0, {
+        coordinate {0, 0},
+        coordinate {1, 0},
+        coordinate {2, 0},
+        coordinate {3, 0},
+        coordinate {4, 1},
+    }};
+
+    {
+        std::vector<point> points {{point::NO_LINE_ID, 0, coordinate {5, 0.5}}};
+        vertex_reduction reduction(line, points);
+        auto reduced = reduction();
+
+        std::vector<unsigned> expected_indices {0, 3, 4};
+        BOOST_CHECK_EQUAL_COLLECTIONS(reduced.original_indices.begin(), reduced.original_indices.end(),
+                                      expected_indices.begin(), expected_indices.end());
+    }
+
+    // a constraint point in the bounding box of the subpath keeps all vertices
+    {
+        std::vector<point> points {{point::NO_LINE_ID, 0, coordinate {3.5, 0.1}}};
+        vertex_reduction reduction(line, points);
+        auto reduced = reduction();
+
+        BOOST_CHECK_EQUAL(reduced.line.coordinates.size(), line.coordinates.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(collinear_reversal_test)
+{
+    // 1 is not between 0 and 2, so it is a turning point of the line
+    poly_line line {0, {
+        coordinate {0, 0},
+        coordinate {2, 0},
+        coordinate {1, 0},
+        coordinate {1, 1},
+    }};
+    std::vector<point> points;
+
+    vertex_reduction reduction(line, points);
+    auto reduced = reduction();
+
+    BOOST_CHECK_EQUAL(reduced.line.coordinates.size(), line.coordinates.size());
+}
+
+BOOST_AUTO_TEST_CASE(map_simplification_test)
+{
+    std::vector<poly_line> lines {
+        {0, {coordinate {0, 0}, coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 0}, coordinate {2, 0}}},
+        {1, {coordinate {0, 0}, coordinate {1, -1}, coordinate {2, 0}}},
+    };
+    std::vector<point> points {{point::NO_LINE_ID, 0, coordinate {1, 0.5}}};
+
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines), std::move(points));
+    auto simplified = simplification(4);
+
+    BOOST_CHECK_EQUAL(simplification.removed_vertices(), 2);
+    BOOST_REQUIRE_EQUAL(simplified.size(), 2);
+    BOOST_CHECK_EQUAL(simplified[0].coordinates.size(), 3);
+
+    const auto& indices = simplification.original_indices();
+    BOOST_REQUIRE_EQUAL(indices.size(), 2);
+    std::vector<unsigned> expected_indices {0, 2, 4};
+    BOOST_CHECK_EQUAL_COLLECTIONS(indices[0].begin(), indices[0].end(), expected_indices.begin(), expected_indices.end());
+}
+
+BOOST_AUTO_TEST_CASE(deviation_bound_test)
+{
+    //
+    //     1--2--3
+    //    /       \
+    //   0         4
+    //
+    // Within a deviation of 0.5 the only shortcuts are 0 -> 2 and 2 -> 4,
+    // so the collinear vertex 2 must not be removed.
+    std::vector<poly_line> lines {
+        {0, {coordinate {0, 0}, coordinate {1, 1}, coordinate {2, 1}, coordinate {3, 1}, coordinate {4, 0}}},
+    };
+    simplification_options options;
+    options.max_deviation = 0.5;
+
+    auto points = std::vector<point>();
+    deberg<bb_point_filter> engine(lines[0], std::move(points), options);
+    auto shortcuts = engine();
+    BOOST_CHECK(std::find_if(shortcuts.begin(), shortcuts.end(),
+                             [](const shortcut& s) { return s.first == 0 && s.last == 2; }) != shortcuts.end());
+
+    map_simplification<deberg<bb_point_filter>, bb_point_filter> simplification(std::move(lines), {});
+    simplification.set_options(options);
+    auto simplified = simplification(0);
+
+    BOOST_CHECK_EQUAL(simplification.removed_vertices(), 0);
+    BOOST_CHECK_EQUAL(simplification.used_edges(), 2);
+    BOOST_REQUIRE_EQUAL(simplification.original_indices().size(), 1);
+    std::vector<unsigned> expected_indices {0, 2, 4};
+    BOOST_CHECK(simplification.original_indices()[0] == expected_indices);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -1,4 +1,5 @@
 #include "../line_writer.hpp"
+#include "../geojson_writer.hpp"
 
 #include <boost/test/unit_test.hpp>
 #include <boost/test/test_case_template.hpp>
@@ -23,4 +24,52 @@ BOOST_AUTO_TEST_CASE(line_writer_tests)
 
 }
 
+BOOST_AUTO_TEST_CASE(quantized_line_writer_tests)
+{
+    compact_quantizer grid(coordinate {-1, 2}, 0.5);
+    std::vector<basic_poly_line<compact_quantized_coordinate>> lines {
+        {0, {compact_quantized_coordinate {0, 0}, compact_quantized_coordinate {3, 1}}},
+    };
+    std::stringstream output;
+    line_writer writer(output);
+
+    writer.write(lines, grid);
+
+    std::string correct_output = "0:<gml:LineString srsName=\"EPSG:54004\" xmlns:gml=\"http://www.opengis.net/gml\"><gml:coordinates decimal=\".\" cs=\",\" ts=\" \">-1,2 0.5,2.5 </gml:coordinates></gml:LineString>\n";
+
+    BOOST_CHECK_EQUAL(correct_output, output.str());
+}
+
+BOOST_AUTO_TEST_CASE(geojson_writer_tests)
+{
+    std::vector<poly_line> lines {
+        {0, {coordinate {0, 0}, coordinate {1.5, 1}}},
+        {1, {coordinate {0, 0}, coordinate {1, 1}}},
+    };
+    std::stringstream output;
+    {
+        geojson_writer writer(output, false);
+        writer.write(lines);
+    }
+
+    std::string correct_output = "{\"type\":\"FeatureCollection\",\"features\":[\n"
+        "{\"type\":\"Feature\",\"properties\":{\"id\":0},\"geometry\":{\"type\":\"LineString\",\"coordinates\":[[0,0],[1.5,1]]}},\n"
+        "{\"type\":\"Feature\",\"properties\":{\"id\":1},\"geometry\":{\"type\":\"LineString\",\"coordinates\":[[0,0],[1,1]]}}\n"
+        "]}\n";
+
+    BOOST_CHECK_EQUAL(correct_output, output.str());
+}
+
+BOOST_AUTO_TEST_CASE(geojson_wgs84_tests)
+{
+    // the inverse of '+proj=merc +ellps=WGS84', as used by utils/lines_to_geojson.py
+    auto origin = geojson_writer::to_wgs84(coordinate {0, 0});
+    BOOST_CHECK_SMALL(origin.x, 1e-12);
+    BOOST_CHECK_SMALL(origin.y, 1e-12);
+
+    auto c = geojson_writer::to_wgs84(coordinate {-7984749.593824852, 5368675.690126911});
+    BOOST_CHECK_CLOSE(c.x, -71.728226, 1e-7);
+    BOOST_CHECK_CLOSE(c.y, 43.563454, 1e-7);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
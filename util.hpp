@@ -5,6 +5,10 @@
 
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace util {
 
@@ -89,6 +93,49 @@ void merge(ForwardIter1 begin_first,  ForwardIter1 end_first,
         op_second(*(iter_second++));
 }
 
+/// Calls op(i) for every i in [0, n) on up to num_threads threads.
+/// The first exception thrown by op is rethrown after all threads finished.
+template<typename UnaryOp>
+void parallel_for(unsigned num_threads, std::size_t n, UnaryOp op)
+{
+    if (num_threads <= 1 || n <= 1)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            op(i);
+        return;
+    }
+
+    std::atomic<std::size_t> next_index(0);
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+
+    auto worker = [&]()
+    {
+        for (auto i = next_index++; i < n; i = next_index++)
+        {
+            try
+            {
+                op(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exception_mutex);
+                if (!first_exception)
+                    first_exception = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (auto t = 0u; t < std::min<std::size_t>(num_threads, n); ++t)
+        threads.emplace_back(worker);
+    for (auto& t : threads)
+        t.join();
+
+    if (first_exception)
+        std::rethrow_exception(first_exception);
+}
+
 }
 
 #endif
@@ -0,0 +1,229 @@
+#ifndef VERTEX_INDEX_FILE_HPP
+#define VERTEX_INDEX_FILE_HPP
+
+#include "poly_line.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/// The vertices of an input line that a simplification keeps
+struct kept_vertices
+{
+    unsigned id;
+    /// Increasing indices into the input line
+    std::vector<unsigned> indices;
+};
+
+/// Writes the result of a simplification as the indices of the kept vertices of every line.
+///
+/// Every simplified line consists of vertices of its input line, so instead of its coordinates
+/// only their indices are written: The line id, the number of indices, the first index and the
+/// differences of consecutive indices, all as LEB128 varints. The lines follow each other without
+/// a count, so they can be written as they finish.
+class vertex_index_writer
+{
+public:
+    vertex_index_writer(std::ostream& output)
+        : output(output)
+    {
+        output.write(magic(), MAGIC_SIZE);
+    }
+
+    void write(const std::vector<kept_vertices>& lines)
+    {
+        for (const auto& l : lines)
+        {
+            write_line(l.id, l.indices);
+        }
+    }
+
+    void write_line(unsigned id, const std::vector<unsigned>& indices)
+    {
+        write_varint(id);
+        write_varint(indices.size());
+        unsigned previous = 0;
+        for (auto idx : indices)
+        {
+            if (idx < previous)
+            {
+                throw std::runtime_error("The kept vertices of line " + std::to_string(id) + " are not increasing.");
+            }
+            write_varint(idx - previous);
+            previous = idx;
+        }
+
+        if (!output)
+        {
+            throw std::runtime_error("Could not write the kept vertices.");
+        }
+    }
+
+    static constexpr std::size_t MAGIC_SIZE = 8;
+
+    static const char* magic()
+    {
+        return "DBINDEX1";
+    }
+
+private:
+    void write_varint(std::uint64_t value)
+    {
+        char bytes[10];
+        std::size_t size = 0;
+        do
+        {
+            bytes[size] = static_cast<char>(value & 0x7f);
+            value >>= 7;
+            if (value != 0)
+            {
+                bytes[size] |= static_cast<char>(0x80);
+            }
+            ++size;
+        } while (value != 0);
+        output.write(bytes, size);
+    }
+
+    std::ostream& output;
+};
+
+/// Reads the kept vertices written by vertex_index_writer and applies them to the input lines
+class vertex_index_reader
+{
+public:
+    vertex_index_reader(std::istream& input)
+        : input(input)
+    {
+    }
+
+    std::vector<kept_vertices> read()
+    {
+        char file_magic[vertex_index_writer::MAGIC_SIZE];
+        input.read(file_magic, sizeof(file_magic));
+        if (!input || std::memcmp(file_magic, vertex_index_writer::magic(), sizeof(file_magic)) != 0)
+        {
+            throw std::runtime_error("Not a vertex index file.");
+        }
+
+        std::vector<kept_vertices> lines;
+        while (input.peek() != std::char_traits<char>::eof())
+        {
+            kept_vertices l;
+            l.id = read_varint();
+            // every index takes at least one byte, so a corrupt count runs into the end of the input
+            // instead of allocating its size up front
+            auto count = read_varint();
+            l.indices.reserve(std::min<std::uint64_t>(count, MAX_RESERVED_INDICES));
+            unsigned previous = 0;
+            for (std::uint64_t k = 0; k < count; ++k)
+            {
+                previous += read_varint();
+                l.indices.push_back(previous);
+            }
+            lines.push_back(std::move(l));
+        }
+
+        return lines;
+    }
+
+    /// The simplified line given by the kept vertices of the input line
+    template<typename CoordinateT>
+    static basic_poly_line<CoordinateT> expand(const basic_poly_line<CoordinateT>& line, const kept_vertices& kept)
+    {
+        basic_poly_line<CoordinateT> simplified {line.id, {}};
+        simplified.coordinates.reserve(kept.indices.size());
+        for (auto idx : kept.indices)
+        {
+            if (idx >= line.coordinates.size())
+            {
+                throw std::runtime_error("Line " + std::to_string(line.id) + " has no vertex " + std::to_string(idx) + ".");
+            }
+            simplified.coordinates.push_back(line.coordinates[idx]);
+        }
+        return simplified;
+    }
+
+    /// The simplified lines in the order of kept.
+    /// If kept has one entry per input line in input order, which the writer produces unless the lines are
+    /// streamed in the order they finish, the k-th entry belongs to the k-th line, even if ids repeat.
+    /// Otherwise every input line is found by its id and an id of several input lines is an error.
+    template<typename CoordinateT>
+    static std::vector<basic_poly_line<CoordinateT>> expand(const std::vector<basic_poly_line<CoordinateT>>& lines,
+                                                            const std::vector<kept_vertices>& kept)
+    {
+        std::vector<basic_poly_line<CoordinateT>> simplified;
+        simplified.reserve(kept.size());
+
+        bool in_input_order = kept.size() == lines.size();
+        for (auto i = 0u; i < kept.size() && in_input_order; ++i)
+        {
+            in_input_order = kept[i].id == lines[i].id;
+        }
+        if (in_input_order)
+        {
+            for (auto i = 0u; i < kept.size(); ++i)
+            {
+                simplified.push_back(expand(lines[i], kept[i]));
+            }
+            return simplified;
+        }
+
+        const std::size_t AMBIGUOUS = static_cast<std::size_t>(-1);
+        std::unordered_map<unsigned, std::size_t> line_idx;
+        for (auto i = 0u; i < lines.size(); ++i)
+        {
+            auto inserted = line_idx.emplace(lines[i].id, i);
+            if (!inserted.second)
+            {
+                inserted.first->second = AMBIGUOUS;
+            }
+        }
+
+        for (const auto& k : kept)
+        {
+            auto iter = line_idx.find(k.id);
+            if (iter == line_idx.end())
+            {
+                throw std::runtime_error("There is no input line " + std::to_string(k.id) + ".");
+            }
+            if (iter->second == AMBIGUOUS)
+            {
+                throw std::runtime_error("Several input lines have the id " + std::to_string(k.id)
+                                         + " and the kept vertices are not in input order.");
+            }
+            simplified.push_back(expand(lines[iter->second], k));
+        }
+        return simplified;
+    }
+
+private:
+    static constexpr std::uint64_t MAX_RESERVED_INDICES = 1 << 16;
+
+    std::uint64_t read_varint()
+    {
+        std::uint64_t value = 0;
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            auto byte = input.get();
+            if (byte == std::char_traits<char>::eof())
+            {
+                throw std::runtime_error("The vertex index file is truncated.");
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        throw std::runtime_error("The vertex index file contains an invalid number.");
+    }
+
+    std::istream& input;
+};
+
+#endif
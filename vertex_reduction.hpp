@@ -0,0 +1,227 @@
+#ifndef VERTEX_REDUCTION_HPP
+#define VERTEX_REDUCTION_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+#include "geometry.hpp"
+#include "monotone_decomposition.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/// Removes vertices of a line that can not change its optimal simplification:
+///
+///  - exact duplicates of the previous vertex
+///  - vertices strictly inside a straight run of the line, if their monotone subpath has
+///    no constraint point in its bounding box and they are not inside the bounding box of
+///    any other subpath.
+///
+/// Without constraint points every shortcut of a monotone subpath is valid, so the subpath
+/// is always replaced by a single edge. Removing a collinear vertex does not change the
+/// monotone decomposition, since both of its edges have the same direction.
+/// In general removing collinear vertices is not lossless: A shortcut that starts at such
+/// a vertex can avoid a constraint point that every shortcut starting at its neighbours hits.
+///
+/// This needs every valid shortcut to be usable. With a bound on the deviation the subpath
+/// is not always replaced by a single edge and a shortcut that starts or ends at a collinear
+/// vertex can be the only one within the bound, so callers must pass remove_collinear = false
+/// and only duplicates are removed.
+///
+/// The constraint points are the filtered points of the line and must not contain vertices
+/// of the line itself. Vertices flagged as pinned are never removed as collinear.
+template<typename CoordinateT>
+class basic_vertex_reduction
+{
+public:
+    using line_type = basic_poly_line<CoordinateT>;
+    using point_type = basic_point<CoordinateT>;
+
+    struct reduced_line
+    {
+        line_type line;
+        /// index of every vertex of the reduced line in the original line
+        std::vector<unsigned> original_indices;
+    };
+
+    basic_vertex_reduction(const line_type& in_line, const std::vector<point_type>& in_constraint_points,
+                           std::vector<bool> in_pinned = {}, bool in_remove_collinear = true)
+    : line(in_line)
+    , constraint_points(in_constraint_points)
+    , pinned(std::move(in_pinned))
+    , collinear(in_remove_collinear)
+    {
+    }
+
+    reduced_line operator()() const
+    {
+        auto reduced = remove_duplicates();
+        if (collinear && reduced.line.coordinates.size() > 2)
+        {
+            remove_collinear(reduced);
+        }
+
+        return reduced;
+    }
+
+private:
+    struct bounding_box
+    {
+        CoordinateT min;
+        CoordinateT max;
+
+        bool contains(const CoordinateT& c) const
+        {
+            return c.x >= min.x && c.y >= min.y && c.x <= max.x && c.y <= max.y;
+        }
+    };
+
+    /// Always keeps the first and the last vertex
+    reduced_line remove_duplicates() const
+    {
+        reduced_line reduced {line_type {line.id, {}}, {}};
+        reduced.line.coordinates.reserve(line.coordinates.size());
+        reduced.original_indices.reserve(line.coordinates.size());
+
+        for (auto i = 0u; i < line.coordinates.size(); ++i)
+        {
+            if (!reduced.original_indices.empty() && line.coordinates[i] == reduced.line.coordinates.back())
+            {
+                if (i + 1 < line.coordinates.size())
+                {
+                    continue;
+                }
+
+                // drop the previous copy of the last vertex instead
+                if (reduced.original_indices.size() > 1)
+                {
+                    reduced.line.coordinates.pop_back();
+                    reduced.original_indices.pop_back();
+                }
+            }
+
+            reduced.line.coordinates.push_back(line.coordinates[i]);
+            reduced.original_indices.push_back(i);
+        }
+
+        return reduced;
+    }
+
+    /// True if vertex idx lies strictly between its neighbours on a straight line
+    static bool is_straight(const std::vector<CoordinateT>& coordinates, unsigned idx)
+    {
+        const auto& previous = coordinates[idx - 1];
+        const auto& current = coordinates[idx];
+        const auto& next = coordinates[idx + 1];
+
+        return geometry::orientation(previous, current, next) == 0 &&
+               geometry::dot(current, previous, next) < 0;
+    }
+
+    void remove_collinear(reduced_line& reduced) const
+    {
+        const auto& coordinates = reduced.line.coordinates;
+
+        basic_monotone_decomposition<CoordinateT> decomposition;
+        auto subpaths = decomposition(reduced.line);
+
+        std::vector<bounding_box> boxes;
+        boxes.reserve(subpaths.size());
+        for (const auto& s : subpaths)
+        {
+            bounding_box box {coordinates[s.begin_idx], coordinates[s.begin_idx]};
+            for (auto idx = s.begin_idx; idx < s.end_idx; ++idx)
+            {
+                box.min.x = std::min(box.min.x, coordinates[idx].x);
+                box.min.y = std::min(box.min.y, coordinates[idx].y);
+                box.max.x = std::max(box.max.x, coordinates[idx].x);
+                box.max.y = std::max(box.max.y, coordinates[idx].y);
+            }
+            boxes.push_back(box);
+        }
+
+        std::vector<bool> removed(coordinates.size(), false);
+        bool any_removed = false;
+
+        for (auto s = 0u; s < subpaths.size(); ++s)
+        {
+            // the first and last vertex of a subpath are never removed
+            std::vector<unsigned> candidates;
+            for (auto idx = subpaths[s].begin_idx + 1; idx + 1 < subpaths[s].end_idx; ++idx)
+            {
+                bool is_pinned = !pinned.empty() && pinned[reduced.original_indices[idx]];
+                if (!is_pinned && is_straight(coordinates, idx))
+                {
+                    candidates.push_back(idx);
+                }
+            }
+
+            if (candidates.empty() || !is_unconstrained(coordinates, subpaths[s].begin_idx, subpaths[s].end_idx, boxes[s]))
+            {
+                continue;
+            }
+
+            for (auto idx : candidates)
+            {
+                bool constrains_other_subpath = false;
+                for (auto other = 0u; other < boxes.size() && !constrains_other_subpath; ++other)
+                {
+                    constrains_other_subpath = other != s && boxes[other].contains(coordinates[idx]);
+                }
+
+                if (!constrains_other_subpath)
+                {
+                    removed[idx] = true;
+                    any_removed = true;
+                }
+            }
+        }
+
+        if (!any_removed)
+        {
+            return;
+        }
+
+        reduced_line compacted {line_type {reduced.line.id, {}}, {}};
+        for (auto idx = 0u; idx < coordinates.size(); ++idx)
+        {
+            if (!removed[idx])
+            {
+                compacted.line.coordinates.push_back(coordinates[idx]);
+                compacted.original_indices.push_back(reduced.original_indices[idx]);
+            }
+        }
+        reduced = std::move(compacted);
+    }
+
+    /// True if neither a constraint point nor a vertex of another subpath
+    /// lies in the bounding box of the subpath [begin_idx, end_idx).
+    bool is_unconstrained(const std::vector<CoordinateT>& coordinates, unsigned begin_idx, unsigned end_idx, const bounding_box& box) const
+    {
+        for (const auto& p : constraint_points)
+        {
+            if (box.contains(p.location))
+            {
+                return false;
+            }
+        }
+
+        for (auto idx = 0u; idx < coordinates.size(); ++idx)
+        {
+            if ((idx < begin_idx || idx >= end_idx) && box.contains(coordinates[idx]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    const line_type& line;
+    const std::vector<point_type>& constraint_points;
+    std::vector<bool> pinned;
+    bool collinear;
+};
+
+using vertex_reduction = basic_vertex_reduction<coordinate>;
+
+#endif
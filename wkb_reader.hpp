@@ -0,0 +1,157 @@
+#ifndef WKB_READER_HPP
+#define WKB_READER_HPP
+
+#include "poly_line.hpp"
+#include "point.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Reads lines and points stored as well-known binary.
+///
+/// The file is a sequence of records, each one a 32bit id and the 32bit size of its geometry
+/// followed by the geometry as WKB, all little endian except for the WKB itself, which states
+/// its byte order. Lines are LineStrings and points are Points. The SRID of extended WKB
+/// (as written by PostGIS) is skipped, geometries with Z or M values are rejected.
+class wkb_reader
+{
+public:
+    wkb_reader(std::istream& input)
+        : input(input)
+    {
+    }
+
+    std::vector<poly_line> read_lines()
+    {
+        std::vector<poly_line> lines;
+        std::vector<char> geometry;
+        unsigned id;
+        while (read_record(id, geometry))
+        {
+            const char* data = geometry.data();
+            const char* end = data + geometry.size();
+            bool big_endian = read_header(data, end, LINE_STRING);
+
+            poly_line l {id, {}};
+            l.coordinates.resize(read_value<std::uint32_t>(data, end, big_endian));
+            if (static_cast<std::size_t>(end - data) < l.coordinates.size() * 2 * sizeof(double))
+            {
+                throw std::runtime_error("The geometry of line " + std::to_string(id) + " is truncated.");
+            }
+            for (auto& c : l.coordinates)
+            {
+                c.x = read_value<double>(data, end, big_endian);
+                c.y = read_value<double>(data, end, big_endian);
+            }
+            lines.push_back(std::move(l));
+        }
+
+        return lines;
+    }
+
+    std::vector<point> read_points()
+    {
+        std::vector<point> points;
+        std::vector<char> geometry;
+        unsigned id;
+        while (read_record(id, geometry))
+        {
+            const char* data = geometry.data();
+            const char* end = data + geometry.size();
+            bool big_endian = read_header(data, end, POINT);
+
+            point p;
+            p.line_id = point::NO_LINE_ID;
+            p.id = id;
+            p.location.x = read_value<double>(data, end, big_endian);
+            p.location.y = read_value<double>(data, end, big_endian);
+            points.push_back(p);
+        }
+
+        return points;
+    }
+
+private:
+    static constexpr std::uint32_t POINT = 1;
+    static constexpr std::uint32_t LINE_STRING = 2;
+    static constexpr std::uint32_t EWKB_Z = 0x80000000;
+    static constexpr std::uint32_t EWKB_M = 0x40000000;
+    static constexpr std::uint32_t EWKB_SRID = 0x20000000;
+
+    /// Returns false at the end of the input
+    bool read_record(unsigned& id, std::vector<char>& geometry)
+    {
+        char header[2 * sizeof(std::uint32_t)];
+        input.read(header, sizeof(header));
+        if (input.gcount() == 0 && input.eof())
+        {
+            return false;
+        }
+        if (!input)
+        {
+            throw std::runtime_error("The WKB input is truncated.");
+        }
+
+        const char* data = header;
+        id = read_value<std::uint32_t>(data, header + sizeof(header), false);
+        geometry.resize(read_value<std::uint32_t>(data, header + sizeof(header), false));
+        input.read(geometry.data(), geometry.size());
+        if (!input)
+        {
+            throw std::runtime_error("The geometry of record " + std::to_string(id) + " is truncated.");
+        }
+        return true;
+    }
+
+    /// Checks the geometry type and returns whether the geometry is big endian
+    static bool read_header(const char*& data, const char* end, std::uint32_t expected_type)
+    {
+        if (data == end)
+        {
+            throw std::runtime_error("Empty WKB geometry.");
+        }
+        bool big_endian = *data++ == 0;
+        auto type = read_value<std::uint32_t>(data, end, big_endian);
+        if ((type & EWKB_SRID) != 0)
+        {
+            read_value<std::uint32_t>(data, end, big_endian);
+        }
+        // ISO WKB encodes Z and M as 1000 and 2000 added to the type
+        if ((type & (EWKB_Z | EWKB_M)) != 0 || (type & ~EWKB_SRID) != expected_type)
+        {
+            throw std::runtime_error("Expected a WKB " + std::string(expected_type == POINT ? "Point" : "LineString")
+                                     + " without Z or M values.");
+        }
+        return big_endian;
+    }
+
+    template<typename ValueT>
+    static ValueT read_value(const char*& data, const char* end, bool big_endian)
+    {
+        if (static_cast<std::size_t>(end - data) < sizeof(ValueT))
+        {
+            throw std::runtime_error("The WKB geometry is truncated.");
+        }
+
+        char bytes[sizeof(ValueT)];
+        std::memcpy(bytes, data, sizeof(ValueT));
+        if (big_endian)
+        {
+            std::reverse(bytes, bytes + sizeof(ValueT));
+        }
+        data += sizeof(ValueT);
+
+        ValueT value;
+        std::memcpy(&value, bytes, sizeof(ValueT));
+        return value;
+    }
+
+    std::istream& input;
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef WKB_WRITER_HPP
+#define WKB_WRITER_HPP
+
+#include "poly_line.hpp"
+#include "quantizer.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+/// Writes lines as little endian WKB LineStrings in the records read by wkb_reader
+class wkb_writer
+{
+public:
+    wkb_writer(std::ostream& output)
+        : output(output)
+    {
+    }
+
+    void write(const std::vector<poly_line>& lines)
+    {
+        for (const auto& l : lines)
+        {
+            write_line(l);
+        }
+    }
+
+    /// Writes lines with quantized coordinates in their original coordinate system
+    template<typename QuantizedCoordinateT>
+    void write(const std::vector<basic_poly_line<QuantizedCoordinateT>>& lines,
+               const basic_quantizer<QuantizedCoordinateT>& quantizer)
+    {
+        for (const auto& l : lines)
+        {
+            write_line(quantizer.dequantize(l));
+        }
+    }
+
+    void write_line(const poly_line& line)
+    {
+        std::uint32_t geometry_size = 1 + 2 * sizeof(std::uint32_t) + line.coordinates.size() * 2 * sizeof(double);
+        write_value<std::uint32_t>(line.id);
+        write_value(geometry_size);
+
+        const char little_endian = 1;
+        output.write(&little_endian, 1);
+        write_value<std::uint32_t>(LINE_STRING);
+        write_value<std::uint32_t>(line.coordinates.size());
+        for (const auto& c : line.coordinates)
+        {
+            write_value<double>(c.x);
+            write_value<double>(c.y);
+        }
+
+        if (!output)
+        {
+            throw std::runtime_error("Could not write line " + std::to_string(line.id) + ".");
+        }
+    }
+
+private:
+    static constexpr std::uint32_t LINE_STRING = 2;
+
+    /// The values are written in the byte order of the machine, which is assumed to be little endian
+    template<typename ValueT>
+    void write_value(ValueT value)
+    {
+        output.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    std::ostream& output;
+};
+
+#endif